@@ -0,0 +1,70 @@
+#ifndef AUDIO_COMMAND_QUEUE_H
+#define AUDIO_COMMAND_QUEUE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include "config.h"
+
+enum AudioCommandType : uint8_t {
+    CMD_PLAY,
+    CMD_ENQUEUE,
+    CMD_PAUSE,
+    CMD_RESUME,
+    CMD_STOP,
+    CMD_SEEK,
+    CMD_SET_VOLUME
+};
+
+struct AudioCommand {
+    AudioCommandType type;
+    float volume;        // CMD_SET_VOLUME
+    uint32_t position;   // CMD_SEEK (milliseconds from the start of the track)
+    char path[AUDIO_MAX_PATH_LENGTH];  // CMD_PLAY, CMD_ENQUEUE
+};
+
+// Single-producer / single-consumer ring buffer.
+// push() and pop() never block and never allocate. Capacity must be a
+// power of two; one slot is not wasted because head/tail are free-running.
+template <typename T, size_t Capacity>
+class SPSCQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    SPSCQueue() : _head(0), _tail(0) {}
+    
+    // Producer side
+    bool push(const T& item) {
+        size_t head = _head.load(std::memory_order_relaxed);
+        size_t tail = _tail.load(std::memory_order_acquire);
+        if (head - tail == Capacity) {
+            return false;  // Full
+        }
+        _items[head & (Capacity - 1)] = item;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // Consumer side
+    bool pop(T& item) {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        size_t head = _head.load(std::memory_order_acquire);
+        if (head == tail) {
+            return false;  // Empty
+        }
+        item = _items[tail & (Capacity - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    
+    bool isEmpty() const {
+        return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+    }
+
+private:
+    T _items[Capacity];
+    std::atomic<size_t> _head;  // Written by producer only
+    std::atomic<size_t> _tail;  // Written by consumer only
+};
+
+#endif // AUDIO_COMMAND_QUEUE_H
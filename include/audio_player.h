@@ -2,12 +2,17 @@
 #define AUDIO_PLAYER_H
 
 #include <Arduino.h>
+#include "config.h"
+#include "audio_command_queue.h"
+#include "seek_indexer.h"
 // Forward declarations to avoid loading libraries globally
+class AudioFileSource;
 class AudioFileSourceSD;
-class AudioFileSourceBuffer;
 class AudioFileSourceID3;
 class AudioGeneratorMP3;
-class AudioOutputI2S;
+class I2SDmaOutput;
+class PrefetchBuffer;
+class TrackChainSource;
 
 enum PlayerState {
     STOPPED,
@@ -21,35 +26,143 @@ public:
     ~AudioPlayer();
     
     bool begin();
-    void loop();
+    void loop();  // Audio task only (Core 1)
+    
+    // Audio task only: sleep until there is something to do. Blocks on a
+    // task notification while stopped/paused, and on I2S DMA "buffer sent"
+    // events while playing.
+    void attachTask(TaskHandle_t task) { _task = task; }
+    void waitForWork();
     
     // Playback control
-    bool play(const String& filepath);
-    void pause();
-    void resume();
-    void stop();
+    // These only post a command to the audio task and return immediately;
+    // they are safe to call from any task. false means the queue was full.
+    bool play(const char* filepath);     // Replaces the current playlist
+    // Appends to the playlist (gapless). Also false while AUDIO_PLAYLIST_SIZE
+    // tracks are already waiting; try again once the next one has started.
+    bool enqueue(const char* filepath);
+    bool pause();
+    bool resume();
+    bool stop();
+    bool seek(uint32_t positionMs);
     
-    // State queries
+    // State queries (updated by the audio task once a command is applied)
     PlayerState getState() { return _state; }
     bool isPlaying() { return _state == PLAYING; }
     bool isPaused() { return _state == PAUSED; }
-    String getCurrentSong() { return _currentSong; }
+    // Path of the track being decoded, "" when stopped. Safe from any task:
+    // retries until it has a copy the audio task didn't change midway.
+    void getCurrentSong(char* out, size_t outLen);
+    
+    // Position in the current track (updated by the audio task every pass)
+    uint32_t getPositionBytes() { return _positionBytes; }      // Offset of the next byte to decode
+    uint32_t getPositionSamples() { return _positionSamples; }  // Sample frames sent to I2S
+    uint32_t getPositionMs();
+    uint32_t getDurationMs() { return _durationMs; }  // 0 until the seek index is ready
     
     // Volume control
-    void setVolume(float volume);  // 0.0 to 1.0
+    bool setVolume(float volume);  // 0.0 to 1.0
     float getVolume() { return _volume; }
     
+    // Share of the last second the audio task spent awake (0.0 to 1.0)
+    float getCpuLoad() { return _cpuLoad; }
+    
+    // Times the I2S DMA ring ran dry while playing, since boot
+    uint32_t getUnderruns();
+    
+    // Sample frames decoded and sent to I2S, since boot (free-running)
+    uint32_t getFramesDecoded();
+    
+    // Bumped by the audio task whenever state, song, volume, duration or the
+    // position (seek) changes, so Core 0 can push updates without polling
+    uint32_t getStatusVersion() { return _statusVersion; }
+    
 private:
+    // One track's source chain: SD file -> read-ahead buffer -> ID3 filter.
+    // buff and id3 are only non-null while a track is loaded in the slot.
+    struct TrackSlot {
+        AudioFileSourceSD* file;
+        PrefetchBuffer* buff;
+        AudioFileSourceID3* id3;
+        uint8_t* buffer;  // AUDIO_STREAM_BUFFER_SIZE bytes
+        char path[AUDIO_MAX_PATH_LENGTH];
+    };
+    
+    // Decoder pipeline - owned by the audio task, never touched from Core 0.
+    // All objects live in a fixed arena set up by begin(). The decoder reads
+    // from _chain, which moves from the current slot to the next one at end
+    // of file, so the next track is opened and buffered ahead of time.
     AudioGeneratorMP3* _mp3;
-    AudioFileSourceSD* _file;
-    AudioFileSourceBuffer* _buff;
-    AudioFileSourceID3* _id3;
-    AudioOutputI2S* _out;
+    TrackChainSource* _chain;
+    TrackSlot _slots[2];
+    uint8_t _current;         // Index of the slot being decoded
+    bool _nextPrimed;         // Next slot's buffer is full (or its file ended)
+    I2SDmaOutput* _out;
+    uint8_t* _streamBuffers;  // Both slot buffers (PSRAM if available)
+    uint8_t* _decoderState;   // libmad state for _mp3 (internal RAM)
+    uint32_t _baselineFreeHeap;
+    
+    // Tracks waiting to be loaded into the next slot
+    char _playlist[AUDIO_PLAYLIST_SIZE][AUDIO_MAX_PATH_LENGTH];
+    uint8_t _playlistHead;
+    uint8_t _playlistCount;
+    // Tracks enqueue() accepted that are not loaded yet (in flight or in
+    // _playlist). Reserved by the caller, released by the audio task.
+    std::atomic<uint8_t> _queuedTracks;
+    
+    volatile PlayerState _state;
+    // Written by the audio task only. Sequence lock: odd while a new path is
+    // being copied in, bumped again once it is complete.
+    char _currentSong[AUDIO_MAX_PATH_LENGTH];
+    std::atomic<uint32_t> _currentSongSeq;
+    volatile float _volume;
+    volatile uint32_t _positionBytes;
+    volatile uint32_t _positionSamples;
+    volatile uint32_t _sampleRate;
+    volatile uint32_t _durationMs;
+    uint32_t _trackStartFrame;  // Output frame counter when the track started
+    volatile uint32_t _statusVersion;
+    
+    // Seek table for the current track, requested once its buffer is warm
+    SeekIndexer _seekIndexer;
+    bool _seekIndexPending;
+    // A seek that came before the table was opened, applied once it is
+    bool _seekDeferred;
+    uint32_t _deferredSeekMs;
+    
+    SPSCQueue<AudioCommand, AUDIO_COMMAND_QUEUE_SIZE> _commands;
+    portMUX_TYPE _producerLock;
+    TaskHandle_t _task;
+    
+    // Audio task load accounting
+    uint32_t _windowStart;
+    uint32_t _sleepMicros;
+    volatile float _cpuLoad;
+    
+    bool post(const AudioCommand& cmd);
+    void processCommands();
     
-    PlayerState _state;
-    String _currentSong;
-    float _volume;
+    // Command handlers (audio task)
+    bool doPlay(const char* filepath);
+    void doEnqueue(const char* filepath);
+    void doPause();
+    void doResume();
+    void doStop();
+    void doSeek(uint32_t positionMs);
+    void doSetVolume(float volume);
     
+    bool allocateArena();
+    TrackSlot& currentSlot() { return _slots[_current]; }
+    TrackSlot& nextSlot() { return _slots[_current ^ 1]; }
+    bool loadSlot(TrackSlot& slot, const char* filepath);
+    void releaseSlot(TrackSlot& slot);
+    void prefetchNext();
+    void updateSeekIndex();
+    static AudioFileSource* onTrackEnd(void* context);
+    AudioFileSource* advanceTrack();
+    void logHeapUsage(const char* event);
+    void updatePosition();
+    void setCurrentSong(const char* filepath);
     void cleanup();
 };
 
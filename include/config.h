@@ -16,11 +16,12 @@
 #define I2S_LRC  25
 #define I2S_DOUT 22
 
-// NFC PN532 (Software SPI)
+// NFC PN532 (HSPI routed to these pins, or software SPI)
 #define NFC_SCK  14
 #define NFC_MISO 12
 #define NFC_MOSI 27
 #define NFC_SS   15
+#define NFC_IRQ  4    // PN532 IRQ (active low); -1 to poll instead
 
 // Optional Volume Pot (Future use)
 #define POT_PIN  34
@@ -37,27 +38,102 @@
 // STORAGE CONFIGURATION
 // ============================================================================
 #define MUSIC_DIR "/music"
-#define NFC_LINKS_FILE "/nfc_links.json"
+#define NFC_LINKS_FILE "/nfc_links.json"      // Legacy format, migrated on boot
+#define NFC_LINKS_SNAPSHOT "/nfc_links.snap"
+#define NFC_LINKS_JOURNAL "/nfc_links.log"
+#define NFC_JOURNAL_COMPACT_SIZE 16384        // Journal bytes before a new snapshot
 #define MAX_FILENAME_LENGTH 64
+#define AUDIO_MAX_PATH_LENGTH (sizeof(MUSIC_DIR) + MAX_FILENAME_LENGTH + 1)  // "/music/" + name + '\0'
+#define PLAYLIST_MAX_TRACKS 64    // Songs of a linked folder that play, first by name (max 255)
+#define SEEK_INDEX_SUFFIX ".idx"  // Seek table cached next to each MP3
+#define UPLOAD_PART_SUFFIX ".part"  // Upload in progress, renamed once complete
+#define CATALOG_FILE "/music_catalog.bin"  // Song metadata, rebuilt if missing
+#define CATALOG_TAG_LENGTH 32            // Bytes kept of ID3 title/artist (UTF-8)
+#define CATALOG_SAVE_DELAY 5000          // ms without changes before saving the catalog
+#define POSITIONS_FILE "/positions.bin"  // Last playback position per tag
+#define POSITION_SAMPLE_INTERVAL 1000    // ms between position samples (Core 0)
+#define POSITION_FLUSH_INTERVAL 30000    // ms between position writes to SD
+#define SD_PLAYBACK_LOW_WATERMARK (AUDIO_STREAM_BUFFER_SIZE / 4)   // Below this, background SD I/O waits
+#define SD_PLAYBACK_HIGH_WATERMARK (AUDIO_STREAM_BUFFER_SIZE / 2)  // ...until playback has refilled past this
+#define SD_BACKGROUND_MAX_WAIT_MS 2000   // Background SD I/O goes ahead anyway after this long
 
 // ============================================================================
 // AUDIO CONFIGURATION
 // ============================================================================
 #define AUDIO_SAMPLE_RATE 44100
-#define AUDIO_BUFFER_SIZE 8192  // Increased from 2048 to reduce audio stuttering
 #define DEFAULT_VOLUME 0.8f  // 0.0 to 1.0
+#define AUDIO_STREAM_BUFFER_SIZE 32768  // SD read-ahead per track slot (two slots), carved once at boot (max 65535)
+#define AUDIO_PREFETCH_CHUNK 4096       // Max bytes read from SD per refill step
+#define AUDIO_PLAYLIST_SIZE 16          // Tracks queued behind the current one
+#define AUDIO_COMMAND_QUEUE_SIZE 32  // Pending player commands, room for a full playlist (power of two)
+#define AUDIO_SEEK_INDEX_ENTRIES 1024  // Seek table size; resolution halves when full
+#define AUDIO_SEEK_SCAN_FRAMES 32       // Frame headers the seek indexer scans per SD lock (VBR files)
+#define AUDIO_SEEK_SYNC_WINDOW 16384    // Max bytes searched for a frame header
+#define AUDIO_COMMAND_LATENCY_MS 5  // Max delay before a command is seen while playing
+#define I2S_DMA_BUF_COUNT 8     // DMA buffers in the I2S ring
+#define I2S_DMA_BUF_LEN 128     // Frames per DMA buffer (~2.9 ms at 44.1 kHz)
+
+// Decoder benchmark (pio run -e decode_bench / -e native_decode_bench), for
+// sizing AUDIO_STREAM_BUFFER_SIZE from measurements
+#ifndef DECODE_BENCH_SECONDS
+#define DECODE_BENCH_SECONDS 0               // Real-time seconds per run; 0 runs the normal firmware
+#endif
+#define DECODE_BENCH_DIR "/bench"            // MP3 corpus, see tools/make_bench_corpus.py
+#define DECODE_BENCH_LOAD_FILE "/bench.tmp"  // Scratch file for the simulated uploads
+
+// Resume-from-position per tag
+#define RESUME_MIN_POSITION_MS 10000  // Closer to the start than this restarts the song
+#define RESUME_REWIND_MS 3000         // Replay a little before the saved position
+#define RESUME_END_MARGIN_MS 10000    // Closer to the end than this counts as finished
 
 // ============================================================================
 // NFC CONFIGURATION
 // ============================================================================
-#define NFC_POLL_INTERVAL 500    // ms between NFC polls (increased to minimize CPU interference with audio)
+#define NFC_POLL_INTERVAL 500    // ms between re-reads of a tag left on the reader (and between polls without NFC_IRQ)
+#define NFC_REMOVAL_TIMEOUT 100  // ms without an answer before a tag counts as removed
 #define NFC_DEBOUNCE_TIME 1500   // ms to debounce same tag
 #define NFC_UID_MAX_LENGTH 7     // Maximum UID length
+#define NFC_HARDWARE_SPI 1       // 1: PN532 on the HSPI peripheral, 0: bit-banged software SPI
+
+// Tap-to-first-sample benchmark (pio run -e bench / -e native_bench)
+#ifndef TAP_BENCH_TAPS
+#define TAP_BENCH_TAPS 0          // Taps to time at boot; 0 runs the normal firmware
+#endif
+#define TAP_BENCH_SETTLE_MS 300   // Quiet time after stopping before the next tap
+#define TAP_BENCH_TIMEOUT_MS 5000 // A tap that plays nothing within this fails the run
 
 // ============================================================================
 // WEB SERVER CONFIGURATION
 // ============================================================================
 #define WEB_SERVER_PORT 80
-#define MAX_UPLOAD_SIZE (10 * 1024 * 1024)  // 10MB max file size
+#define MAX_UPLOAD_SIZE (1024UL * 1024 * 1024)  // 1GB max file size (audiobooks)
+#define LIST_ROW_MAX 512                    // Scratch for one row of a streamed list
+#define EVENTS_RETRY_MS 1000                // Browser reconnect delay for /api/events
+#define UPLOAD_BLOCK_SIZE 16384             // SD write size for uploads (multiple of the 512 B sector)
+#define UPLOAD_BLOCK_COUNT 3                // Blocks in flight between TCP and the SD writer
+#define UPLOAD_RETRY_AFTER_S 1              // Retry-After on a 503 when the SD writer falls behind
+#define UPLOAD_MAX_CONCURRENT 2             // Uploads in flight at once; more get 503
+#define UPLOAD_HEAP_RESERVE 32768           // Internal RAM left free when allocating upload blocks
+#define FILE_STREAM_CHUNK 4096              // Max bytes read from SD per fill when streaming a song
+
+// ============================================================================
+// LOGGING CONFIGURATION
+// ============================================================================
+// Messages above this level compile to nothing (LOG_LEVEL_NONE ... LOG_LEVEL_DEBUG)
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL LOG_LEVEL_INFO
+#endif
+#define LOG_QUEUE_SLOTS 32         // Messages waiting for the drain task (power of two); more are dropped
+#define LOG_MAX_ARGS 8             // Arguments per message
+#define LOG_ARG_BYTES 96           // Argument storage per message (max 255); long strings are cut
+#define LOG_LINE_MAX 256           // Longest formatted line
+#define LOG_DRAIN_INTERVAL_MS 20   // How often the drain task empties the queue
+#ifndef LOG_TO_SD
+#define LOG_TO_SD 0                // 1: also append to LOG_SD_FILE on the card
+#endif
+#define LOG_SD_FILE "/musicbox.log"
+#define LOG_SD_OLD_FILE "/musicbox.old.log"  // LOG_SD_FILE is moved here when full
+#define LOG_SD_MAX_SIZE (256 * 1024)         // Bytes before LOG_SD_FILE is rotated
+#define LOG_SD_BUFFER 1024                   // Lines collected before one SD write
 
 #endif // CONFIG_H
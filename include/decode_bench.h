@@ -0,0 +1,63 @@
+#ifndef DECODE_BENCH_H
+#define DECODE_BENCH_H
+
+#include <Arduino.h>
+#include "config.h"
+
+class AudioFileSourceSD;
+class AudioFileSourceID3;
+class AudioGeneratorMP3;
+class I2SDmaOutput;
+class PrefetchBuffer;
+class TrackChainSource;
+class LatencySource;
+
+// Decoder benchmark (builds with DECODE_BENCH_SECONDS > 0; replaces the
+// player, NFC and Wi-Fi).
+//
+// Every MP3 in DECODE_BENCH_DIR goes through the player's chain: SD file ->
+// PrefetchBuffer -> ID3 filter -> TrackChainSource -> MP3 decoder. Two passes:
+//  1. Flat out into a null output: time to the first sample (ID3 skip),
+//     real-time factor and decode time per 1152-sample frame.
+//  2. DECODE_BENCH_SECONDS in real time into the I2S DMA ring, paced like
+//     the audio task, for each read-ahead size and load profile: underruns
+//     and the lowest buffer fill seen once playback has settled.
+// A load profile slows down SD reads (a slow card, or one that stalls now
+// and then) and/or writes to the card in the background at upload speed,
+// which is what a Wi-Fi upload costs playback.
+class DecodeBench {
+public:
+    DecodeBench();
+    
+    bool begin();  // Starts the benchmark task on Core 1
+
+private:
+    struct Pipeline {
+        AudioFileSourceSD* file;
+        LatencySource* slow;
+        PrefetchBuffer* buff;
+        AudioFileSourceID3* id3;
+        TrackChainSource* chain;
+        AudioGeneratorMP3* mp3;
+    };
+    
+    I2SDmaOutput* _out;
+    uint8_t* _buffer;        // Largest read-ahead size; smaller runs use the front
+    uint8_t* _decoderState;
+    volatile uint32_t _uploadKBps;  // Background writer rate, 0 when idle
+    
+    static void benchTask(void* param);
+    static void loadTask(void* param);
+    void run();
+    void runLoad();
+    
+    bool open(Pipeline& p, const char* path, uint32_t bufferSize, uint8_t profile);
+    void close(Pipeline& p);
+    void measureThroughput(const char* path);
+    bool measurePlayback(const char* path, uint32_t bufferSize, uint8_t profile,
+                         uint32_t& underruns, uint32_t& minFill);
+};
+
+extern DecodeBench decodeBench;
+
+#endif // DECODE_BENCH_H
@@ -0,0 +1,31 @@
+#ifndef FILE_RANGE_STREAM_H
+#define FILE_RANGE_STREAM_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "config.h"
+
+// Serves a byte range of a file on the SD card through AsyncWebServer's
+// fill callback. Reads go straight into the TCP buffer handed to fill(),
+// at most FILE_STREAM_CHUNK at a time, and only when TCP has room, so a
+// slow client holds nothing but the open file.
+//
+// Reads are background SD I/O: while playback needs the card, fill() asks
+// AsyncWebServer to try again later instead of waiting for the bus.
+class FileRangeStream {
+public:
+    FileRangeStream(const String& path, uint32_t start, uint32_t length);
+    ~FileRangeStream();
+    
+    bool isOpen() { return (bool)_file; }
+    
+    // AwsResponseFiller
+    size_t fill(uint8_t* buffer, size_t maxLen, size_t index);
+    
+private:
+    File _file;
+    uint32_t _start;
+    uint32_t _length;
+};
+
+#endif // FILE_RANGE_STREAM_H
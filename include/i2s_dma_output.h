@@ -0,0 +1,59 @@
+#ifndef I2S_DMA_OUTPUT_H
+#define I2S_DMA_OUTPUT_H
+
+#include <Arduino.h>
+#include <driver/i2s.h>
+#include "AudioOutput.h"
+#include "config.h"
+
+// I2S output for the MAX98357A that exposes the driver's DMA event queue.
+// ConsumeSample() never blocks: when the DMA ring is full it returns false
+// and the audio task can sleep on waitForSpace() until the ISR reports a
+// transmitted buffer.
+class I2SDmaOutput : public AudioOutput {
+public:
+    I2SDmaOutput(i2s_port_t port = I2S_NUM_0);
+    virtual ~I2SDmaOutput() override;
+    
+    bool SetPinout(int bclk, int lrc, int dout);
+    virtual bool SetRate(int hz) override;
+    virtual bool SetBitsPerSample(int bits) override;
+    virtual bool SetChannels(int channels) override;
+    virtual bool begin() override;
+    virtual bool ConsumeSample(int16_t sample[2]) override;
+    virtual void flush() override;
+    virtual bool stop() override;
+    
+    // Block until at least one DMA buffer has been sent, or timeout.
+    // Returns false on timeout.
+    bool waitForSpace(TickType_t timeout);
+    
+    // Frames accepted by ConsumeSample() since begin() (free-running)
+    uint32_t getFramesConsumed() { return _framesConsumed; }
+    int getRate() { return hertz; }
+    
+    // Times the DMA ring ran dry while playing (free-running). Counted from
+    // the driver's TX_Q_OVF event once the ring has been filled, so the
+    // drain at start, pause and stop doesn't count.
+    uint32_t getUnderruns() { return _underruns; }
+    
+    // Playback is pausing on purpose: let the ring drain without counting it
+    void idle() { _primed = false; }
+    
+private:
+    i2s_port_t _port;
+    int _bclk, _lrc, _dout;
+    bool _installed;
+    QueueHandle_t _events;
+    
+    // Samples waiting for room in the DMA ring (interleaved L/R)
+    int16_t _pending[I2S_DMA_BUF_LEN * 2];
+    size_t _pendingFrames;
+    uint32_t _framesConsumed;
+    bool _primed;                  // Ring has been full since the last start/pause/underrun
+    volatile uint32_t _underruns;
+    
+    bool writePending();
+};
+
+#endif // I2S_DMA_OUTPUT_H
@@ -0,0 +1,73 @@
+#ifndef JSON_LIST_STREAM_H
+#define JSON_LIST_STREAM_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Writes a JSON list response one row at a time into the buffers handed out
+// by AsyncWebServer's chunked responses, so memory use doesn't depend on the
+// number of rows. Subclasses produce the next piece of text (head, one row,
+// tail) into _row; fill() copies it out across as many chunks as needed.
+//
+// Output: {"total":N,"offset":O,"<key>":[row,row,...]}
+class JsonListStream {
+public:
+    JsonListStream(const char* key, const String& prefix, size_t offset, size_t limit);
+    virtual ~JsonListStream() {}
+    
+    // AwsResponseFiller: returns bytes written, 0 when the response is done
+    size_t fill(uint8_t* buffer, size_t maxLen);
+
+protected:
+    char _prefix[MAX_FILENAME_LENGTH];
+    size_t _offset;
+    size_t _limit;      // 0 = no limit
+    
+    virtual size_t countRows() = 0;
+    // Write the next row's JSON to out; false when there are no more rows
+    virtual bool nextRow(char* out, size_t outLen) = 0;
+    
+    // Append s as a quoted, escaped JSON string
+    static size_t appendString(char* out, size_t outLen, size_t n, const char* s);
+
+private:
+    enum Phase : uint8_t { PHASE_HEAD, PHASE_ROWS, PHASE_TAIL, PHASE_DONE };
+    
+    const char* _key;
+    Phase _phase;
+    size_t _emitted;
+    char _row[LIST_ROW_MAX];
+    size_t _rowLen;
+    size_t _rowSent;
+    
+    bool produce();
+};
+
+// /api/songs: names from the music catalog, in name order
+class SongListStream : public JsonListStream {
+public:
+    SongListStream(const String& prefix, size_t offset, size_t limit);
+
+protected:
+    size_t countRows() override;
+    bool nextRow(char* out, size_t outLen) override;
+
+private:
+    char _lastName[MAX_FILENAME_LENGTH];
+};
+
+// /api/tags: links from the NFC link table, prefix matches the UID
+class TagListStream : public JsonListStream {
+public:
+    TagListStream(const String& prefix, size_t offset, size_t limit);
+
+protected:
+    size_t countRows() override;
+    bool nextRow(char* out, size_t outLen) override;
+
+private:
+    size_t _cursor;
+    size_t _skipped;
+};
+
+#endif // JSON_LIST_STREAM_H
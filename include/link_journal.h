@@ -0,0 +1,61 @@
+#ifndef LINK_JOURNAL_H
+#define LINK_JOURNAL_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "config.h"
+#include "nfc_link_table.h"
+
+// Crash-safe persistence for the NFC link table.
+//
+// Every link/unlink is one small CRC-protected record appended to the
+// journal. When the journal grows past NFC_JOURNAL_COMPACT_SIZE the whole
+// table is written to a new snapshot (tmp file + rename) and the journal is
+// dropped. Loading reads the snapshot and replays the journal up to the
+// first torn or corrupt record, so a power cut loses at most the mutation
+// that was being written.
+class LinkJournal {
+public:
+    LinkJournal();
+    
+    // Returns false if neither a snapshot nor a journal exists
+    bool load(NfcLinkTable& table);
+    
+    bool appendLink(const TagUid& uid, const char* path);
+    bool appendUnlink(const TagUid& uid);
+    
+    bool needsCompaction() { return _journalSize >= NFC_JOURNAL_COMPACT_SIZE; }
+    bool compact(const NfcLinkTable& table);
+
+private:
+    enum RecordType : uint8_t {
+        RECORD_LINK = 1,
+        RECORD_UNLINK = 2
+    };
+    
+    // Fixed part of a record; followed by pathLength bytes of path and a
+    // CRC32 over both
+    struct __attribute__((packed)) RecordHeader {
+        uint8_t type;
+        TagUid uid;
+        uint8_t pathLength;
+    };
+    
+    struct __attribute__((packed)) SnapshotHeader {
+        char magic[4];     // "MBLS"
+        uint16_t version;
+        uint16_t reserved;
+        uint32_t count;    // LINK records that follow
+    };
+    
+    uint32_t _journalSize;
+    
+    bool append(RecordType type, const TagUid& uid, const char* path);
+    bool loadSnapshot(const char* filePath, NfcLinkTable& table);
+    bool writeRecord(File& file, RecordType type, const TagUid& uid, const char* path);
+    bool readRecord(File& file, RecordHeader& header, char* path);
+    
+    static uint32_t crc32(uint32_t crc, const uint8_t* data, size_t len);
+};
+
+#endif // LINK_JOURNAL_H
@@ -0,0 +1,188 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include <atomic>
+#include <string.h>
+#include "config.h"
+
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4
+
+// One queued message: the format string (a literal, so only the pointer is
+// kept) and its arguments in binary. Strings are copied, since the caller's
+// buffer is gone by the time the drain task formats the line.
+struct LogRecord {
+    enum ArgType : uint8_t { ARG_INT, ARG_DOUBLE, ARG_STRING, ARG_POINTER, ARG_MISSING };
+    
+    const char* format;
+    uint32_t timeMs;
+    uint8_t level;
+    uint8_t argCount;
+    uint8_t size;  // Bytes used in data
+    uint8_t types[LOG_MAX_ARGS];
+    uint8_t data[LOG_ARG_BYTES];
+    
+    void add(int v) { addInt(v); }
+    void add(unsigned int v) { addInt(v); }
+    void add(long v) { addInt(v); }
+    void add(unsigned long v) { addInt(v); }
+    void add(long long v) { addInt(v); }
+    void add(unsigned long long v) { addInt(v); }
+    void add(double v) { addValue(ARG_DOUBLE, &v, sizeof(v)); }
+    void add(const void* v) {
+        uint64_t bits = (uintptr_t)v;
+        addValue(ARG_POINTER, &bits, sizeof(bits));
+    }
+    void add(const char* v);
+
+private:
+    void addInt(uint64_t v) { addValue(ARG_INT, &v, sizeof(v)); }
+    void addValue(ArgType type, const void* value, size_t length) {
+        if (argCount == LOG_MAX_ARGS) {
+            return;
+        }
+        if (size + length > LOG_ARG_BYTES) {
+            types[argCount++] = ARG_MISSING;
+            return;
+        }
+        memcpy(&data[size], value, length);
+        size += length;
+        types[argCount++] = type;
+    }
+};
+
+// Logging for code that can't wait on the UART: at 115200 baud a line takes
+// milliseconds to send, and Serial.printf blocks the caller until it has.
+//
+// LOG_INFO("Seeked to %u ms", ms) only copies the format pointer and the
+// arguments into a slot of a fixed ring (a few microseconds); a low-priority
+// task on Core 0 formats the lines and writes them to Serial, and with
+// LOG_TO_SD also to a rotating file on the card. Lines appear up to
+// LOG_DRAIN_INTERVAL_MS late, and out of order with plain Serial output.
+//
+// Any task may log (not ISRs). Producers claim slots with a compare-and-swap
+// on the head and never block: with the ring full the message is dropped and
+// counted, and the drain task reports the count. Messages above
+// LOG_COMPILE_LEVEL are compiled out, arguments included.
+class Logger {
+public:
+    Logger();
+    
+    bool begin();       // Starts the drain task; messages before it are kept
+    void beginSdLog();  // With LOG_TO_SD: append to the card from now on (card mounted)
+    
+    template <typename... Args>
+    void write(uint8_t level, const char* format, const Args&... args) {
+        uint32_t pos;
+        Slot* slot = claim(pos);
+        if (!slot) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        LogRecord& record = slot->record;
+        record.format = format;
+        record.timeMs = millis();
+        record.level = level;
+        record.argCount = 0;
+        record.size = 0;
+        addArgs(record, args...);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+    }
+    
+    uint32_t getDropped() { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+    static_assert((LOG_QUEUE_SLOTS & (LOG_QUEUE_SLOTS - 1)) == 0, "LOG_QUEUE_SLOTS must be a power of two");
+    
+    // sequence == position: free for the producer claiming that position;
+    // position + 1: written, ready for the drain task
+    struct Slot {
+        std::atomic<uint32_t> sequence;
+        LogRecord record;
+    };
+    
+    Slot _slots[LOG_QUEUE_SLOTS];
+    std::atomic<uint32_t> _head;  // Next position to claim (all producers)
+    uint32_t _tail;               // Next position to drain (drain task only)
+    std::atomic<uint32_t> _dropped;
+    uint32_t _droppedReported;
+    
+    bool _sdEnabled;
+    File _sdFile;
+    char _sdBuffer[LOG_SD_BUFFER];
+    size_t _sdLength;
+    
+    Slot* claim(uint32_t& pos) {
+        pos = _head.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot* slot = &_slots[pos & (LOG_QUEUE_SLOTS - 1)];
+            int32_t diff = (int32_t)(slot->sequence.load(std::memory_order_acquire) - pos);
+            if (diff == 0) {
+                if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    return slot;
+                }
+            } else if (diff < 0) {
+                return nullptr;  // Full: the slot still holds a message from a lap ago
+            } else {
+                pos = _head.load(std::memory_order_relaxed);  // Another producer took it
+            }
+        }
+    }
+    
+    static void addArgs(LogRecord&) {}
+    template <typename T, typename... Rest>
+    static void addArgs(LogRecord& record, const T& first, const Rest&... rest) {
+        record.add(first);
+        addArgs(record, rest...);
+    }
+    
+    static void drainTask(void* param);
+    void drain();
+    bool pop(LogRecord& record);
+    static size_t format(const LogRecord& record, char* out, size_t outLen);
+    void writeSd(const char* line, size_t length);
+    void flushSd();
+};
+
+extern Logger logger;
+
+// Never called: lets the compiler check the format against the arguments,
+// also for messages compiled out (which then still count as using them)
+static inline void logCheckFormat(const char* format, ...) __attribute__((format(printf, 1, 2)));
+static inline void logCheckFormat(const char*, ...) {}
+
+#define LOG_AT(level, ...) do { \
+        if (false) { logCheckFormat(__VA_ARGS__); } \
+        logger.write(level, __VA_ARGS__); \
+    } while (0)
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) do { if (false) { logCheckFormat(__VA_ARGS__); } } while (0)
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(...) LOG_AT(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) do { if (false) { logCheckFormat(__VA_ARGS__); } } while (0)
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...) LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) do { if (false) { logCheckFormat(__VA_ARGS__); } } while (0)
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) do { if (false) { logCheckFormat(__VA_ARGS__); } } while (0)
+#endif
+
+#endif // LOGGER_H
@@ -0,0 +1,127 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <Arduino.h>
+
+// Histogram with fixed upper bounds (ascending) plus an overflow bucket.
+// Only one task may record into a given histogram.
+struct Histogram {
+    static const uint8_t MAX_BOUNDS = 12;
+    
+    const uint32_t* bounds;
+    uint8_t boundCount;
+    volatile uint32_t counts[MAX_BOUNDS + 1];
+    volatile uint32_t sum;  // Wraps; Prometheus rate() takes it as a reset
+    
+    void record(uint32_t value) {
+        uint8_t i = 0;
+        while (i < boundCount && value > bounds[i]) {
+            i++;
+        }
+        counts[i]++;
+        sum += value;
+    }
+};
+
+// Routes timed by HttpTimer, in the order /api/metrics lists them
+enum HttpRoute : uint8_t {
+    ROUTE_ROOT,
+    ROUTE_SONGS_LIST,
+    ROUTE_SONGS_UPLOAD,
+    ROUTE_SONG_PUT,
+    ROUTE_SONG_STREAM,
+    ROUTE_SONG_DELETE,
+    ROUTE_TAGS_SCAN,
+    ROUTE_TAGS_SCAN_CLEAR,
+    ROUTE_TAGS_LINK,
+    ROUTE_TAGS_LIST,
+    ROUTE_TAG_DELETE,
+    ROUTE_STATUS,
+    ROUTE_SEEK,
+    ROUTE_METRICS,
+    ROUTE_NOT_FOUND,
+    HTTP_ROUTE_COUNT
+};
+
+// Runtime counters for /api/metrics, cheap enough to stay on in production.
+//
+// Every counter has exactly one writing task, so updates are plain 32-bit
+// stores: no lock, no atomic read-modify-write. The scrape only reads them
+// and may see one counter a step ahead of another.
+//   audio task:  bufferFill, sdReadMicros
+//   NFC task:    nfcPolls, nfcHits, nfcMisses
+//   async_tcp:   HTTP routes
+// Heap, task and player figures are read when the metrics are scraped.
+class Metrics {
+public:
+    Metrics();
+    
+    // Read-ahead fill of the playing track, in percent, once per audio loop
+    Histogram bufferFill;
+    // Playback SD reads (one chunk each), in microseconds
+    Histogram sdReadMicros;
+    
+    volatile uint32_t nfcPolls;   // Detection attempts
+    volatile uint32_t nfcHits;    // ...that read a tag
+    volatile uint32_t nfcMisses;  // ...that found none (or timed out)
+    
+    // async_tcp task: time spent in a route's handlers. request is true
+    // once per request; body and upload chunks only add their time.
+    void recordHttp(HttpRoute route, uint32_t micros, bool request);
+    
+    // Tasks whose stack is reported when the FreeRTOS trace facility is off
+    void trackTask(TaskHandle_t task);
+    
+    void writePrometheus(Print& out);
+    void writeJson(Print& out);
+
+private:
+    struct RouteStats {
+        volatile uint32_t count;
+        volatile uint32_t sumMicros;
+        volatile uint32_t maxMicros;
+    };
+    RouteStats _http[HTTP_ROUTE_COUNT];
+    
+    static const uint8_t MAX_TRACKED_TASKS = 8;
+    TaskHandle_t _tasks[MAX_TRACKED_TASKS];
+    uint8_t _taskCount;
+    
+    // Run time per task at the previous scrape, for CPU share
+    static const uint8_t MAX_TASKS = 32;
+    struct TaskRunTime {
+        UBaseType_t number;
+        uint32_t runTime;
+    };
+    TaskRunTime _lastRunTimes[MAX_TASKS];
+    uint8_t _lastRunTimeCount;
+    uint32_t _lastTotalRunTime;
+    
+    struct TaskInfo {
+        const char* name;
+        uint32_t stackFree;  // Bytes never used, since the task started
+        float cpu;           // Share of one core since the last scrape, -1 if unknown
+    };
+    uint8_t collectTasks(TaskInfo* tasks, uint8_t maxTasks);
+};
+
+extern Metrics metrics;
+
+// Adds the time until the end of the scope to a route:
+//   HttpTimer timer(ROUTE_STATUS);
+class HttpTimer {
+public:
+    explicit HttpTimer(HttpRoute route, bool request = true)
+        : _route(route), _request(request), _start(micros()) {}
+    ~HttpTimer() { metrics.recordHttp(_route, micros() - _start, _request); }
+    
+    HttpTimer(const HttpTimer&) = delete;
+    HttpTimer& operator=(const HttpTimer&) = delete;
+
+private:
+    HttpRoute _route;
+    bool _request;
+    uint32_t _start;
+};
+
+#endif // METRICS_H
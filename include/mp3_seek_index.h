@@ -0,0 +1,89 @@
+#ifndef MP3_SEEK_INDEX_H
+#define MP3_SEEK_INDEX_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "config.h"
+
+// Maps a playback time to a byte offset in an MP3 file so the player can
+// seek with a single SD seek plus one frame sync.
+//
+// Sources, in order of preference:
+//  - a cached index saved next to the file (<file>.idx)
+//  - the Xing/Info TOC of a VBR file
+//  - the bitrate of a CBR file (confirmed by probing a few frames)
+//  - a frame scan, built a few frames at a time while the track plays
+class Mp3SeekIndex {
+public:
+    Mp3SeekIndex();
+    
+    // Prepare the index for a file. Cheap unless the file needs probing.
+    bool open(const char* mp3Path);
+    void close();
+    
+    bool isOpen() { return _mode != MODE_NONE; }
+    bool isComplete() { return _complete; }
+    
+    // Scan up to maxFrames frame headers. Saves the index once the end of
+    // the file is reached. Returns true when the index is complete.
+    bool buildStep(uint32_t maxFrames);
+    
+    // Byte offset of the frame that contains positionMs
+    uint32_t lookup(uint32_t positionMs);
+    uint32_t getDurationMs();
+    uint32_t getDataStart() { return _dataStart; }  // First audio frame
+    // Average bitrate in bits/s (first frame's bitrate while a scan is pending)
+    uint32_t getBitrate();
+
+private:
+    enum Mode : uint8_t {
+        MODE_NONE,
+        MODE_CBR,   // Constant bitrate, offset is linear in time
+        MODE_TOC,   // Xing TOC, 100 percentage points
+        MODE_SCAN   // Byte offset every _interval frames
+    };
+    
+    struct FrameInfo {
+        uint32_t length;         // Bytes including header
+        uint32_t bitrate;        // bits/s
+        uint32_t sampleRate;
+        uint16_t samplesPerFrame;
+        uint8_t sideInfoSize;    // Bytes between header and Xing tag
+    };
+    
+    Mode _mode;
+    bool _complete;
+    char _path[AUDIO_MAX_PATH_LENGTH];
+    File _file;
+    
+    uint32_t _fileSize;
+    uint32_t _dataStart;      // First audio frame (after ID3v2)
+    uint32_t _dataBytes;      // Audio bytes from _dataStart
+    uint32_t _sampleRate;
+    uint16_t _samplesPerFrame;
+    uint32_t _bitrate;        // MODE_CBR
+    uint32_t _frameCount;     // Total frames (known for TOC/complete scan)
+    uint8_t _toc[100];        // MODE_TOC
+    
+    // MODE_SCAN
+    uint32_t _entries[AUDIO_SEEK_INDEX_ENTRIES];
+    uint16_t _entryCount;
+    uint16_t _interval;       // Frames between entries
+    uint32_t _scanPos;
+    uint32_t _scanFrames;
+    
+    static bool parseHeader(const uint8_t* h, FrameInfo& info);
+    bool readFrameAt(uint32_t pos, FrameInfo& info);
+    bool findFrame(uint32_t from, uint32_t& pos, FrameInfo& info);
+    uint32_t skipId3v2();
+    bool parseVbrHeader(const FrameInfo& first);
+    bool probeCbr(const FrameInfo& first);
+    void addEntry(uint32_t offset);
+    uint32_t frameToMs(uint32_t frame);
+    
+    bool loadCache();
+    bool saveCache();
+    void cachePath(char* out, size_t len);
+};
+
+#endif // MP3_SEEK_INDEX_H
@@ -0,0 +1,95 @@
+#ifndef MUSIC_CATALOG_H
+#define MUSIC_CATALOG_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "config.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+// One song in /music. Fixed size so the catalog file is the in-memory array.
+struct CatalogEntry {
+    char name[MAX_FILENAME_LENGTH];      // File name inside MUSIC_DIR
+    char title[CATALOG_TAG_LENGTH];      // ID3 title, empty if unknown
+    char artist[CATALOG_TAG_LENGTH];     // ID3 artist, empty if unknown
+    uint32_t size;
+    uint32_t mtime;
+    uint32_t durationMs;                 // 0 until probed
+    uint16_t bitrate;                    // kbit/s, 0 until probed
+    uint16_t flags;
+};
+
+// In-memory index of the MP3 files in MUSIC_DIR, sorted by name.
+//
+// Loaded from CATALOG_FILE at boot and checked against the directory with a
+// single listing pass (name, size, mtime only). New or changed files are
+// probed for duration, bitrate and ID3 tags later, a few per loop(), so boot
+// doesn't wait on reading thousands of headers. Listing and existence checks
+// never touch the SD card. The array lives in PSRAM when available.
+//
+// Thread-safe: web handlers and the main loop both use it. SD access goes
+// through sdBus, always taken before the catalog's own lock.
+class MusicCatalog {
+public:
+    MusicCatalog();
+    
+    bool begin();
+    void loop();  // Core 0: probes pending files, saves after changes settle
+    
+    size_t count();
+    bool get(size_t index, CatalogEntry& entry);
+    bool find(const char* name, CatalogEntry* entry = nullptr);
+    
+    // Name-ordered iteration restricted to names starting with prefix.
+    // Cursors are names rather than indexes so concurrent uploads/deletes
+    // don't make a listing skip or repeat songs.
+    size_t countPrefix(const char* prefix);
+    bool findPrefix(const char* prefix, size_t offset, CatalogEntry& entry);
+    bool nextAfter(const char* prefix, const char* after, CatalogEntry& entry);
+    
+    // Incremental updates after an upload or delete
+    bool update(const char* name);
+    bool remove(const char* name);
+
+private:
+    enum EntryFlags : uint16_t {
+        ENTRY_PROBED = 0x0001,  // duration/bitrate/tags are filled in
+        ENTRY_SEEN = 0x8000     // Transient: present in the directory walk
+    };
+    
+    struct __attribute__((packed)) FileHeader {
+        char magic[4];          // "MBMC"
+        uint16_t version;
+        uint16_t entrySize;     // sizeof(CatalogEntry), guards layout changes
+        uint32_t count;
+    };
+    
+    CatalogEntry* _entries;
+    size_t _count;
+    size_t _capacity;
+    SemaphoreHandle_t _lock;
+    
+    bool _dirty;
+    unsigned long _lastChange;
+    size_t _pendingProbes;  // Entries without ENTRY_PROBED
+    
+    bool reserve(size_t capacity);
+    int indexOf(const char* name, size_t limit);  // Binary search in [0, limit)
+    size_t lowerBound(const char* name, bool strict);  // First name >= (or >) name
+    CatalogEntry* insertSorted(const char* name);
+    void sortEntries();
+    
+    bool load();
+    bool save();
+    void scanDirectory();
+    
+    static bool probe(CatalogEntry& entry);
+    static void readId3v2(File& file, CatalogEntry& entry);
+    static void readId3v1(File& file, CatalogEntry& entry);
+    static void copyTagText(char* out, size_t outLen, uint8_t encoding, const uint8_t* data, size_t len);
+    
+    void lock() { xSemaphoreTake(_lock, portMAX_DELAY); }
+    void unlock() { xSemaphoreGive(_lock); }
+};
+
+#endif // MUSIC_CATALOG_H
@@ -0,0 +1,70 @@
+#ifndef NFC_LINK_TABLE_H
+#define NFC_LINK_TABLE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "config.h"
+#include "tag_uid.h"
+
+// UID -> song path map for tag taps.
+// Open addressing with linear probing over packed UID keys, so a lookup is a
+// hash plus (on average) one or two slot compares regardless of how many
+// tags are linked. Paths are interned: many tags linked to the same song or
+// folder share one copy.
+class NfcLinkTable {
+public:
+    NfcLinkTable();
+    ~NfcLinkTable();
+    
+    bool set(const TagUid& uid, const char* path);
+    bool remove(const TagUid& uid);
+    const char* find(const TagUid& uid) const;  // nullptr if not linked
+    void clear();
+    
+    size_t size() const { return _count; }
+    size_t capacity() const { return _capacity; }  // Slots, a power of two (0 until the first link)
+    
+    // Next link at or after slot `cursor`; advances cursor past it.
+    // Start with cursor = 0. Order is arbitrary but stable until a rehash.
+    bool next(size_t& cursor, TagUid& uid, const char*& path) const;
+    
+    // fn(const TagUid& uid, const char* path) for every link
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (size_t i = 0; i < _capacity; i++) {
+            if (isUsed(_slots[i])) {
+                fn(_slots[i].key, _paths[_slots[i].path]);
+            }
+        }
+    }
+
+private:
+    static const uint8_t SLOT_EMPTY = 0;       // key.length of a free slot
+    static const uint8_t SLOT_DELETED = 0xFF;  // key.length of a tombstone
+    static const size_t MIN_CAPACITY = 16;     // Power of two
+    
+    struct Slot {
+        TagUid key;
+        uint16_t path;  // Index into _paths
+    };
+    
+    Slot* _slots;
+    size_t _capacity;
+    size_t _count;
+    size_t _deleted;
+    
+    std::vector<char*> _paths;        // nullptr when unused
+    std::vector<uint16_t> _pathRefs;
+    
+    static bool isUsed(const Slot& slot) {
+        return slot.key.length != SLOT_EMPTY && slot.key.length != SLOT_DELETED;
+    }
+    
+    size_t findSlot(const TagUid& key) const;  // _capacity if absent
+    bool rehash(size_t capacity);
+    int internPath(const char* path);
+    void releasePath(uint16_t index);
+};
+
+#endif // NFC_LINK_TABLE_H
@@ -5,35 +5,65 @@
 #include <Wire.h>
 #include <SPI.h>
 #include <Adafruit_PN532.h>
+#include "config.h"
+#include "tag_uid.h"
 
+// PN532 reader driven by its own task (Core 0).
+//
+// With NFC_IRQ wired, the task leaves an InListPassiveTarget pending on the
+// PN532 and sleeps until the chip pulls IRQ low, so nothing runs while the
+// reader is empty and a tap is seen as soon as the chip finds it. A tag
+// resting on the reader is re-read every NFC_POLL_INTERVAL; when a re-armed
+// detection gets no answer within NFC_REMOVAL_TIMEOUT, the tag is gone.
+// Without NFC_IRQ (-1) the task polls every NFC_POLL_INTERVAL instead.
+//
+// Detected tags are handed to loop(), which runs the callback on the main
+// loop task like the rest of the application logic.
 class NFCReader {
 public:
     NFCReader();
     
     bool begin();
-    void loop();
+    void loop();  // Main loop: delivers tags read by the NFC task
     
-    String getLastUID() { return _lastUID; }
+    TagUid getLastUID() { return _lastUID; }
     bool hasNewTag() { return _hasNewTag; }
     void clearNewTag() { _hasNewTag = false; }
-    void clearLastUID() { _lastUID = ""; }  // Clear last UID manually
+    void clearLastUID() { _lastUID.clear(); }  // Clear last UID manually
+    
+    // Report the tag on the reader again as if it had just been placed
+    // there, without waiting for the next re-read (tap benchmark)
+    void retrigger();
     
     // Callback when a tag is detected
-    void setOnTagDetected(void (*callback)(String uid)) {
+    void setOnTagDetected(void (*callback)(const TagUid& uid)) {
         _onTagDetected = callback;
     }
-    
+
 private:
+    SPIClass* _spi;  // HSPI bus (NFC_HARDWARE_SPI only)
     Adafruit_PN532* _nfc;
-    String _lastUID;
-    String _currentUID;
-    unsigned long _lastReadTime;
-    unsigned long _lastTagTime;  // Time when tag was last detected
+    TagUid _lastUID;
     bool _hasNewTag;
-    void (*_onTagDetected)(String uid);
+    void (*_onTagDetected)(const TagUid& uid);
+    
+    // NFC task state
+    TaskHandle_t _task;
+    bool _armed;  // An InListPassiveTarget is pending on the PN532
+    TagUid _currentUid;  // Empty while no tag is on the reader
+    unsigned long _lastTagTime;  // Time when tag was last reported
+    volatile uint32_t _irqAt;    // micros() of the last IRQ edge
+    volatile bool _retrigger;    // Forget _currentUid on the next read
+    
+    // Handoff to loop()
+    portMUX_TYPE _pendingLock;
+    TagUid _pendingUid;  // Empty when loop() has nothing to deliver
     
-    String uidToString(uint8_t* uid, uint8_t uidLength);
-    bool readTag();
+    static void taskEntry(void* param);
+    static void IRAM_ATTR onIrq();
+    void run();
+    bool waitForTarget(TickType_t timeout);
+    void onTarget(const TagUid& uid, uint32_t seenAt);
 };
 
 extern NFCReader nfcReader;
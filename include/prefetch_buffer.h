@@ -0,0 +1,43 @@
+#ifndef PREFETCH_BUFFER_H
+#define PREFETCH_BUFFER_H
+
+#include "AudioFileSourceBuffer.h"
+
+// AudioFileSourceBuffer that never reads more than one chunk from the SD
+// card per call. The stock buffer refills all free space (up to 32 KB) in a
+// single blocking read, which is longer than the I2S DMA ring can cover.
+// prefill() lets the audio task warm up a track in small steps before the
+// decoder touches it.
+//
+// SD reads go through sdBus. Top-ups don't wait for background I/O while
+// the buffer is above SD_PLAYBACK_LOW_WATERMARK (scaled to this buffer's
+// size when it isn't AUDIO_STREAM_BUFFER_SIZE); they try again next pass.
+//
+// The library keeps its read/write offsets in 16 bits, so size must not
+// exceed 65535 bytes.
+class PrefetchBuffer : public AudioFileSourceBuffer {
+public:
+    PrefetchBuffer(AudioFileSource* source, void* buffer, uint32_t size, uint32_t chunkSize);
+    
+    // Read at most one chunk ahead of the decoder. Only valid before the
+    // first read(). Returns true once the buffer is full or the file ended.
+    bool prefill();
+    
+    virtual uint32_t read(void* data, uint32_t len) override;
+    virtual bool seek(int32_t pos, int dir) override;
+    
+    // The whole file has been read into the buffer
+    bool sourceEnded() { return src->getPos() >= src->getSize(); }
+    
+protected:
+    virtual void fill() override;
+    
+private:
+    uint32_t _chunkSize;
+    uint32_t _lowWatermark;
+    
+    // Bytes read, or -1 if the SD bus was busy and urgent was false
+    int32_t readChunk(uint32_t maxBytes, bool urgent);
+};
+
+#endif // PREFETCH_BUFFER_H
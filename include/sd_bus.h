@@ -0,0 +1,80 @@
+#ifndef SD_BUS_H
+#define SD_BUS_H
+
+#include <Arduino.h>
+#include "config.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/event_groups.h>
+
+// Owns the SD card. Playback reads (audio task, Core 1) and everything else
+// (uploads, catalog, links, positions - Core 0) take turns through one lock,
+// so a multi-block upload write can't interleave with a decoder refill.
+//
+// Playback has the deadline: the audio task reports how full the playing
+// track's read-ahead buffer is, and background I/O only starts while it is
+// comfortably full. Once it drops below SD_PLAYBACK_LOW_WATERMARK, new
+// background operations wait until playback has refilled past
+// SD_PLAYBACK_HIGH_WATERMARK, so uploads and catalog probes run in the gaps
+// between refills instead of racing them. Background callers don't need to
+// split their work further: one operation is far shorter than what the
+// buffer holds at the watermark.
+//
+// The lock is recursive, so storage methods can call each other.
+class SdBus {
+public:
+    SdBus();
+    
+    bool begin();
+    
+    // Audio task. With wait=false, returns false straight away if background
+    // I/O holds the bus (the buffer has enough left to try again later).
+    bool lockPlayback(bool wait);
+    
+    // Any other task: waits for playback to have slack, then for the bus
+    void lockBackground();
+    // Same, but returns false instead of waiting
+    bool tryLockBackground();
+    
+    void unlock();
+    
+    // Audio task: fill level of the buffer the decoder is reading from
+    void setPlaybackLevel(uint32_t bytes);
+    // Audio task: nothing is playing, background I/O never has to wait
+    void setPlaybackIdle();
+    
+    // Times background I/O gave up waiting for playback (since boot)
+    uint32_t getBackgroundTimeouts() { return _backgroundTimeouts; }
+
+private:
+    static const EventBits_t PLAYBACK_SLACK = 0x01;  // Set while background I/O may start
+    
+    SemaphoreHandle_t _lock;
+    EventGroupHandle_t _state;
+    bool _slack;  // Mirrors PLAYBACK_SLACK; written by the audio task only
+    volatile uint32_t _backgroundTimeouts;
+};
+
+extern SdBus sdBus;
+
+// Holds the SD bus for the current scope:
+//   SdLock lock;                    // background I/O
+//   SdLock lock(SdLock::PLAYBACK);  // audio task
+class SdLock {
+public:
+    enum Priority { BACKGROUND, PLAYBACK };
+    
+    explicit SdLock(Priority priority = BACKGROUND) {
+        if (priority == PLAYBACK) {
+            sdBus.lockPlayback(true);
+        } else {
+            sdBus.lockBackground();
+        }
+    }
+    ~SdLock() { sdBus.unlock(); }
+    
+    SdLock(const SdLock&) = delete;
+    SdLock& operator=(const SdLock&) = delete;
+};
+
+#endif // SD_BUS_H
@@ -0,0 +1,70 @@
+#ifndef SEEK_INDEXER_H
+#define SEEK_INDEXER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include "config.h"
+#include "mp3_seek_index.h"
+
+// Builds the seek table of the track being played on a low-priority task on
+// Core 0, so probing the file, the frame scan and writing the .idx cache
+// never run on the audio task.
+//
+// The audio task requests a track and then only polls: once the file is
+// opened the indexer publishes a bitrate estimate, and once the table is
+// complete it hands the whole index over. Each stage is published with a
+// release store of the request's generation; the indexer touches the
+// published data again only after the next request, which the audio task
+// posts after its last read of it. No locks on the audio side.
+class SeekIndexer {
+public:
+    SeekIndexer();
+    
+    bool begin();  // Starts the indexer task
+    
+    // Audio task only
+    void request(const char* mp3Path);  // Replaces any request in progress
+    void cancel();
+    
+    // Byte offset for positionMs: exact once the index is complete, from the
+    // first frame's bitrate while a scan is still running. false until the
+    // file has been opened.
+    bool lookup(uint32_t positionMs, uint32_t& offset);
+    bool hasFailed();          // The file could not be indexed (not an MP3)
+    uint32_t getDurationMs();  // 0 until known
+
+private:
+    struct Request {
+        uint32_t generation;
+        char path[AUDIO_MAX_PATH_LENGTH];  // "" cancels
+    };
+    
+    // Known as soon as the file is opened
+    struct Summary {
+        bool valid;
+        uint32_t dataStart;
+        uint32_t bitrate;
+        uint32_t durationMs;  // 0 while a scan is pending
+    };
+    
+    QueueHandle_t _requests;  // One slot, overwritten by newer requests
+    uint32_t _generation;     // Last request posted (audio task)
+    
+    // Written by the indexer task for the request it is working on
+    Mp3SeekIndex _index;
+    Summary _summary;
+    std::atomic<uint32_t> _openedGeneration;  // _summary is valid for it
+    std::atomic<uint32_t> _readyGeneration;   // _index is complete for it
+    
+    void post(const char* mp3Path);
+    bool isOpened() { return _openedGeneration.load(std::memory_order_acquire) == _generation; }
+    bool isReady() { return _readyGeneration.load(std::memory_order_acquire) == _generation; }
+    
+    static void indexerTask(void* param);
+    void run();
+    void build(const Request& request);
+};
+
+#endif // SEEK_INDEXER_H
@@ -4,41 +4,108 @@
 #include <Arduino.h>
 #include <SD.h>
 #include <ArduinoJson.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include <vector>
+#include "config.h"
+#include "nfc_link_table.h"
+#include "link_journal.h"
+#include "music_catalog.h"
 
 struct NFCLink {
     String uid;
     String songPath;
 };
 
+// Full paths of what a link plays, in play order. Fixed size, so a tap can
+// fill one without touching the heap.
+struct Playlist {
+    char tracks[PLAYLIST_MAX_TRACKS][AUDIO_MAX_PATH_LENGTH];
+    uint8_t count;
+};
+
+// Fixed-size record in POSITIONS_FILE, updated in place
+struct PositionRecord {
+    char uid[TagUid::HEX_SIZE];  // Hex UID, "" for a free slot
+    uint8_t track;         // Index in the linked playlist (0 for a single song)
+    uint32_t linkHash;     // Hash of the linked song/folder; a relink resets
+    uint32_t positionMs;
+};
+
 class Storage {
 public:
     Storage();
     
     // SD Card Management
     bool begin();
+    void loop();  // Core 0: flushes coalesced writes
     bool isMounted() { return _mounted; }
     
     // Music File Management
     std::vector<String> listMusicFiles();
     bool deleteMusicFile(const String& filename);
+    bool refreshMusicFile(const String& filename);  // After an upload
+    bool installMusicFile(const String& tempPath, const String& filename);  // Rename a finished upload into place
+    MusicCatalog& getCatalog() { return _catalog; }
     bool musicFileExists(const String& filename);
     String getMusicPath(const String& filename);
+    bool getPlaylist(const char* name, Playlist& playlist);  // false if there is nothing to play
     
     // NFC Links Management
+    // Links change on the web server task while taps read them on the loop
+    // task; lookups copy the path out under the storage lock.
     bool loadNFCLinks();
-    bool saveNFCLinks();
-    bool linkNFC(const String& uid, const String& songPath);
-    bool unlinkNFC(const String& uid);
-    String getSongForNFC(const String& uid);
+    bool saveNFCLinks();  // Full snapshot; linkNFC/unlinkNFC only append
+    bool linkNFC(const TagUid& uid, const String& songPath);
+    bool unlinkNFC(const TagUid& uid);
+    bool getSongForNFC(const TagUid& uid, char* songPath, size_t songPathLen);  // false if not linked
     std::vector<NFCLink> getAllLinks();
+    // Cursor-style iteration for streaming lists; start with cursor = 0
+    bool nextLink(size_t& cursor, char* uid, char* songPath, size_t songPathLen);
     
+    // Playback positions (resume per tag)
+    // setPosition() only updates memory; dirty records are written to SD at
+    // most every POSITION_FLUSH_INTERVAL, or on flushPositions(true). Safe to
+    // call from any task: the web server clears positions while the loop
+    // task saves them.
+    void setPosition(const TagUid& uid, const char* link, uint8_t track, uint32_t positionMs);
+    bool getPosition(const TagUid& uid, const char* link, uint8_t& track, uint32_t& positionMs);
+    void clearPosition(const TagUid& uid);
+    bool flushPositions(bool force = false);
+
 private:
+    // Held for the scope; taken before the SD bus, never after it.
+    // Recursive, so locked methods can call each other.
+    class Lock {
+    public:
+        explicit Lock(Storage& storage) : _storage(storage) {
+            xSemaphoreTakeRecursive(_storage._lock, portMAX_DELAY);
+        }
+        ~Lock() { xSemaphoreGiveRecursive(_storage._lock); }
+        
+        Lock(const Lock&) = delete;
+        Lock& operator=(const Lock&) = delete;
+    
+    private:
+        Storage& _storage;
+    };
+    
+    SemaphoreHandle_t _lock;  // Guards the link table and the in-memory positions
     bool _mounted;
-    std::vector<NFCLink> _nfcLinks;
+    MusicCatalog _catalog;
+    NfcLinkTable _nfcLinks;
+    LinkJournal _linkJournal;
+    
+    std::vector<PositionRecord> _positions;  // Index == slot in POSITIONS_FILE
+    std::vector<bool> _positionDirty;
+    bool _positionsDirty;
+    unsigned long _lastPositionFlush;
+    
+    bool migrateJsonLinks();
+    bool loadPositions();
+    int findPosition(const TagUid& uid);  // Caller holds _lock
     
     void ensureMusicDirectory();
-    String uidToString(const uint8_t* uid, uint8_t length);
 };
 
 extern Storage storage;
@@ -0,0 +1,31 @@
+#ifndef TAG_UID_H
+#define TAG_UID_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+
+// Tag UID packed as raw bytes (4 or 7 for ISO14443A).
+// Plain value type: copying, comparing and hashing never allocate. Hex is
+// only for the edges (serial log, web API, positions file).
+struct TagUid {
+    static const size_t HEX_SIZE = NFC_UID_MAX_LENGTH * 2 + 1;
+    
+    uint8_t length;  // 0 = no tag
+    uint8_t bytes[NFC_UID_MAX_LENGTH];
+    
+    static TagUid fromBytes(const uint8_t* bytes, uint8_t length);
+    // Parse "04A1B2C3D4E5F6" style UIDs (either case)
+    static bool fromHex(const char* hex, TagUid& uid);
+    // out must hold HEX_SIZE chars; upper case, "" for an empty UID
+    void toHex(char* out) const;
+    
+    bool isEmpty() const { return length == 0; }
+    void clear();
+    uint32_t hash() const;
+    
+    bool operator==(const TagUid& other) const;
+    bool operator!=(const TagUid& other) const { return !(*this == other); }
+};
+
+#endif // TAG_UID_H
@@ -0,0 +1,45 @@
+#ifndef TAP_BENCH_H
+#define TAP_BENCH_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "tap_latency.h"
+
+// Tap-to-first-sample benchmark (builds with TAP_BENCH_TAPS > 0).
+//
+// With a linked tag resting on the reader, the main loop replays the tap
+// TAP_BENCH_TAPS times: stop playback, let the box settle, have the NFC
+// task report the tag again and wait for the first I2S write. The first
+// tap is a warm-up and is not counted. At the end it prints p50/p95/p99
+// per stage and checks p95 against each stage's budget. In the native
+// build the program then exits with 0 (pass) or 1 (fail).
+class TapBench {
+public:
+    TapBench();
+    
+    bool begin(uint16_t taps);
+    void loop();  // Main loop, instead of the normal tap report
+    bool isRunning() { return _phase != IDLE; }
+
+private:
+    enum Phase {
+        IDLE,
+        WARM_UP,   // Waiting for the tag to be placed and played once
+        SETTLING,  // Playback stopping before the next tap
+        TAPPING    // Tap requested, waiting for its trace
+    };
+    
+    Phase _phase;
+    uint16_t _taps;
+    uint16_t _done;
+    uint32_t* _samples;  // _taps rows of TAP_STAGE_COUNT + 1 (total)
+    unsigned long _phaseStart;
+    
+    void settle();
+    void finish(bool completed);
+    static uint32_t percentile(uint32_t* values, uint16_t count, uint8_t pct);
+};
+
+extern TapBench tapBench;
+
+#endif // TAP_BENCH_H
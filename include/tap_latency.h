@@ -0,0 +1,72 @@
+#ifndef TAP_LATENCY_H
+#define TAP_LATENCY_H
+
+#include <Arduino.h>
+
+// Stages of the path from a tag on the reader to the first sample in the
+// I2S DMA ring, in the order they happen. Each stage ends at its mark.
+enum TapStage : uint8_t {
+    TAP_PN532,            // NFC task: IRQ edge (or poll) until the UID is read
+    TAP_HANDOFF,          // NFC task -> main loop
+    TAP_UID_HEX,          // UID formatted for the log
+    TAP_LINK_LOOKUP,      // storage.getSongForNFC()
+    TAP_PLAYLIST,         // storage.getPlaylist(): the song exists (catalog)
+    TAP_RESUME_LOOKUP,    // Position saved for this tag
+    TAP_COMMAND,          // Play command posted -> picked up by the audio task
+    TAP_FILE_OPEN,        // AudioFileSourceSD open
+    TAP_BUFFER_PRIME,     // First chunk into the read-ahead buffer
+    TAP_ID3_SKIP,         // First bytes past the ID3 tag reach the decoder
+    TAP_FIRST_FRAME,      // First decoded sample
+    TAP_FIRST_I2S_WRITE,  // First samples handed to the DMA ring
+    TAP_STAGE_COUNT
+};
+
+struct TapTrace {
+    uint32_t stageMicros[TAP_STAGE_COUNT];  // Time spent in each stage (0: not reached)
+    uint32_t totalMicros;                   // Tap to first I2S write
+};
+
+// Timestamps one tag tap at a time across the NFC task, the main loop and
+// the audio task. The NFC task starts a trace, every stage marks its end,
+// and the first I2S write completes it. Outside a trace mark() is a single
+// load, so the marks stay in the production firmware.
+//
+// The stages run one after another, each handing over to the next task
+// through a queue or notification, so the marks need no lock.
+class TapLatency {
+public:
+    TapLatency();
+    
+    // NFC task: a tag was read; originMicros is when the PN532 saw it
+    void start(uint32_t originMicros);
+    
+    void mark(TapStage stage) {
+        if (_active && !(_reached & (1UL << stage))) {
+            record(stage);
+        }
+    }
+    
+    // The tap did not start playback (pause/resume, no link, error)
+    void cancel() { _active = false; }
+    
+    // Main loop: the last completed trace, once
+    bool takeTrace(TapTrace& trace);
+    
+    static const char* stageName(TapStage stage);
+
+private:
+    volatile bool _active;
+    volatile uint32_t _reached;  // Bit per stage already marked
+    uint32_t _origin;
+    uint32_t _marks[TAP_STAGE_COUNT];
+    
+    // Completed trace, waiting for the main loop
+    TapTrace _trace;
+    volatile bool _traceReady;
+    
+    void record(TapStage stage);
+};
+
+extern TapLatency tapLatency;
+
+#endif // TAP_LATENCY_H
@@ -0,0 +1,67 @@
+#ifndef TRACK_CHAIN_SOURCE_H
+#define TRACK_CHAIN_SOURCE_H
+
+#include "AudioFileSource.h"
+#include "tap_latency.h"
+
+// Presents consecutive tracks to the decoder as one continuous stream.
+// When the current source hits end of file the owner is asked for the next
+// one, so the decoder keeps running across the track boundary instead of
+// being stopped and restarted.
+class TrackChainSource : public AudioFileSource {
+public:
+    typedef AudioFileSource* (*NextTrackFn)(void* context);
+    
+    TrackChainSource() : _current(nullptr), _onEnd(nullptr), _context(nullptr) {}
+    
+    void setNextTrackCallback(NextTrackFn onEnd, void* context) {
+        _onEnd = onEnd;
+        _context = context;
+    }
+    
+    void setSource(AudioFileSource* source) { _current = source; }
+    AudioFileSource* getSource() { return _current; }
+    
+    virtual uint32_t read(void* data, uint32_t len) override {
+        if (!_current) {
+            return 0;
+        }
+        uint32_t bytes = _current->read(data, len);
+        while (bytes == 0 && _onEnd) {
+            AudioFileSource* next = _onEnd(_context);
+            if (!next) {
+                break;
+            }
+            _current = next;
+            bytes = _current->read(data, len);
+        }
+        // The first bytes of a track come out of the ID3 filter once the
+        // tag has been skipped
+        if (bytes > 0) {
+            tapLatency.mark(TAP_ID3_SKIP);
+        }
+        return bytes;
+    }
+    
+    virtual uint32_t readNonBlock(void* data, uint32_t len) override {
+        return _current ? _current->readNonBlock(data, len) : 0;
+    }
+    
+    virtual bool seek(int32_t pos, int dir) override {
+        return _current ? _current->seek(pos, dir) : false;
+    }
+    
+    // The slots behind the chain are owned and closed by AudioPlayer
+    virtual bool close() override { return true; }
+    virtual bool isOpen() override { return _current && _current->isOpen(); }
+    virtual uint32_t getSize() override { return _current ? _current->getSize() : 0; }
+    virtual uint32_t getPos() override { return _current ? _current->getPos() : 0; }
+    virtual bool loop() override { return _current ? _current->loop() : true; }
+    
+private:
+    AudioFileSource* _current;
+    NextTrackFn _onEnd;
+    void* _context;
+};
+
+#endif // TRACK_CHAIN_SOURCE_H
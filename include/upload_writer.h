@@ -0,0 +1,108 @@
+#ifndef UPLOAD_WRITER_H
+#define UPLOAD_WRITER_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "config.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <atomic>
+
+struct UploadStats {
+    uint32_t bytes;
+    uint32_t elapsedMs;
+    uint32_t stalls;      // Times the SD writer fell behind and the data was refused
+    uint32_t underruns;   // Playback underruns while the upload ran
+    bool ok;
+};
+
+// Moves upload data from the AsyncTCP task to the SD card without making
+// TCP wait on every write. Segments (~1.4 KB each) are copied into
+// UPLOAD_BLOCK_SIZE blocks; full blocks go to a low-priority writer task that
+// writes them in one call, so FatFs sees whole multi-sector writes instead of
+// a partial-sector write per segment.
+//
+// Nothing here waits on the AsyncTCP task: its watchdog fires after 5 s, and
+// the writer can spend longer than that on the bus while playback needs it.
+// When every block of an upload is queued for the card, write() refuses the
+// data and hasStalled() says so; the server answers 503 and the client
+// resumes from what reached the card. finish() and abort() only queue the
+// close: the writer task writes what is left, closes the file, installs or
+// deletes it, and then isBusy() turns false.
+//
+// One UploadWriter per upload in progress; they share the writer task.
+// Blocks are allocated while an upload runs only, in DMA-capable internal
+// RAM: the SD driver can't DMA from PSRAM and would fall back to copying one
+// sector at a time.
+class UploadWriter {
+public:
+    UploadWriter();
+
+    static bool begin();  // Starts the shared writer task
+
+    // Producer side (AsyncTCP task). offset > 0 continues an existing file
+    // from that byte instead of truncating it. keep: leave what was written
+    // on the card if the upload fails, so it can be resumed.
+    bool open(const char* path, uint32_t offset = 0, bool keep = true);
+    bool write(const uint8_t* data, size_t len);  // false: failed, or hasStalled()
+    // Writes what is buffered and closes; with installAs, a file written
+    // without errors then becomes that song in /music
+    void finish(const char* installAs = nullptr);
+    void abort();  // Closes, dropping what is still buffered
+
+    bool isActive() { return _active; }   // Taking write()s
+    bool isBusy() { return _busy.load(std::memory_order_acquire); }  // Until the writer task has closed the file
+    bool hasStalled() { return _stalled; }
+    const char* getPath() { return _path; }
+    UploadStats getStats() { return _stats; }  // Final once isBusy() is false
+
+    static UploadStats getLastStats();  // The upload closed most recently
+
+private:
+    struct Block {
+        uint8_t* data;
+        size_t length;
+    };
+
+    // What the writer task receives: a full block, or index CLOSE_FILE
+    struct Message {
+        UploadWriter* writer;
+        uint8_t index;
+    };
+    static const uint8_t CLOSE_FILE = 0xFF;
+
+    static QueueHandle_t _fullBlocks;  // Messages from every open upload
+
+    Block _blocks[UPLOAD_BLOCK_COUNT];
+    uint8_t _blockCount;
+    int _filling;                 // Block being filled by write(), -1 if none
+    QueueHandle_t _freeBlocks;    // Block indexes ready to fill
+
+    File _file;
+    char _path[AUDIO_MAX_PATH_LENGTH + sizeof(UPLOAD_PART_SUFFIX)];
+    char _installAs[MAX_FILENAME_LENGTH];  // "" to leave the file where it is
+    bool _keep;
+    bool _active;
+    bool _stalled;
+    volatile bool _failed;
+    std::atomic<bool> _busy;  // Cleared by the writer task, after _stats
+
+    unsigned long _startMs;
+    uint32_t _startUnderruns;
+    UploadStats _stats;
+
+    static portMUX_TYPE _lastLock;
+    static UploadStats _lastStats;
+
+    bool allocateBlocks();
+    void releaseBlocks();
+    bool takeBlock();
+    void submitBlock();
+    void close();
+
+    static void writerTask(void* param);
+    void writeBlock(uint8_t index);  // Writer task
+    void closeFile();                // Writer task
+};
+
+#endif // UPLOAD_WRITER_H
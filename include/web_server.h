@@ -4,6 +4,8 @@
 #include <Arduino.h>
 #include <ESPAsyncWebServer.h>
 #include <AsyncTCP.h>
+#include "upload_writer.h"
+#include "config.h"
 
 class WebServerManager {
 public:
@@ -14,8 +16,24 @@ public:
     
 private:
     AsyncWebServer* _server;
+    AsyncEventSource* _events;  // Pushes "status" and "tag" events to the UI
+    uint32_t _lastStatusVersion;
     String _linkRequestBody;  // Buffer for POST body
     
+    // One per upload in flight, found again by its request. async_tcp only,
+    // apart from writer.isBusy().
+    struct UploadSlot {
+        AsyncWebServerRequest* request;  // nullptr when free
+        UploadWriter writer;             // Writes <name>.part
+        char name[MAX_FILENAME_LENGTH];
+        bool resumable;     // PUT: keep the .part file if the client goes away
+        uint32_t total;     // Final file size
+        uint32_t end;       // Offset just past this request's data
+        uint32_t received;  // Bytes of the file sent so far (on the card once the writer is done)
+        int error;          // HTTP status to answer with, 0 while all is well
+    };
+    UploadSlot _uploads[UPLOAD_MAX_CONCURRENT];
+    
     // Route handlers
     void setupRoutes();
     
@@ -24,6 +42,19 @@ private:
     void handleDeleteSong(AsyncWebServerRequest* request);
     void handleUploadSong(AsyncWebServerRequest* request, String filename, 
                          size_t index, uint8_t* data, size_t len, bool final);
+    void handleUploadDone(AsyncWebServerRequest* request);
+    void handlePutSong(AsyncWebServerRequest* request);
+    void handlePutSongBody(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total);
+    UploadSlot* beginPut(AsyncWebServerRequest* request, size_t length);
+    void handleStreamSong(AsyncWebServerRequest* request);
+    
+    // Upload bookkeeping
+    UploadSlot* claimUpload(AsyncWebServerRequest* request, const String& name);
+    UploadSlot* findUpload(AsyncWebServerRequest* request);
+    UploadSlot* findUpload(const String& name);  // Still receiving or being written
+    void releaseUpload(UploadSlot* slot);
+    void finishUpload(UploadSlot* slot);
+    bool writeUpload(UploadSlot* slot, uint8_t* data, size_t len);
     
     // API endpoints - NFC Tags
     void handleListTags(AsyncWebServerRequest* request);
@@ -32,8 +63,12 @@ private:
     void handleUnlinkTag(AsyncWebServerRequest* request);
     void handleScanTag(AsyncWebServerRequest* request);
     
-    // API endpoints - Status
+    // API endpoints - Status / Playback
     void handleStatus(AsyncWebServerRequest* request);
+    String buildStatusJson();
+    void publishEvents();
+    void handleSeek(AsyncWebServerRequest* request);
+    void handleMetrics(AsyncWebServerRequest* request);
     
     // Static files
     void handleRoot(AsyncWebServerRequest* request);
@@ -0,0 +1,305 @@
+// Generated by tools/embed_web_ui.py from web/index.html - do not edit
+#ifndef WEB_UI_H
+#define WEB_UI_H
+
+#include <Arduino.h>
+
+#define WEB_UI_ETAG "\"ba080600\""
+#define WEB_UI_GZ_LENGTH 4670  // 18836 bytes uncompressed
+
+const uint8_t WEB_UI_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xdd, 0x5c, 0xdd, 0x6e, 0xdc, 0x48,
+    0x76, 0xbe, 0xd7, 0x53, 0x94, 0x7b, 0xc6, 0x43, 0xf6, 0xb8, 0xff, 0xd4, 0xb2, 0x3c, 0xe3, 0x6e,
+    0xb5, 0x16, 0x1e, 0x49, 0xb3, 0x76, 0x22, 0xd9, 0x82, 0x25, 0x6d, 0xb2, 0x58, 0x2c, 0x76, 0xaa,
+    0xc9, 0x6a, 0x35, 0xc7, 0x6c, 0x16, 0x43, 0x16, 0x25, 0x6b, 0x34, 0x0d, 0xe4, 0x26, 0x7b, 0xb7,
+    0xbb, 0xc0, 0x26, 0x37, 0x01, 0x02, 0xe4, 0x3e, 0xb7, 0x41, 0x90, 0xdc, 0x05, 0x48, 0xde, 0x64,
+    0x5f, 0x20, 0x79, 0x84, 0x9c, 0x53, 0x45, 0xb2, 0xc9, 0x62, 0x91, 0x4d, 0xd9, 0xde, 0x5d, 0x20,
+    0xb2, 0x61, 0x75, 0x37, 0x4f, 0x9d, 0x3a, 0x75, 0x7e, 0xbf, 0x3a, 0x55, 0xed, 0x83, 0x47, 0xc7,
+    0x6f, 0x8e, 0x2e, 0x7f, 0x7e, 0x7e, 0x42, 0x96, 0x62, 0xe5, 0x1f, 0xee, 0x1c, 0xe0, 0x2f, 0xe2,
+    0xd3, 0xe0, 0x7a, 0xd6, 0x61, 0x71, 0x07, 0x3f, 0x60, 0xd4, 0x3d, 0xdc, 0x21, 0xf0, 0x73, 0xb0,
+    0x62, 0x82, 0x12, 0x67, 0x49, 0xa3, 0x98, 0x89, 0x59, 0xe7, 0xea, 0xf2, 0xdb, 0xfe, 0xd7, 0x9d,
+    0xe2, 0xa3, 0x80, 0xae, 0xd8, 0xac, 0x73, 0xe3, 0xb1, 0xdb, 0x90, 0x47, 0xa2, 0x43, 0x1c, 0x1e,
+    0x08, 0x16, 0x00, 0xe9, 0xad, 0xe7, 0x8a, 0xe5, 0xcc, 0x65, 0x37, 0x9e, 0xc3, 0xfa, 0xf2, 0x4d,
+    0x8f, 0x78, 0x81, 0x27, 0x3c, 0xea, 0xf7, 0x63, 0x87, 0xfa, 0x6c, 0xb6, 0x3b, 0x18, 0x65, 0xac,
+    0x84, 0x27, 0x7c, 0x76, 0x78, 0x96, 0xc4, 0x9e, 0xf3, 0x0d, 0x7f, 0x4f, 0xfa, 0xe4, 0x88, 0x07,
+    0x0b, 0xef, 0x3a, 0x89, 0xa8, 0xe3, 0xfd, 0xf7, 0xbf, 0x06, 0x07, 0x43, 0x45, 0xa0, 0x88, 0x63,
+    0x71, 0x97, 0xbd, 0xc6, 0x9f, 0x2f, 0xc9, 0x3d, 0x59, 0xd1, 0xe8, 0xda, 0x0b, 0x26, 0x64, 0x34,
+    0x25, 0x21, 0x75, 0x5d, 0x2f, 0xb8, 0x96, 0xaf, 0xe7, 0xfc, 0x7d, 0x3f, 0xf6, 0x7e, 0x90, 0x6f,
+    0xe7, 0x3c, 0x72, 0x59, 0xd4, 0x87, 0x8f, 0xa6, 0x64, 0x9d, 0x0f, 0x9e, 0x73, 0xf7, 0x0e, 0xc6,
+    0xe7, 0xef, 0xf1, 0x67, 0x01, 0x4b, 0xe8, 0x2f, 0xe8, 0xca, 0xf3, 0xef, 0x26, 0xc4, 0xba, 0x60,
+    0xd7, 0x9c, 0x91, 0xab, 0x57, 0x56, 0x8f, 0x5c, 0xd2, 0x25, 0x5f, 0xd1, 0x1e, 0xf9, 0x29, 0x0b,
+    0xd8, 0x0d, 0xfc, 0xfe, 0x19, 0x8b, 0x5c, 0x1a, 0xc0, 0x8b, 0x98, 0x06, 0x71, 0x3f, 0x66, 0x91,
+    0xb7, 0x98, 0x96, 0x38, 0xcd, 0xa9, 0xf3, 0xee, 0x3a, 0xe2, 0x49, 0xe0, 0x4e, 0x88, 0xef, 0x05,
+    0x8c, 0x46, 0xfd, 0xeb, 0x88, 0xba, 0x1e, 0x28, 0xc8, 0xde, 0xdd, 0xdb, 0x77, 0xd9, 0x75, 0x8f,
+    0x7c, 0xf6, 0xec, 0xd9, 0x57, 0x8c, 0x51, 0x32, 0x7a, 0x0c, 0xaf, 0xbf, 0x7a, 0xf6, 0x74, 0x4e,
+    0xc7, 0x64, 0x77, 0x34, 0x7a, 0xdc, 0x2d, 0xb3, 0x72, 0xb8, 0xcf, 0xa3, 0x09, 0xf9, 0x6c, 0x6f,
+    0x6f, 0xaf, 0xfc, 0x60, 0xe5, 0x05, 0xfd, 0x25, 0xf3, 0xae, 0x97, 0x62, 0x82, 0xe3, 0x6e, 0x96,
+    0xe5, 0xc7, 0xb9, 0x3a, 0xc6, 0xa3, 0xf0, 0xfd, 0xe6, 0xd1, 0x46, 0x03, 0x03, 0xb4, 0x18, 0x05,
+    0xe1, 0x22, 0x72, 0x5f, 0x66, 0x4c, 0xdf, 0x2b, 0xbb, 0x01, 0xdf, 0xf1, 0xa8, 0x34, 0x5a, 0x3d,
+    0x4e, 0x55, 0x4e, 0x68, 0x22, 0x78, 0xfd, 0xba, 0x6f, 0x97, 0x9e, 0x60, 0xda, 0x63, 0x65, 0x0a,
+    0xd4, 0x44, 0x12, 0x03, 0xf7, 0x7d, 0x9d, 0xb7, 0xb4, 0xdb, 0x92, 0xba, 0xfc, 0x16, 0xf9, 0xef,
+    0xc2, 0xdc, 0xe4, 0x29, 0xfe, 0x13, 0x5d, 0xcf, 0xa9, 0x3d, 0xea, 0xc9, 0x3f, 0x83, 0xb1, 0xa6,
+    0x21, 0x7e, 0xc3, 0xa2, 0x85, 0x8f, 0x43, 0x96, 0x9e, 0xeb, 0xb2, 0xc0, 0xb8, 0x58, 0xf4, 0xec,
+    0xca, 0x4a, 0x3f, 0xbd, 0x99, 0x0c, 0x8b, 0xce, 0x0d, 0xb1, 0x57, 0x51, 0xa5, 0x60, 0xef, 0x45,
+    0x9f, 0xfa, 0xde, 0x35, 0xa8, 0xd3, 0x81, 0x49, 0x59, 0xd4, 0x24, 0xfb, 0x72, 0x17, 0x1c, 0x56,
+    0xfa, 0x28, 0xb8, 0x36, 0x03, 0xc3, 0x0e, 0xf6, 0xd9, 0x6a, 0x9a, 0xda, 0x03, 0xfc, 0x5b, 0x08,
+    0xbe, 0x9a, 0x48, 0xa5, 0x4d, 0x0d, 0xa3, 0x43, 0x18, 0xcc, 0x43, 0x08, 0x2b, 0x01, 0xce, 0x3d,
+    0x1a, 0x3c, 0x9f, 0xea, 0xae, 0x00, 0xf3, 0x03, 0x49, 0x59, 0xda, 0x22, 0x4d, 0xcc, 0x1c, 0xe1,
+    0xf1, 0xa0, 0xe2, 0x2c, 0xa5, 0xd9, 0x9f, 0x56, 0xd6, 0x58, 0xe3, 0x87, 0xba, 0xfa, 0x3f, 0x5b,
+    0x7c, 0xbd, 0x78, 0xbe, 0xa0, 0xcd, 0xfe, 0x52, 0xe7, 0xc9, 0x99, 0x68, 0xcb, 0xb1, 0x26, 0x5d,
+    0x16, 0x3c, 0xca, 0x86, 0xd3, 0x26, 0xc9, 0xc7, 0x75, 0x92, 0x97, 0x35, 0x6b, 0x92, 0x2f, 0x67,
+    0x01, 0x9e, 0x1a, 0x73, 0xdf, 0x73, 0xab, 0x13, 0x16, 0x84, 0x9d, 0x8b, 0xa0, 0xc1, 0x0d, 0x8d,
+    0xa2, 0xd6, 0x3b, 0x97, 0x92, 0x60, 0x42, 0x02, 0x1e, 0xd4, 0xb9, 0xdd, 0x2e, 0x8a, 0x35, 0x7e,
+    0x5a, 0x23, 0x7b, 0xa6, 0xdb, 0x67, 0xfa, 0x73, 0x27, 0x89, 0x62, 0x9c, 0x34, 0xe4, 0x5e, 0xd9,
+    0x31, 0xf3, 0x4c, 0xa9, 0xbc, 0x70, 0xb7, 0x32, 0x52, 0x44, 0x90, 0x15, 0x3d, 0x34, 0xc8, 0x84,
+    0x50, 0xdf, 0x07, 0x67, 0xdb, 0x8b, 0xeb, 0x34, 0x31, 0x59, 0x62, 0xf4, 0x82, 0xdf, 0x95, 0x74,
+    0xb0, 0xbf, 0xff, 0xec, 0x6b, 0x77, 0x6f, 0xaa, 0x38, 0x2d, 0x78, 0x04, 0xba, 0x95, 0x2f, 0x7d,
+    0x2a, 0xd8, 0xcf, 0xed, 0x3e, 0x2c, 0xa8, 0x3b, 0xd5, 0x18, 0xf5, 0x21, 0x21, 0x5f, 0x57, 0x39,
+    0xb1, 0xaf, 0x9e, 0x3a, 0x7b, 0x4e, 0x0d, 0xb1, 0x79, 0x72, 0x67, 0xb4, 0xf7, 0x7c, 0x3c, 0x2f,
+    0x0d, 0x59, 0x78, 0x3e, 0xeb, 0x7b, 0x41, 0x98, 0x08, 0xdd, 0x72, 0xa9, 0xfa, 0x51, 0xc5, 0x2e,
+    0x8d, 0x97, 0xcc, 0x35, 0x1b, 0xb0, 0x29, 0x08, 0xca, 0x76, 0xf8, 0xfa, 0x21, 0x39, 0x62, 0xab,
+    0x9d, 0x5a, 0x9b, 0x62, 0xb3, 0x42, 0xb3, 0x52, 0x16, 0x23, 0xfc, 0x53, 0x52, 0x8a, 0xef, 0xc5,
+    0xa2, 0x0f, 0x0e, 0xb9, 0x6a, 0xf0, 0xe6, 0xa6, 0x74, 0x58, 0xcd, 0xfe, 0x59, 0x65, 0x91, 0x79,
+    0x7f, 0xf4, 0x30, 0x35, 0xb9, 0x5e, 0x1c, 0xfa, 0x14, 0x52, 0xdb, 0xc2, 0x67, 0xda, 0xa3, 0xef,
+    0x93, 0x58, 0x78, 0x8b, 0xbb, 0x7e, 0x9a, 0xe4, 0x26, 0x24, 0x86, 0x34, 0xc8, 0xfa, 0x73, 0x26,
+    0x6e, 0x59, 0xb1, 0x5a, 0xe0, 0x8f, 0x54, 0xb4, 0x5c, 0x55, 0x6c, 0x56, 0x77, 0xb9, 0x42, 0xa1,
+    0xdd, 0xf7, 0xf5, 0xfa, 0xb4, 0xdb, 0x35, 0xaa, 0x38, 0xd7, 0xd7, 0x46, 0xc3, 0x25, 0x5e, 0x10,
+    0xa1, 0x6a, 0xe5, 0x65, 0x66, 0xfb, 0x65, 0x57, 0x8f, 0x05, 0x15, 0x49, 0xac, 0xa9, 0x3c, 0xe4,
+    0x99, 0x91, 0x17, 0xde, 0x7b, 0xe6, 0x6a, 0x3e, 0xc0, 0x43, 0x93, 0xdf, 0x45, 0x0a, 0x39, 0x34,
+    0x67, 0xe5, 0x6d, 0xf6, 0xfb, 0x00, 0x7f, 0x6e, 0xb3, 0x68, 0xbd, 0xc2, 0x17, 0x10, 0xc9, 0xde,
+    0xa8, 0xb6, 0x08, 0x48, 0xcd, 0xf4, 0xd1, 0x0b, 0x40, 0x3e, 0x50, 0x6f, 0x96, 0xfc, 0xc7, 0x5f,
+    0x51, 0xf6, 0x0c, 0x7c, 0x57, 0x26, 0xad, 0xdb, 0x14, 0x31, 0xcd, 0xb9, 0xef, 0x4e, 0x4d, 0xc3,
+    0x69, 0x12, 0x43, 0x14, 0x6f, 0x46, 0x2f, 0xf6, 0x9e, 0x3b, 0xbb, 0xe3, 0x6d, 0xa3, 0x57, 0xdc,
+    0xa5, 0xbe, 0x66, 0x95, 0xdc, 0x25, 0x0d, 0xc9, 0xb9, 0xc9, 0x60, 0x3f, 0x40, 0x20, 0xba, 0xec,
+    0xbd, 0x44, 0x75, 0x5a, 0x14, 0xf8, 0x6c, 0x21, 0x26, 0x7a, 0x68, 0x48, 0x03, 0x6b, 0x9f, 0x65,
+    0xf8, 0x0d, 0x80, 0x4a, 0xf9, 0x41, 0x01, 0x31, 0x3e, 0xae, 0xb7, 0x7b, 0xc9, 0x1a, 0xfb, 0x66,
+    0x7f, 0x96, 0x4b, 0xee, 0xe7, 0xc8, 0xe1, 0x21, 0x3e, 0xb4, 0x09, 0xf4, 0xc7, 0x06, 0x10, 0xd9,
+    0x00, 0x98, 0x1a, 0x01, 0x81, 0xe6, 0x29, 0xfb, 0xa3, 0xd1, 0x07, 0xc1, 0xcb, 0x3d, 0xf3, 0x72,
+    0x1d, 0x9f, 0xc7, 0x4c, 0x5b, 0x26, 0xa0, 0x4e, 0x0a, 0xba, 0x94, 0xa1, 0x54, 0x5b, 0x20, 0xc7,
+    0x95, 0x10, 0xa8, 0xba, 0x52, 0xbb, 0x8c, 0xae, 0x4b, 0x93, 0x27, 0x92, 0xcc, 0x57, 0xab, 0xd5,
+    0x4e, 0xa6, 0xf4, 0x5f, 0x88, 0xbb, 0x10, 0xf6, 0x6a, 0x58, 0x49, 0x3a, 0xbf, 0x84, 0x4d, 0x0b,
+    0xf3, 0x01, 0x2f, 0x69, 0x4b, 0xa9, 0x75, 0x98, 0x12, 0x8e, 0x78, 0x68, 0xbe, 0x2e, 0x61, 0x22,
+    0xd7, 0x75, 0x1f, 0x06, 0x41, 0x6a, 0x51, 0x46, 0xd3, 0xfa, 0x26, 0x0b, 0xee, 0x24, 0x71, 0xb6,
+    0x4a, 0xf5, 0x4e, 0x5b, 0x2b, 0x4f, 0x04, 0xa2, 0x7d, 0x53, 0x60, 0xa6, 0x22, 0xd5, 0xe1, 0xc6,
+    0x82, 0x05, 0xc2, 0x88, 0x5f, 0x47, 0x2c, 0x8e, 0xdb, 0xea, 0x31, 0x0b, 0xbc, 0xbd, 0x2d, 0x30,
+    0x58, 0x15, 0xda, 0x87, 0x6d, 0x9b, 0xea, 0x77, 0x40, 0x4d, 0x66, 0x32, 0x2c, 0xa6, 0x3f, 0xa7,
+    0xfa, 0x1e, 0xa9, 0x5d, 0xc2, 0xd0, 0x77, 0x4f, 0xcf, 0x47, 0xc5, 0xcd, 0x53, 0xbe, 0x73, 0xea,
+    0xd6, 0xc3, 0x13, 0xa9, 0x38, 0x0d, 0xa0, 0x6c, 0x29, 0xec, 0x5b, 0x8b, 0x75, 0xa5, 0xf2, 0x1b,
+    0x01, 0x54, 0x2d, 0xb8, 0x6e, 0x88, 0x53, 0xa5, 0xbb, 0x83, 0x61, 0xda, 0x92, 0x38, 0x18, 0xaa,
+    0xce, 0xc9, 0x01, 0xb6, 0x15, 0xd2, 0x6e, 0x85, 0xeb, 0xdd, 0x10, 0xc7, 0xa7, 0x71, 0x3c, 0xeb,
+    0xe4, 0x3b, 0xed, 0xce, 0xa6, 0x7b, 0x51, 0x7c, 0xae, 0xb6, 0x68, 0x85, 0x87, 0x92, 0x60, 0xb9,
+    0x7b, 0xf8, 0xbf, 0xff, 0xfc, 0xdb, 0x7f, 0x23, 0x59, 0x77, 0x04, 0x26, 0xd9, 0xd5, 0x48, 0xc2,
+    0xc3, 0x72, 0xbf, 0x84, 0xb8, 0xcc, 0x27, 0x6f, 0x19, 0x98, 0xd3, 0x4d, 0x1c, 0xc1, 0x23, 0xf2,
+    0xfa, 0xdb, 0xa3, 0x83, 0x61, 0x58, 0x98, 0x75, 0x08, 0xd3, 0x6e, 0xde, 0x1a, 0xa5, 0x51, 0x95,
+    0xb0, 0x43, 0x3c, 0x37, 0x7f, 0xad, 0x4d, 0x8b, 0x3c, 0x4e, 0xe0, 0x91, 0xcb, 0x27, 0xe4, 0x00,
+    0xd0, 0x54, 0x20, 0x69, 0xd1, 0x4c, 0x2c, 0xba, 0x80, 0x11, 0xac, 0x73, 0x78, 0xcc, 0x40, 0xe3,
+    0x9e, 0xcb, 0x41, 0x45, 0xf0, 0xfc, 0x50, 0x9b, 0x37, 0x9f, 0x12, 0xc7, 0x41, 0xbe, 0x8b, 0xc0,
+    0x2e, 0x17, 0x3c, 0xb8, 0xee, 0xe8, 0x84, 0x6d, 0xe4, 0x4d, 0xad, 0xab, 0x0b, 0xf9, 0xa8, 0xdf,
+    0x27, 0xc8, 0x33, 0x26, 0x17, 0xe9, 0xf6, 0xb0, 0xdf, 0x37, 0x48, 0x90, 0x2d, 0x5a, 0xd1, 0x68,
+    0x4c, 0x94, 0x1d, 0xc6, 0x60, 0x87, 0xbf, 0xff, 0x5b, 0xf2, 0x53, 0x06, 0xde, 0xa4, 0x94, 0x4c,
+    0x8e, 0x68, 0xe0, 0x00, 0x39, 0x8b, 0xc1, 0x28, 0x63, 0xc3, 0x98, 0x02, 0xe7, 0x0d, 0xb4, 0xee,
+    0x10, 0x1e, 0x38, 0xbe, 0xe7, 0xbc, 0x9b, 0x75, 0x5c, 0x48, 0x4b, 0x2b, 0x10, 0x7a, 0x70, 0xcd,
+    0xc4, 0x89, 0xcf, 0xf0, 0xe5, 0x37, 0x77, 0xaf, 0x5c, 0xdb, 0x42, 0xea, 0x57, 0x48, 0x6c, 0x75,
+    0x07, 0x92, 0xd6, 0xee, 0x1a, 0x64, 0x4a, 0x8d, 0xff, 0x92, 0xfe, 0x40, 0x90, 0x08, 0x92, 0x74,
+    0x44, 0x49, 0x9c, 0xcc, 0xbd, 0x88, 0x24, 0x01, 0x25, 0x0e, 0x4a, 0x87, 0x92, 0x9e, 0x9d, 0xef,
+    0x95, 0xcc, 0x5f, 0x1a, 0xaf, 0x36, 0x34, 0x2a, 0x77, 0xe2, 0xb4, 0xca, 0xe2, 0xb9, 0x00, 0x1d,
+    0x42, 0x1d, 0x87, 0x85, 0x62, 0xd6, 0x19, 0xac, 0xc2, 0xbd, 0x0e, 0x91, 0xae, 0x0e, 0x92, 0xa7,
+    0xf1, 0x88, 0xb9, 0xd3, 0xa4, 0xad, 0xaa, 0xa1, 0x4b, 0xc6, 0x4e, 0x42, 0xa8, 0x99, 0xee, 0x79,
+    0x9a, 0x6f, 0x8c, 0x5c, 0xa7, 0x75, 0x0b, 0x2e, 0x28, 0x35, 0x4b, 0x58, 0x35, 0xa4, 0x75, 0xe4,
+    0x98, 0xdf, 0xd4, 0x32, 0xb3, 0x4f, 0xbe, 0x81, 0x0f, 0x0e, 0x47, 0x8f, 0x6b, 0xc4, 0x6e, 0x5a,
+    0x51, 0xcd, 0xc7, 0x34, 0x71, 0x3d, 0xae, 0x62, 0x07, 0x9c, 0xef, 0x3c, 0x62, 0xd8, 0x22, 0x55,
+    0xed, 0xd1, 0x88, 0xfb, 0x31, 0x09, 0x23, 0x86, 0x1a, 0x98, 0x75, 0xa4, 0x02, 0x8d, 0xeb, 0x4f,
+    0x8b, 0x88, 0xcc, 0xb8, 0x59, 0xf6, 0x4e, 0x93, 0x37, 0x06, 0x88, 0x9c, 0xa1, 0x41, 0xc5, 0x38,
+    0x6f, 0x7c, 0x0a, 0xbb, 0x8d, 0x8e, 0x31, 0xec, 0xaa, 0x1f, 0x55, 0xe3, 0x06, 0xd2, 0x06, 0xb9,
+    0xa4, 0x9f, 0x28, 0x74, 0x7e, 0xf7, 0xef, 0xff, 0xf3, 0x1f, 0xbf, 0x2b, 0x45, 0x8f, 0x64, 0x2d,
+    0x53, 0x93, 0x31, 0x78, 0xe6, 0x89, 0x10, 0x30, 0x67, 0xca, 0x1e, 0xf6, 0xeb, 0x85, 0xc0, 0xe1,
+    0x21, 0x0b, 0x4e, 0xbd, 0xe0, 0xdd, 0x19, 0xa2, 0x4f, 0x8c, 0x8d, 0x9f, 0x79, 0x81, 0x93, 0xf8,
+    0x50, 0xb6, 0x5e, 0x27, 0xec, 0x86, 0x23, 0xeb, 0x83, 0xa1, 0x62, 0xd0, 0xa0, 0x22, 0x41, 0xdb,
+    0x6b, 0xa8, 0xf0, 0xb6, 0xf0, 0x72, 0x27, 0xd7, 0x15, 0x4a, 0x83, 0xd3, 0x12, 0x29, 0x52, 0xae,
+    0xa9, 0x7c, 0x2e, 0x3f, 0x93, 0xb6, 0x93, 0xad, 0x48, 0x22, 0xe7, 0x9a, 0x52, 0x50, 0x42, 0xd5,
+    0x7a, 0x4a, 0x93, 0xa9, 0x36, 0xcb, 0x7a, 0x88, 0x00, 0x0b, 0x8a, 0x91, 0xef, 0x4b, 0x9a, 0xf9,
+    0x42, 0x78, 0x2b, 0x16, 0x4f, 0xd3, 0x0c, 0xbc, 0xa3, 0x1b, 0x26, 0x57, 0x1c, 0xca, 0x6e, 0x34,
+    0xc6, 0x41, 0xa8, 0xfc, 0x09, 0xd2, 0xc9, 0x45, 0x5a, 0x13, 0x52, 0x77, 0xd5, 0xf0, 0x91, 0xa1,
+    0x52, 0x76, 0xc0, 0xf0, 0xff, 0xf0, 0x1b, 0x72, 0x82, 0x83, 0x19, 0x0d, 0x5c, 0x3e, 0x18, 0x0c,
+    0xc8, 0x0b, 0x87, 0x45, 0x0e, 0x25, 0x50, 0xa3, 0x84, 0x9a, 0x13, 0x4a, 0x38, 0x41, 0x98, 0xc6,
+    0xa3, 0x4a, 0x9a, 0x2a, 0xa5, 0x27, 0x09, 0xed, 0x32, 0xcb, 0x5d, 0x79, 0x6e, 0x87, 0x40, 0xb4,
+    0x38, 0x6c, 0x09, 0x33, 0xb1, 0x68, 0xd6, 0xb9, 0x7a, 0x75, 0x2c, 0x2b, 0x1f, 0xac, 0xa4, 0x43,
+    0x22, 0x28, 0xa6, 0x3c, 0xf0, 0xef, 0x32, 0x59, 0x4b, 0x5d, 0xfd, 0x15, 0x0f, 0xb8, 0xdc, 0xfe,
+    0x4f, 0x4b, 0xe8, 0x12, 0xbb, 0x63, 0x15, 0x65, 0x2b, 0x98, 0x9c, 0x45, 0xd4, 0x85, 0x7c, 0x6b,
+    0x72, 0x72, 0x1e, 0xca, 0x10, 0xb9, 0xa1, 0x7e, 0x02, 0xd3, 0x75, 0x0e, 0x25, 0x25, 0x56, 0x07,
+    0x5a, 0x4a, 0xc6, 0x07, 0x43, 0x45, 0xa8, 0x3b, 0x9b, 0x9a, 0x47, 0xfb, 0xb4, 0x29, 0x04, 0xd0,
+    0xa1, 0x60, 0xa5, 0x60, 0xe2, 0x6c, 0x89, 0x69, 0x2b, 0x53, 0x6e, 0x04, 0x25, 0x3a, 0xdc, 0x84,
+    0x45, 0x35, 0x18, 0x9a, 0xfc, 0x39, 0x76, 0x22, 0x2f, 0x2c, 0xc8, 0xe2, 0x33, 0x41, 0xd0, 0x82,
+    0x01, 0xee, 0xa8, 0x67, 0x64, 0x41, 0xfd, 0xb8, 0x80, 0x91, 0xf0, 0x29, 0x08, 0x28, 0x94, 0x73,
+    0xc0, 0xf3, 0x20, 0xf1, 0xfd, 0xf2, 0x63, 0x85, 0x1f, 0xde, 0x32, 0x87, 0x79, 0x37, 0xcc, 0x7d,
+    0x21, 0x80, 0xa8, 0x80, 0x40, 0xf3, 0x17, 0xc3, 0x21, 0x39, 0x85, 0xa4, 0x98, 0x9d, 0x13, 0x11,
+    0x97, 0x0a, 0x9a, 0x3f, 0xcc, 0x6b, 0x25, 0xec, 0x44, 0x4e, 0x6e, 0xe0, 0x05, 0x46, 0x2e, 0x03,
+    0x34, 0x65, 0x5b, 0xc7, 0x6f, 0xce, 0x8e, 0x54, 0xa8, 0xe0, 0x70, 0xe6, 0x5a, 0x3d, 0xb2, 0x48,
+    0x02, 0x99, 0x8e, 0xec, 0xae, 0x06, 0x64, 0x31, 0xeb, 0x4a, 0x3c, 0x60, 0x6b, 0x28, 0x14, 0x1f,
+    0x60, 0x46, 0xd2, 0x3f, 0x4f, 0x42, 0x10, 0x83, 0xa9, 0xc5, 0xd9, 0x95, 0x76, 0x7f, 0x10, 0x80,
+    0xd5, 0xa4, 0x38, 0x95, 0x87, 0xb0, 0x9a, 0x37, 0xe8, 0x80, 0xd4, 0xbd, 0x01, 0xdb, 0xb3, 0x98,
+    0x88, 0x25, 0x03, 0x53, 0x72, 0xe7, 0x1d, 0x18, 0x11, 0xf4, 0x19, 0x61, 0xdb, 0x09, 0x36, 0x1f,
+    0xe0, 0xaa, 0x7f, 0x93, 0x40, 0x5a, 0x8c, 0x4b, 0xa3, 0x63, 0x26, 0x5e, 0x21, 0x4a, 0x05, 0x7f,
+    0xb2, 0x01, 0x17, 0x81, 0x83, 0x9f, 0xa7, 0xdd, 0x82, 0x9e, 0xec, 0x08, 0x14, 0xb7, 0xa7, 0x5d,
+    0xb3, 0x2e, 0x2f, 0x61, 0x3e, 0xd8, 0xeb, 0x92, 0x30, 0x89, 0x97, 0x30, 0x7d, 0xda, 0x33, 0x72,
+    0x96, 0xd8, 0xf5, 0x8c, 0x09, 0x44, 0xa3, 0x8c, 0x3f, 0x17, 0x20, 0x9a, 0x54, 0x15, 0x7c, 0x24,
+    0x65, 0xbc, 0x23, 0x4b, 0x1a, 0x42, 0x7e, 0xcd, 0x59, 0x65, 0xba, 0xd4, 0x97, 0x5b, 0xe9, 0xb2,
+    0x07, 0xb1, 0x20, 0x4c, 0x3e, 0x44, 0x2f, 0x60, 0xb7, 0x44, 0x52, 0x5e, 0xf0, 0x24, 0x72, 0x98,
+    0x6d, 0x0d, 0x69, 0xe8, 0x0d, 0xd5, 0x63, 0x4b, 0x53, 0x95, 0xfa, 0xd4, 0x60, 0x59, 0x25, 0x33,
+    0xd8, 0x93, 0x91, 0xd9, 0x21, 0x51, 0x7a, 0x48, 0x4d, 0xf1, 0x17, 0x17, 0x6f, 0x5e, 0x0f, 0x42,
+    0x3c, 0x98, 0xb4, 0xd9, 0x00, 0x3d, 0xa5, 0xdb, 0x6d, 0xcb, 0x15, 0x96, 0x9d, 0xb1, 0xe4, 0x01,
+    0xd8, 0xfc, 0x02, 0x7d, 0x9b, 0xb9, 0x06, 0x96, 0x83, 0xc4, 0x73, 0x6b, 0xd8, 0x42, 0x89, 0x8e,
+    0x22, 0xc0, 0xd6, 0x33, 0x02, 0xbf, 0x91, 0x15, 0xae, 0x9f, 0xfb, 0x6c, 0x20, 0x3f, 0xb6, 0x2d,
+    0x39, 0x27, 0x28, 0x1d, 0x12, 0xd1, 0x8a, 0xc8, 0xcf, 0x26, 0x38, 0x69, 0x14, 0x19, 0x1b, 0x0b,
+    0x45, 0xbb, 0x7d, 0x0b, 0xd8, 0x8b, 0x28, 0x84, 0x34, 0x21, 0xe7, 0x57, 0x97, 0x10, 0x0f, 0x24,
+    0xf4, 0x20, 0x78, 0x70, 0x3f, 0xcb, 0x09, 0x25, 0x6e, 0xc4, 0xc1, 0x40, 0x6e, 0x66, 0x0f, 0x34,
+    0x0d, 0x80, 0x18, 0x88, 0x8e, 0xb8, 0xc8, 0xe6, 0x76, 0xc9, 0x22, 0x46, 0x3c, 0x94, 0x41, 0x91,
+    0x7b, 0x60, 0x1f, 0xc8, 0x8a, 0x84, 0x2f, 0xd0, 0x17, 0x22, 0x81, 0xd1, 0x8c, 0x7b, 0xc6, 0x9d,
+    0xb2, 0x05, 0xaf, 0xce, 0x4f, 0xdf, 0xbc, 0x38, 0xfe, 0xd5, 0xd1, 0xcb, 0xab, 0xd7, 0x7f, 0x09,
+    0xab, 0xdb, 0x1d, 0x8d, 0x9f, 0x92, 0x2f, 0xe5, 0xaf, 0xa9, 0x99, 0xf2, 0xfc, 0xcd, 0xe9, 0xe9,
+    0xaf, 0xce, 0x2e, 0x80, 0x76, 0x3c, 0x32, 0x85, 0xb5, 0x22, 0x8e, 0x7d, 0xc6, 0x42, 0xa0, 0x59,
+    0xc5, 0xa8, 0x2c, 0xf4, 0x0e, 0x80, 0x7f, 0x2b, 0x0f, 0x74, 0x2d, 0xb5, 0x07, 0xfe, 0x7e, 0x09,
+    0x85, 0x0a, 0x36, 0xe5, 0x76, 0xd4, 0x03, 0xa2, 0xae, 0xc9, 0xa9, 0x73, 0x4f, 0x8c, 0x97, 0xfc,
+    0xf6, 0xaa, 0x84, 0x21, 0xed, 0x10, 0x8a, 0x0a, 0x68, 0x5c, 0xf7, 0xca, 0x5a, 0x88, 0x5d, 0x86,
+    0xa0, 0x80, 0xb3, 0x65, 0x16, 0x1d, 0xa4, 0x10, 0x0c, 0x04, 0xb5, 0xe6, 0x18, 0xab, 0xd6, 0xb4,
+    0x1d, 0xbb, 0x02, 0x92, 0xcc, 0x79, 0xa9, 0xcd, 0xec, 0x8c, 0xa4, 0xa2, 0x91, 0x27, 0xc4, 0x7a,
+    0xfc, 0x61, 0xfc, 0xb0, 0xf2, 0xa5, 0x29, 0x0e, 0xf8, 0x9d, 0x51, 0xb1, 0x1c, 0xc8, 0x2d, 0xf7,
+    0x66, 0xd5, 0x1a, 0xef, 0x75, 0x83, 0xf2, 0xa0, 0xa0, 0x1e, 0x2d, 0x93, 0xe0, 0x9d, 0x9d, 0x44,
+    0x3e, 0x64, 0x4a, 0xf0, 0xb6, 0x9e, 0x72, 0x08, 0x70, 0xcf, 0xc0, 0xd5, 0x15, 0x18, 0x31, 0x91,
+    0x44, 0x41, 0xc9, 0x60, 0x90, 0x90, 0xc0, 0xd3, 0x6f, 0x60, 0x58, 0xc4, 0xbe, 0x07, 0x07, 0xec,
+    0xa2, 0x01, 0xef, 0x2b, 0x25, 0x51, 0xd9, 0xfd, 0xfd, 0x32, 0x4a, 0xb3, 0xc1, 0x5f, 0x9f, 0x9d,
+    0xbe, 0x14, 0x22, 0x7c, 0xab, 0xd2, 0x9d, 0x9e, 0x2e, 0xf1, 0x07, 0x68, 0x07, 0xca, 0x2e, 0x86,
+    0xa8, 0xcd, 0x34, 0x92, 0x85, 0xee, 0xbd, 0x11, 0xa7, 0x1b, 0x3c, 0xc3, 0x96, 0x8b, 0x03, 0x0d,
+    0xb1, 0x81, 0x2f, 0xeb, 0x43, 0x97, 0x0c, 0xe5, 0xb2, 0x07, 0x58, 0xf7, 0xa5, 0x6f, 0x8f, 0x0c,
+    0xc2, 0xac, 0x6b, 0x04, 0xac, 0x4a, 0x86, 0x5c, 0x41, 0x2a, 0xbb, 0x5b, 0x2f, 0x16, 0x56, 0x41,
+    0x79, 0xd9, 0x60, 0x46, 0xee, 0xd7, 0x53, 0x23, 0x89, 0x88, 0xee, 0xe4, 0x69, 0x80, 0x24, 0x2a,
+    0xa4, 0x22, 0x9c, 0x13, 0xd6, 0x11, 0x82, 0x36, 0xd9, 0x25, 0xf8, 0x01, 0x9e, 0x04, 0x00, 0x9c,
+    0x10, 0xce, 0x92, 0xd8, 0x0c, 0xac, 0xb5, 0x36, 0x72, 0x4b, 0x4d, 0x64, 0xdf, 0xa7, 0x79, 0x7f,
+    0x22, 0x65, 0x57, 0xaf, 0x7b, 0x72, 0x96, 0x89, 0xfc, 0x17, 0x6d, 0x08, 0x33, 0xbf, 0x58, 0x08,
+    0xec, 0xd3, 0x21, 0x0d, 0x78, 0xe2, 0xdb, 0x74, 0xba, 0x97, 0xb2, 0x23, 0x61, 0x5b, 0x6f, 0x91,
+    0xa4, 0x2f, 0x69, 0xac, 0xae, 0x51, 0x31, 0xed, 0x95, 0x25, 0x53, 0xa1, 0x95, 0xbb, 0x4e, 0xdb,
+    0x61, 0x42, 0x25, 0x87, 0x6d, 0x03, 0x71, 0x63, 0x60, 0x5b, 0x90, 0x34, 0x81, 0x10, 0xdc, 0xbb,
+    0x86, 0x2a, 0xc6, 0x25, 0x4a, 0x2f, 0xcc, 0x56, 0x98, 0x06, 0x57, 0xff, 0x12, 0x80, 0x26, 0x0c,
+    0xb5, 0xa0, 0x02, 0x02, 0xcc, 0xa2, 0x18, 0x2f, 0x43, 0xee, 0x08, 0x06, 0x18, 0x51, 0x66, 0x72,
+    0xeb, 0xc1, 0x1c, 0xdf, 0x62, 0xb9, 0x05, 0x96, 0xdf, 0xcd, 0xef, 0x04, 0x94, 0xdd, 0xcf, 0xef,
+    0xa5, 0x37, 0xae, 0xfb, 0x9f, 0xdf, 0x43, 0xb0, 0x91, 0x3e, 0xd9, 0x5d, 0x0f, 0x3f, 0xbf, 0xcf,
+    0xbd, 0x71, 0xfd, 0x5d, 0xed, 0x04, 0x10, 0xed, 0x8a, 0x0c, 0x04, 0x63, 0x76, 0x21, 0x60, 0xb5,
+    0x11, 0xeb, 0xad, 0x05, 0xe6, 0x25, 0xbf, 0x25, 0xab, 0x04, 0xfc, 0x07, 0x2a, 0x01, 0x82, 0x12,
+    0x64, 0x2b, 0x5f, 0x20, 0x5a, 0xa0, 0x3e, 0x42, 0x67, 0x04, 0x01, 0xf1, 0x00, 0x12, 0xfa, 0x78,
+    0x02, 0x05, 0x47, 0x56, 0x1f, 0xe2, 0x21, 0x86, 0xf0, 0x7c, 0xbf, 0xc8, 0x6a, 0xce, 0xb0, 0x8a,
+    0xdc, 0x46, 0x9e, 0x80, 0xc5, 0x12, 0xc1, 0x15, 0xc8, 0xa1, 0x91, 0xdb, 0x03, 0x34, 0xf1, 0x8e,
+    0xd0, 0x6b, 0x0a, 0xc5, 0x0b, 0xfe, 0x52, 0xc0, 0xdc, 0x32, 0xcf, 0xe5, 0x83, 0x69, 0x7c, 0x17,
+    0x38, 0x9b, 0xa4, 0xa4, 0xc2, 0x3e, 0xad, 0xed, 0x79, 0x62, 0x32, 0x63, 0x0c, 0x4c, 0x28, 0xf4,
+    0x96, 0x42, 0x69, 0x5b, 0x30, 0x08, 0x03, 0x45, 0x5e, 0x8d, 0xbb, 0x15, 0x13, 0x4b, 0x0e, 0x25,
+    0x54, 0xb9, 0x43, 0xe5, 0xb1, 0x6a, 0xb7, 0x41, 0x60, 0xdc, 0x13, 0xcd, 0x58, 0x93, 0xcc, 0x58,
+    0x5f, 0x96, 0x4d, 0x43, 0xd6, 0x3b, 0x4d, 0x3e, 0x9f, 0x66, 0xca, 0x4d, 0xc4, 0xe9, 0xf1, 0xa6,
+    0x64, 0x8e, 0x06, 0xdf, 0xc7, 0x12, 0x98, 0xae, 0x1b, 0xed, 0x64, 0xd4, 0x0f, 0x42, 0x03, 0xbb,
+    0x5e, 0x31, 0xa0, 0x08, 0x2c, 0x5c, 0x12, 0x69, 0xc9, 0xfd, 0xff, 0xd0, 0xc2, 0xb4, 0x17, 0x38,
+    0xdc, 0x65, 0x57, 0x6f, 0x5f, 0x1d, 0xf1, 0x15, 0x84, 0x35, 0x36, 0x66, 0xe5, 0xa2, 0xf0, 0xee,
+    0x96, 0x0e, 0x82, 0x21, 0x4d, 0x45, 0x29, 0x4c, 0xaf, 0x20, 0xf9, 0x8c, 0x60, 0x41, 0x3d, 0x3f,
+    0x81, 0xfc, 0x52, 0x46, 0xf1, 0x95, 0x16, 0xc2, 0xed, 0x12, 0xdd, 0xca, 0xce, 0xa9, 0x0f, 0x66,
+    0x64, 0xbf, 0x6b, 0x30, 0x93, 0xcc, 0x7b, 0xc6, 0x1c, 0xe6, 0x2d, 0x88, 0xbd, 0x91, 0x66, 0xa6,
+    0xe4, 0xe9, 0xd6, 0x10, 0x17, 0x90, 0x46, 0xb6, 0x11, 0x51, 0xfa, 0xae, 0xf1, 0xac, 0x69, 0x2d,
+    0x17, 0x9c, 0x56, 0xf1, 0xc8, 0xce, 0x59, 0x71, 0x6e, 0x08, 0x85, 0xa6, 0xa9, 0xa5, 0xc9, 0xe4,
+    0x7c, 0x12, 0xe8, 0xd8, 0x65, 0x6c, 0xd4, 0x30, 0x5b, 0x2a, 0x37, 0xa0, 0xb1, 0x84, 0xd5, 0x53,
+    0xad, 0xdb, 0x48, 0x8b, 0x5e, 0x36, 0x70, 0xc0, 0xc8, 0x60, 0x25, 0xf0, 0x90, 0xd4, 0x1f, 0x45,
+    0xd4, 0xc4, 0xb8, 0x60, 0xed, 0x22, 0x97, 0xfc, 0xe3, 0x1f, 0x7f, 0xd4, 0x8d, 0xdc, 0x2c, 0xd2,
+    0x4e, 0xbd, 0x5d, 0x30, 0xdf, 0xa5, 0xe0, 0x65, 0xe5, 0x05, 0x1b, 0xcb, 0x3e, 0x29, 0x41, 0xce,
+    0xde, 0xa6, 0x34, 0xd7, 0x68, 0x2d, 0x4d, 0x02, 0x6c, 0x63, 0x62, 0x13, 0xa2, 0xc9, 0xd8, 0xab,
+    0x1c, 0x39, 0x6d, 0x70, 0x30, 0xcd, 0xcc, 0xbb, 0x2d, 0x34, 0x67, 0x1c, 0x38, 0x42, 0x65, 0x69,
+    0x9f, 0x3e, 0xdd, 0x7d, 0xd6, 0xe4, 0x35, 0x05, 0xed, 0xe3, 0xc0, 0x92, 0xea, 0xeb, 0x6d, 0x56,
+    0x1f, 0x80, 0xed, 0x9d, 0x6a, 0xdd, 0x7e, 0x5d, 0x8d, 0x7e, 0x0f, 0x35, 0xe0, 0x85, 0x6c, 0x10,
+    0xa3, 0xa6, 0x03, 0x2e, 0x70, 0x6f, 0x9b, 0xd5, 0x00, 0x72, 0xc7, 0xc4, 0x84, 0xa8, 0x44, 0x0d,
+    0x3b, 0x25, 0xf8, 0x35, 0x67, 0xf0, 0x42, 0xd5, 0x9a, 0x00, 0xa0, 0x8c, 0x2a, 0x2c, 0x6d, 0xb4,
+    0x53, 0xcd, 0x44, 0x7f, 0x36, 0x85, 0xec, 0x8f, 0xf6, 0xc8, 0x17, 0x5f, 0x48, 0x7b, 0x6d, 0xa0,
+    0xd3, 0x16, 0x15, 0x5d, 0x66, 0x1a, 0x59, 0x30, 0xdf, 0x07, 0x2d, 0x2c, 0x3d, 0x75, 0x26, 0x4e,
+    0xd1, 0x8f, 0xa9, 0x83, 0x37, 0x86, 0xe4, 0x46, 0x8d, 0xde, 0xc5, 0xbd, 0x74, 0x2f, 0x47, 0x28,
+    0xf2, 0xc5, 0xe2, 0x8b, 0x77, 0x11, 0x3e, 0x5e, 0x47, 0xc5, 0xe4, 0x54, 0x96, 0x5d, 0x21, 0xe0,
+    0x51, 0xf7, 0x8f, 0xae, 0xb9, 0xa7, 0x35, 0x21, 0xb2, 0x97, 0x47, 0x9c, 0xd6, 0x5a, 0xca, 0x67,
+    0xc8, 0xf1, 0x6e, 0x54, 0xab, 0x69, 0x6d, 0xfb, 0xad, 0xf6, 0x00, 0x44, 0x9e, 0x9d, 0x47, 0x09,
+    0xba, 0x67, 0x75, 0xfb, 0x5d, 0xbf, 0x80, 0x1d, 0x83, 0x0d, 0xff, 0x2a, 0xf3, 0x63, 0xe9, 0xde,
+    0x9b, 0xad, 0x37, 0x80, 0x1e, 0xc8, 0xb9, 0x4c, 0x1e, 0x84, 0xf6, 0xf0, 0x61, 0x20, 0xa1, 0x8f,
+    0xda, 0x7e, 0x0b, 0x9e, 0x9a, 0x73, 0xa7, 0xce, 0x67, 0x9f, 0x3c, 0xa9, 0x0a, 0xb4, 0xd5, 0xa8,
+    0x45, 0x63, 0x42, 0xe2, 0x19, 0x81, 0x09, 0x33, 0x7e, 0x3a, 0x1a, 0x34, 0x41, 0x14, 0x4d, 0xcd,
+    0x06, 0xf4, 0xd1, 0xea, 0x64, 0xaa, 0x8a, 0xd2, 0x55, 0x73, 0xc9, 0xea, 0x69, 0xe8, 0xc5, 0xae,
+    0xc1, 0x2b, 0x12, 0x78, 0xce, 0x60, 0x5f, 0x06, 0x60, 0x16, 0x26, 0x92, 0xf7, 0xcf, 0xe2, 0x5f,
+    0x8c, 0x7e, 0x59, 0x5e, 0x02, 0x7a, 0xd2, 0x23, 0x05, 0x7a, 0x94, 0xfc, 0x0d, 0xa0, 0xc3, 0xb0,
+    0xfd, 0xd3, 0x1d, 0x1b, 0xd9, 0x15, 0x91, 0xc1, 0x06, 0x53, 0x99, 0x5c, 0x8b, 0xfa, 0x2c, 0x12,
+    0x80, 0xe6, 0xb3, 0xb3, 0x34, 0x3c, 0x5e, 0x73, 0x29, 0xc8, 0x1f, 0x81, 0x91, 0x04, 0x45, 0xc5,
+    0x30, 0xd3, 0xa6, 0xa0, 0xb6, 0xcf, 0xb8, 0x26, 0xcc, 0xaf, 0x5c, 0x21, 0x29, 0xcc, 0x74, 0x22,
+    0xbb, 0x4a, 0xd4, 0x4f, 0x0f, 0xf2, 0xfc, 0x4d, 0xeb, 0xd8, 0x6a, 0x34, 0xed, 0x47, 0x34, 0x3a,
+    0xf0, 0xb8, 0xa9, 0x6d, 0x5f, 0xa2, 0x68, 0x7f, 0xd9, 0xeb, 0x46, 0x06, 0xd6, 0x96, 0x66, 0x64,
+    0x8e, 0x62, 0x0b, 0x5a, 0xd1, 0x2f, 0xd1, 0x48, 0x24, 0x5f, 0x80, 0xae, 0x56, 0xb7, 0xa2, 0xa1,
+    0x01, 0x06, 0x97, 0x6a, 0x17, 0x65, 0x20, 0xba, 0x8e, 0x08, 0xbb, 0x77, 0xf5, 0xbb, 0x71, 0xe5,
+    0x7d, 0x78, 0x15, 0x0f, 0xa4, 0xaf, 0x5d, 0x6a, 0x7e, 0x82, 0x66, 0xd5, 0xa4, 0x46, 0x64, 0x30,
+    0xf0, 0x20, 0x11, 0x44, 0x2f, 0x2f, 0xcf, 0x4e, 0x35, 0x45, 0x94, 0xb4, 0x09, 0xd2, 0x0c, 0x24,
+    0xbb, 0x01, 0x24, 0x90, 0x13, 0x48, 0xf8, 0x36, 0xbe, 0xab, 0x17, 0x70, 0x23, 0xa4, 0xbc, 0x5a,
+    0x59, 0x10, 0xd2, 0x81, 0x7a, 0x21, 0x58, 0x2a, 0xa7, 0x6d, 0xb9, 0xde, 0x8d, 0xd5, 0x04, 0x65,
+    0x61, 0xf4, 0x40, 0x1e, 0x1f, 0xbc, 0x06, 0x57, 0x45, 0x09, 0xf3, 0xfb, 0x87, 0xd6, 0x96, 0x51,
+    0xc5, 0x75, 0x7d, 0xd7, 0x88, 0x5e, 0xe5, 0x81, 0x94, 0xba, 0xa4, 0x00, 0xbb, 0x5b, 0x58, 0xd7,
+    0xda, 0x74, 0xd8, 0x64, 0x1e, 0xd5, 0x48, 0xb2, 0xf5, 0x0c, 0x24, 0x54, 0xe7, 0xaa, 0xe8, 0x51,
+    0xb6, 0x95, 0xce, 0x6d, 0x75, 0x3b, 0x87, 0x27, 0xb1, 0x93, 0xe0, 0x97, 0x56, 0xea, 0xcf, 0x00,
+    0xb7, 0x4f, 0x43, 0x36, 0x37, 0x84, 0x8b, 0x27, 0xf6, 0x0c, 0xb1, 0x75, 0x75, 0x42, 0xdf, 0x03,
+    0x48, 0xdb, 0x76, 0xc2, 0x6d, 0xea, 0xf9, 0xae, 0xde, 0x34, 0xd2, 0xe5, 0x64, 0x7b, 0xde, 0x3d,
+    0x82, 0xfd, 0x95, 0x6b, 0xa3, 0xad, 0x6a, 0x1c, 0x60, 0x5d, 0xf3, 0xf9, 0x4e, 0x0d, 0x48, 0xb9,
+    0x92, 0x27, 0x1d, 0x44, 0x7a, 0x66, 0x76, 0xec, 0x15, 0x10, 0x79, 0x14, 0xd9, 0x10, 0x45, 0x29,
+    0xe5, 0x96, 0x38, 0x52, 0xe7, 0x66, 0x75, 0xae, 0xaa, 0x78, 0x94, 0x43, 0xe9, 0xc1, 0x07, 0x6a,
+    0x9f, 0x3e, 0xf6, 0x52, 0x09, 0xea, 0xa3, 0x4f, 0x11, 0x34, 0x05, 0xa0, 0xa2, 0xc8, 0x33, 0x25,
+    0xce, 0xbc, 0x95, 0xb8, 0xdc, 0xec, 0x6d, 0x1e, 0x92, 0x6a, 0xae, 0xe8, 0x11, 0x8a, 0xcb, 0x03,
+    0x7c, 0x62, 0x7b, 0xc3, 0xe8, 0x1c, 0x0a, 0x45, 0xac, 0x90, 0xbd, 0x17, 0x13, 0xf5, 0xa5, 0x2e,
+    0x85, 0xf6, 0xd3, 0xae, 0xd1, 0x54, 0xbd, 0x88, 0xf8, 0x6d, 0x0c, 0x78, 0x52, 0xe6, 0x72, 0x40,
+    0xe3, 0x51, 0x7a, 0xd2, 0x54, 0x3a, 0x96, 0x40, 0xc2, 0x04, 0xa9, 0x62, 0x27, 0x4a, 0xe6, 0xb1,
+    0xa1, 0x3d, 0x5d, 0x08, 0x6a, 0xac, 0x36, 0xb2, 0x4d, 0x61, 0x84, 0x0f, 0xea, 0xaa, 0xd1, 0x36,
+    0xd7, 0x4b, 0x2f, 0x5f, 0xe8, 0x56, 0x52, 0x83, 0x07, 0x71, 0xe4, 0xb4, 0x6f, 0x99, 0x28, 0x51,
+    0x9e, 0x00, 0x79, 0xda, 0x0d, 0x34, 0xb3, 0x6c, 0x73, 0x90, 0x90, 0xd2, 0xe2, 0x2f, 0xbb, 0xdb,
+    0xae, 0x6f, 0x5f, 0xc8, 0x3d, 0x75, 0x7a, 0x91, 0x50, 0xc9, 0xc1, 0xcb, 0x60, 0xd1, 0xca, 0xb6,
+    0xfe, 0xeb, 0x3f, 0xb3, 0xbc, 0x44, 0x70, 0x51, 0xd9, 0x20, 0x5c, 0xc0, 0x4f, 0xac, 0xae, 0x19,
+    0x4d, 0x55, 0xea, 0xf0, 0x56, 0x7d, 0xf4, 0xf0, 0x0b, 0x78, 0x59, 0xab, 0xed, 0xf8, 0xe4, 0xf4,
+    0xe4, 0xf2, 0xc4, 0x02, 0x9f, 0xfa, 0x98, 0xea, 0xad, 0x3a, 0xe9, 0x05, 0xb0, 0xd0, 0x52, 0x43,
+    0x9b, 0x33, 0xdc, 0x06, 0x74, 0x81, 0xb7, 0x3e, 0xfe, 0xfc, 0xe0, 0x22, 0xbb, 0x7b, 0xf2, 0x69,
+    0xb0, 0x05, 0x72, 0xcb, 0xd3, 0x1b, 0x9e, 0xea, 0xfe, 0xff, 0x42, 0x16, 0xea, 0xee, 0xd0, 0xe7,
+    0xf7, 0xb0, 0x32, 0x3c, 0x91, 0x5d, 0x93, 0x3f, 0xfc, 0xfa, 0xf7, 0xe9, 0xdb, 0xf6, 0x78, 0xa3,
+    0x65, 0x85, 0x4f, 0x82, 0xec, 0x66, 0x85, 0xb5, 0x99, 0x10, 0x6b, 0xfc, 0x31, 0x8b, 0x6f, 0x6a,
+    0xaf, 0x53, 0xfc, 0x09, 0x4b, 0xf8, 0xba, 0x65, 0x30, 0x68, 0x77, 0xa4, 0xda, 0x9e, 0x8b, 0xe6,
+    0x17, 0x95, 0x3e, 0xfa, 0x48, 0x54, 0x5d, 0xd2, 0xa9, 0xd9, 0x27, 0x34, 0x8e, 0xdc, 0xdc, 0x35,
+    0xaa, 0x9c, 0x7d, 0x5a, 0x0f, 0xbb, 0x50, 0xf4, 0x41, 0x33, 0xaa, 0x65, 0xcb, 0xdb, 0x4d, 0x38,
+    0x63, 0x7a, 0xbf, 0xc9, 0x6a, 0xda, 0x76, 0xe2, 0x69, 0xcc, 0x45, 0x7a, 0x45, 0xa6, 0x6d, 0x3e,
+    0xd7, 0xef, 0x6a, 0x7d, 0x12, 0x0b, 0x19, 0xf6, 0x72, 0x78, 0xfe, 0xff, 0x50, 0xd9, 0xb4, 0x05,
+    0x19, 0xca, 0x2f, 0xf6, 0x5a, 0x7c, 0x0e, 0x51, 0x72, 0x81, 0xa4, 0xcc, 0x95, 0x7a, 0xcf, 0x6e,
+    0x09, 0x81, 0x55, 0xf4, 0xe4, 0x51, 0xb8, 0x40, 0x54, 0xee, 0xab, 0x36, 0x8b, 0x51, 0x14, 0x5d,
+    0x93, 0xa2, 0xfe, 0x4a, 0x52, 0x63, 0x58, 0x14, 0x6f, 0x7c, 0xe0, 0xf5, 0x0e, 0x53, 0x09, 0xcd,
+    0x59, 0xff, 0xf8, 0x23, 0x79, 0x24, 0x89, 0x4c, 0xb5, 0xb2, 0xbd, 0xe7, 0x03, 0x8b, 0x4f, 0xe0,
+    0xfa, 0x7f, 0xf8, 0xa7, 0xbf, 0x93, 0xd7, 0xf4, 0xd4, 0x95, 0x1d, 0x79, 0xef, 0x1a, 0x8b, 0xf3,
+    0x07, 0x32, 0xd7, 0xbd, 0x5c, 0x7d, 0x41, 0xca, 0x9a, 0xd6, 0x5b, 0x7a, 0x33, 0xb7, 0xea, 0xa6,
+    0xa1, 0x62, 0x5a, 0x16, 0xe6, 0xec, 0xb2, 0x9a, 0xf9, 0xd8, 0xca, 0x73, 0xb7, 0x94, 0xca, 0x82,
+    0x36, 0xa7, 0x06, 0x06, 0x0a, 0xd0, 0xb7, 0xdb, 0x81, 0x98, 0xb8, 0x54, 0x1d, 0x00, 0x45, 0x42,
+    0xdb, 0xe3, 0xc8, 0x86, 0xb6, 0xd0, 0x31, 0x9b, 0x03, 0xc0, 0x65, 0x2a, 0x1b, 0xe1, 0xad, 0x6b,
+    0x99, 0x81, 0xee, 0x14, 0x2c, 0x97, 0x7b, 0x95, 0xf2, 0x55, 0x6c, 0x53, 0x45, 0x35, 0x79, 0xd6,
+    0xba, 0x5e, 0x3c, 0x1d, 0xca, 0x0c, 0x51, 0xb7, 0x56, 0xf3, 0xf9, 0xe7, 0x9b, 0x8b, 0xb6, 0x07,
+    0xa0, 0xf2, 0xfc, 0x7b, 0x52, 0x3e, 0xff, 0x46, 0x30, 0x04, 0x88, 0xae, 0xca, 0x40, 0x9d, 0x6a,
+    0xca, 0xab, 0x0a, 0x80, 0x87, 0x21, 0x5c, 0xbc, 0xc5, 0x9d, 0x7d, 0x8f, 0xe6, 0xec, 0x29, 0x93,
+    0x68, 0x28, 0x50, 0x7b, 0xbb, 0x15, 0x71, 0x15, 0xc1, 0x60, 0xad, 0x09, 0xd0, 0x29, 0xd3, 0xba,
+    0xec, 0xf2, 0xed, 0x7d, 0x39, 0x3d, 0xe9, 0x9a, 0x3b, 0x77, 0xa6, 0x8b, 0x80, 0x6d, 0xeb, 0xee,
+    0x06, 0x40, 0xd4, 0x65, 0x97, 0x02, 0x40, 0x2f, 0x80, 0x0a, 0x74, 0x9d, 0x56, 0xb0, 0x5c, 0x5a,
+    0xbd, 0x06, 0x95, 0xe3, 0x94, 0x7f, 0x54, 0x40, 0xae, 0x34, 0xd3, 0x56, 0x15, 0xa5, 0xbb, 0x93,
+    0x4d, 0x1d, 0xbf, 0x34, 0x29, 0x7d, 0x8c, 0x8c, 0xc5, 0xdb, 0x81, 0x2d, 0xe5, 0x2b, 0x5d, 0x28,
+    0x94, 0x17, 0xfe, 0xf4, 0xdb, 0xa2, 0xc5, 0x7b, 0xad, 0x48, 0xa0, 0x57, 0xd6, 0xca, 0xbd, 0xd6,
+    0x63, 0x58, 0xf0, 0x20, 0xe0, 0xb7, 0xba, 0xf7, 0xec, 0x98, 0xcf, 0xa9, 0x01, 0x6f, 0x37, 0x25,
+    0xae, 0xc2, 0x97, 0x69, 0x2a, 0xf5, 0x54, 0x8d, 0xd6, 0x6a, 0x84, 0xea, 0x76, 0xe0, 0x23, 0x33,
+    0x75, 0x11, 0xb1, 0x6f, 0x68, 0xe5, 0x39, 0x8c, 0x95, 0x7e, 0x67, 0xd6, 0x22, 0x3f, 0x21, 0x56,
+    0xf9, 0x6b, 0xb4, 0x16, 0x99, 0x90, 0x6d, 0x2d, 0xb4, 0x0a, 0x37, 0xf9, 0x15, 0xda, 0x12, 0xb3,
+    0xf4, 0x93, 0x49, 0x05, 0x08, 0x96, 0x2f, 0xb8, 0xda, 0x0f, 0xb2, 0xde, 0x66, 0x94, 0xb1, 0xb6,
+    0x60, 0x1e, 0x6a, 0xd6, 0x71, 0xe1, 0x8b, 0x47, 0x96, 0xe1, 0xa8, 0xe0, 0x51, 0xc1, 0x07, 0xb0,
+    0x22, 0x6c, 0xde, 0x0e, 0x0a, 0x23, 0x4d, 0x35, 0x42, 0x4d, 0xdd, 0x0a, 0xa2, 0x7d, 0x40, 0x1d,
+    0xc0, 0x9b, 0x18, 0x78, 0x97, 0xb2, 0xe0, 0xa3, 0x83, 0xec, 0x0b, 0xc5, 0x67, 0xb1, 0xe1, 0xdc,
+    0x1e, 0x17, 0x53, 0xa0, 0x35, 0x18, 0xde, 0xb4, 0x08, 0x98, 0xe2, 0x49, 0xd1, 0xab, 0x49, 0xbf,
+    0xe2, 0xf5, 0x4d, 0x22, 0x67, 0x3d, 0x42, 0x27, 0xce, 0x8e, 0xfe, 0x17, 0x3e, 0xe7, 0x91, 0x0d,
+    0x6c, 0x87, 0xa6, 0x53, 0xc7, 0xb4, 0xb1, 0xc3, 0x35, 0x72, 0xc9, 0x60, 0x48, 0x9e, 0x8d, 0x64,
+    0xf7, 0x65, 0x82, 0xc9, 0xef, 0x42, 0x56, 0x1c, 0xf5, 0xe4, 0x31, 0x3e, 0x19, 0x84, 0xf2, 0x96,
+    0x07, 0xd4, 0x84, 0x71, 0x8f, 0x58, 0xa3, 0x4a, 0xbc, 0x28, 0x6b, 0xe8, 0x90, 0xea, 0x1f, 0xff,
+    0x45, 0x62, 0x28, 0xb3, 0x55, 0x71, 0x32, 0x62, 0xe3, 0x73, 0x94, 0x08, 0xde, 0x74, 0x2d, 0x23,
+    0xd3, 0xad, 0xfb, 0xa4, 0xfc, 0x8b, 0x82, 0xe9, 0xcd, 0x7a, 0xd8, 0x40, 0xca, 0xaf, 0x08, 0x1e,
+    0x0c, 0xd5, 0xff, 0xc1, 0xf4, 0x7f, 0x00, 0x06, 0x08, 0xba, 0x94, 0x49, 0x00, 0x00,
+};
+
+#endif // WEB_UI_H
@@ -0,0 +1,34 @@
+#ifndef SIM_ADAFRUIT_PN532_H
+#define SIM_ADAFRUIT_PN532_H
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <Wire.h>
+
+#define PN532_MIFARE_ISO14443A 0x00
+
+// PN532 with a simulated field instead of a radio: simTagPlace() and
+// simTagRemove() (sim.h, or a --tags script) decide what the reader sees.
+// The detection API drives NFC_IRQ like the chip does, so interrupt-driven
+// firmware runs unchanged.
+class Adafruit_PN532 {
+public:
+    Adafruit_PN532(uint8_t clk, uint8_t miso, uint8_t mosi, uint8_t ss);
+    Adafruit_PN532(uint8_t ss, SPIClass* spi = &SPI);
+    Adafruit_PN532(uint8_t irq, uint8_t reset, TwoWire* wire = &Wire);
+    
+    bool begin() { return true; }
+    uint32_t getFirmwareVersion() { return 0x32010607; }
+    bool SAMConfig() { return true; }
+    bool setPassiveActivationRetries(uint8_t maxRetries) { return true; }
+    
+    // Waits up to timeout ms for a tag
+    bool readPassiveTargetID(uint8_t cardBaudRate, uint8_t* uid, uint8_t* uidLength, uint16_t timeout = 0);
+    
+    // Arms detection; NFC_IRQ goes low once a tag is (or comes) in the field
+    bool startPassiveTargetIDDetection(uint8_t cardBaudRate);
+    // Reads the armed result and releases NFC_IRQ
+    bool readDetectedPassiveTargetID(uint8_t* uid, uint8_t* uidLength);
+};
+
+#endif // SIM_ADAFRUIT_PN532_H
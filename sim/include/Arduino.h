@@ -0,0 +1,131 @@
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+// Host stand-in for the ESP32 Arduino core (native build). Same names and
+// semantics where the firmware relies on them; see sim/README.md for what is
+// simulated and what is not.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+
+#include "pgmspace.h"
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "WString.h"
+#include "Print.h"
+
+using std::min;
+using std::max;
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_DATA_ATTR
+
+#define LOW 0x0
+#define HIGH 0x1
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define PULLUP 0x04
+#define INPUT_PULLUP 0x05
+#define PULLDOWN 0x08
+#define INPUT_PULLDOWN 0x09
+
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+#define ONLOW 0x04
+#define ONHIGH 0x05
+
+#define digitalPinToInterrupt(p) (p)
+#define NOT_AN_INTERRUPT -1
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+typedef bool boolean;
+typedef uint8_t byte;
+typedef unsigned int word;
+
+// Time since start; delay() sleeps the calling thread
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+// Simulated pins: inputs read HIGH unless sim code drives them (sim.h)
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode);
+void detachInterrupt(uint8_t pin);
+
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+
+bool setCpuFrequencyMhz(uint32_t mhz);
+uint32_t getCpuFrequencyMhz();
+
+// No PSRAM on the simulated board
+bool psramFound();
+void* ps_malloc(size_t size);
+void* ps_calloc(size_t n, size_t size);
+void* ps_realloc(void* ptr, size_t size);
+
+#if !defined(__GLIBC__) || __GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38)
+extern "C" size_t strlcpy(char* dst, const char* src, size_t size);
+extern "C" size_t strlcat(char* dst, const char* src, size_t size);
+#endif
+
+// Serial is stdout
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud) {}
+    void end() {}
+    operator bool() const { return true; }
+    
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    void flush() override;
+    int availableForWrite() { return 256; }
+    
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+};
+
+extern HardwareSerial Serial;
+
+class EspClass {
+public:
+    uint32_t getHeapSize();
+    uint32_t getFreeHeap();
+    uint32_t getMinFreeHeap();
+    uint32_t getMaxAllocHeap();
+    uint32_t getPsramSize() { return 0; }
+    uint32_t getFreePsram() { return 0; }
+    uint32_t getMinFreePsram() { return 0; }
+    uint32_t getMaxAllocPsram() { return 0; }
+    uint32_t getCpuFreqMHz() { return getCpuFrequencyMhz(); }
+    const char* getSdkVersion() { return "host"; }
+    void restart();
+};
+
+extern EspClass ESP;
+
+// The sketch
+void setup();
+void loop();
+
+#endif // SIM_ARDUINO_H
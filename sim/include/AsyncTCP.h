@@ -0,0 +1,6 @@
+#ifndef SIM_ASYNC_TCP_H
+#define SIM_ASYNC_TCP_H
+
+// The simulated ESPAsyncWebServer talks to host sockets directly
+
+#endif // SIM_ASYNC_TCP_H
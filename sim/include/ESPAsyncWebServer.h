@@ -0,0 +1,335 @@
+#ifndef SIM_ESP_ASYNC_WEB_SERVER_H
+#define SIM_ESP_ASYNC_WEB_SERVER_H
+
+// ESPAsyncWebServer on a host socket (port from --http-port). One thread per
+// connection, but every callback runs under one lock, as they would on the
+// single async_tcp task. Only the parts the firmware uses are here:
+// callback routes, multipart uploads, body handlers, filler/chunked
+// responses and server-sent events. Connections are never kept alive.
+
+#include <Arduino.h>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+typedef enum {
+    HTTP_GET = 0b00000001,
+    HTTP_POST = 0b00000010,
+    HTTP_DELETE = 0b00000100,
+    HTTP_PUT = 0b00001000,
+    HTTP_PATCH = 0b00010000,
+    HTTP_HEAD = 0b00100000,
+    HTTP_OPTIONS = 0b01000000,
+    HTTP_ANY = 0b01111111
+} WebRequestMethod;
+
+typedef uint8_t WebRequestMethodComposite;
+
+#define RESPONSE_TRY_AGAIN 0xFFFFFFFF
+
+class AsyncWebServer;
+class AsyncWebServerRequest;
+class AsyncWebServerResponse;
+class AsyncEventSource;
+class AsyncEventSourceClient;
+
+typedef std::function<void(AsyncWebServerRequest* request)> ArRequestHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest* request, const String& filename, size_t index,
+                           uint8_t* data, size_t len, bool final)> ArUploadHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest* request, uint8_t* data, size_t len,
+                           size_t index, size_t total)> ArBodyHandlerFunction;
+typedef std::function<size_t(uint8_t* buffer, size_t maxLen, size_t index)> AwsResponseFiller;
+typedef std::function<void(void)> ArDisconnectHandler;
+typedef std::function<void(AsyncEventSourceClient* client)> ArEventHandlerFunction;
+
+// ============================================================================
+// Request
+// ============================================================================
+
+class AsyncWebParameter {
+public:
+    AsyncWebParameter(const String& name, const String& value, bool form = false, bool file = false)
+        : _name(name), _value(value), _isForm(form), _isFile(file) {}
+    
+    const String& name() const { return _name; }
+    const String& value() const { return _value; }
+    size_t size() const { return _value.length(); }
+    bool isPost() const { return _isForm; }
+    bool isFile() const { return _isFile; }
+
+private:
+    String _name;
+    String _value;
+    bool _isForm;
+    bool _isFile;
+};
+
+class AsyncWebHeader {
+public:
+    AsyncWebHeader(const String& name, const String& value) : _name(name), _value(value) {}
+    
+    const String& name() const { return _name; }
+    const String& value() const { return _value; }
+
+private:
+    String _name;
+    String _value;
+};
+
+class AsyncWebServerRequest {
+public:
+    ~AsyncWebServerRequest();
+    
+    const String& url() const { return _url; }
+    WebRequestMethodComposite method() const { return _method; }
+    const char* methodToString() const;
+    const String& contentType() const { return _contentType; }
+    size_t contentLength() const { return _contentLength; }
+    
+    size_t headers() const { return _headers.size(); }
+    bool hasHeader(const String& name) const;
+    AsyncWebHeader* getHeader(const String& name) const;
+    const String& header(const char* name) const;
+    
+    size_t params() const { return _params.size(); }
+    bool hasParam(const String& name, bool post = false, bool file = false) const;
+    AsyncWebParameter* getParam(const String& name, bool post = false, bool file = false) const;
+    AsyncWebParameter* getParam(size_t index) const;
+    bool hasArg(const char* name) const;
+    const String& arg(const String& name) const;
+    
+    void onDisconnect(ArDisconnectHandler fn) { _onDisconnect = fn; }
+    
+    void send(AsyncWebServerResponse* response);
+    void send(int code, const String& contentType = String(), const String& content = String());
+    
+    AsyncWebServerResponse* beginResponse(int code, const String& contentType = String(),
+                                          const String& content = String());
+    AsyncWebServerResponse* beginResponse(const String& contentType, size_t len, AwsResponseFiller callback);
+    AsyncWebServerResponse* beginResponse_P(int code, const String& contentType, const uint8_t* content, size_t len);
+    AsyncWebServerResponse* beginResponse_P(int code, const String& contentType, const char* content);
+    AsyncWebServerResponse* beginChunkedResponse(const String& contentType, AwsResponseFiller callback);
+    class AsyncResponseStream* beginResponseStream(const String& contentType, size_t bufferSize = 1460);
+    
+    void* _tempObject = nullptr;
+
+private:
+    friend class SimHttpConnection;
+    
+    WebRequestMethodComposite _method = 0;
+    String _url;
+    String _contentType;
+    size_t _contentLength = 0;
+    std::vector<AsyncWebHeader*> _headers;
+    std::vector<AsyncWebParameter*> _params;
+    AsyncWebServerResponse* _response = nullptr;
+    ArDisconnectHandler _onDisconnect;
+};
+
+// ============================================================================
+// Responses
+// ============================================================================
+
+class AsyncWebServerResponse {
+public:
+    AsyncWebServerResponse(int code = 200, const String& contentType = String())
+        : _code(code), _contentType(contentType) {}
+    virtual ~AsyncWebServerResponse() {}
+    
+    void setCode(int code) { _code = code; }
+    void setContentType(const String& type) { _contentType = type; }
+    void setContentLength(size_t len) { _contentLength = len; }
+    void addHeader(const String& name, const String& value) { _headers.emplace_back(name, value); }
+
+protected:
+    friend class SimHttpConnection;
+    
+    // Copies the body from index on; RESPONSE_TRY_AGAIN when nothing is ready
+    virtual size_t fill(uint8_t* buffer, size_t maxLen, size_t index) { return 0; }
+    virtual bool chunked() const { return false; }
+    // Server-sent events keep the socket after the headers
+    virtual void adopt(int fd) {}
+    virtual bool persistent() const { return false; }
+    
+    int _code;
+    String _contentType;
+    size_t _contentLength = 0;
+    std::vector<AsyncWebHeader> _headers;
+};
+
+class AsyncBasicResponse : public AsyncWebServerResponse {
+public:
+    AsyncBasicResponse(int code, const String& contentType, const String& content);
+
+protected:
+    size_t fill(uint8_t* buffer, size_t maxLen, size_t index) override;
+    
+    String _content;
+};
+
+class AsyncProgmemResponse : public AsyncWebServerResponse {
+public:
+    AsyncProgmemResponse(int code, const String& contentType, const uint8_t* content, size_t len);
+
+protected:
+    size_t fill(uint8_t* buffer, size_t maxLen, size_t index) override;
+    
+    const uint8_t* _content;
+};
+
+class AsyncCallbackResponse : public AsyncWebServerResponse {
+public:
+    AsyncCallbackResponse(const String& contentType, size_t len, AwsResponseFiller callback);
+
+protected:
+    size_t fill(uint8_t* buffer, size_t maxLen, size_t index) override;
+    
+    AwsResponseFiller _callback;
+};
+
+class AsyncChunkedResponse : public AsyncCallbackResponse {
+public:
+    AsyncChunkedResponse(const String& contentType, AwsResponseFiller callback)
+        : AsyncCallbackResponse(contentType, 0, callback) {}
+
+protected:
+    bool chunked() const override { return true; }
+};
+
+class AsyncResponseStream : public AsyncWebServerResponse, public Print {
+public:
+    AsyncResponseStream(const String& contentType, size_t bufferSize)
+        : AsyncWebServerResponse(200, contentType) {}
+    
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* data, size_t len) override;
+    using Print::write;
+
+protected:
+    size_t fill(uint8_t* buffer, size_t maxLen, size_t index) override;
+    
+    std::string _content;
+};
+
+// ============================================================================
+// Handlers and server
+// ============================================================================
+
+class AsyncWebHandler {
+public:
+    virtual ~AsyncWebHandler() {}
+    virtual bool canHandle(AsyncWebServerRequest* request) { return false; }
+    virtual void handleRequest(AsyncWebServerRequest* request) {}
+    virtual void handleUpload(AsyncWebServerRequest* request, const String& filename, size_t index,
+                              uint8_t* data, size_t len, bool final) {}
+    virtual void handleBody(AsyncWebServerRequest* request, uint8_t* data, size_t len,
+                            size_t index, size_t total) {}
+};
+
+class AsyncCallbackWebHandler : public AsyncWebHandler {
+public:
+    AsyncCallbackWebHandler(const String& uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest,
+                            ArUploadHandlerFunction onUpload, ArBodyHandlerFunction onBody)
+        : _uri(uri), _method(method), _onRequest(onRequest), _onUpload(onUpload), _onBody(onBody) {}
+    
+    bool canHandle(AsyncWebServerRequest* request) override;
+    void handleRequest(AsyncWebServerRequest* request) override;
+    void handleUpload(AsyncWebServerRequest* request, const String& filename, size_t index,
+                      uint8_t* data, size_t len, bool final) override;
+    void handleBody(AsyncWebServerRequest* request, uint8_t* data, size_t len,
+                    size_t index, size_t total) override;
+
+private:
+    String _uri;
+    WebRequestMethodComposite _method;
+    ArRequestHandlerFunction _onRequest;
+    ArUploadHandlerFunction _onUpload;
+    ArBodyHandlerFunction _onBody;
+};
+
+class AsyncWebServer {
+public:
+    AsyncWebServer(uint16_t port);
+    ~AsyncWebServer();
+    
+    void begin();
+    void end();
+    
+    AsyncWebHandler& addHandler(AsyncWebHandler* handler);
+    AsyncCallbackWebHandler& on(const char* uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest,
+                                ArUploadHandlerFunction onUpload = nullptr, ArBodyHandlerFunction onBody = nullptr);
+    AsyncCallbackWebHandler& on(const char* uri, ArRequestHandlerFunction onRequest) {
+        return on(uri, HTTP_ANY, onRequest);
+    }
+    void onNotFound(ArRequestHandlerFunction fn) { _notFound = fn; }
+
+private:
+    friend class SimHttpConnection;
+    
+    void acceptLoop();
+    
+    uint16_t _port;
+    int _listenFd;
+    std::vector<AsyncWebHandler*> _handlers;
+    ArRequestHandlerFunction _notFound;
+};
+
+// ============================================================================
+// Server-sent events
+// ============================================================================
+
+class AsyncEventSourceClient {
+public:
+    AsyncEventSourceClient(AsyncEventSource* source, int fd) : _source(source), _fd(fd) {}
+    
+    void send(const char* message, const char* event = nullptr, uint32_t id = 0, uint32_t reconnect = 0);
+    bool connected() const { return _fd >= 0; }
+    uint32_t lastId() const { return _lastId; }
+    AsyncEventSource* eventSource() { return _source; }
+
+private:
+    friend class AsyncEventSource;
+    
+    AsyncEventSource* _source;
+    int _fd;
+    uint32_t _lastId = 0;
+    std::mutex _writeLock;
+};
+
+class AsyncEventSource : public AsyncWebHandler {
+public:
+    AsyncEventSource(const String& url) : _url(url) {}
+    
+    const char* url() const { return _url.c_str(); }
+    void onConnect(ArEventHandlerFunction cb) { _connectCb = cb; }
+    void send(const char* message, const char* event = nullptr, uint32_t id = 0, uint32_t reconnect = 0);
+    size_t count();
+    void close();
+    
+    bool canHandle(AsyncWebServerRequest* request) override;
+    void handleRequest(AsyncWebServerRequest* request) override;
+
+private:
+    friend class AsyncEventSourceResponse;
+    
+    // Connection thread: from adopt() until the browser hangs up
+    void serve(int fd);
+    
+    String _url;
+    ArEventHandlerFunction _connectCb;
+    std::mutex _clientsLock;
+    std::vector<AsyncEventSourceClient*> _clients;
+};
+
+class AsyncEventSourceResponse : public AsyncWebServerResponse {
+public:
+    AsyncEventSourceResponse(AsyncEventSource* source);
+
+protected:
+    void adopt(int fd) override { _source->serve(fd); }
+    bool persistent() const override { return true; }
+    
+    AsyncEventSource* _source;
+};
+
+#endif // SIM_ESP_ASYNC_WEB_SERVER_H
@@ -0,0 +1,68 @@
+#ifndef SIM_PRINT_H
+#define SIM_PRINT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "WString.h"
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class Print {
+public:
+    virtual ~Print() {}
+    
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* str);
+    size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+    virtual void flush() {}
+    
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+    size_t printf_P(const char* format, ...) __attribute__((format(printf, 2, 3)));
+    
+    size_t print(const __FlashStringHelper* str) { return write((const char*)str); }
+    size_t print(const String& str) { return write(str.c_str(), str.length()); }
+    size_t print(const char* str) { return write(str); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char value, int base = DEC) { return print((unsigned long long)value, base); }
+    size_t print(int value, int base = DEC) { return print((long long)value, base); }
+    size_t print(unsigned int value, int base = DEC) { return print((unsigned long long)value, base); }
+    size_t print(long value, int base = DEC) { return print((long long)value, base); }
+    size_t print(unsigned long value, int base = DEC) { return print((unsigned long long)value, base); }
+    size_t print(long long value, int base = DEC);
+    size_t print(unsigned long long value, int base = DEC);
+    size_t print(double value, int digits = 2);
+    
+    template <typename T>
+    size_t println(const T& value) {
+        size_t n = print(value);
+        return n + println();
+    }
+    template <typename T>
+    size_t println(const T& value, int format) {
+        size_t n = print(value, format);
+        return n + println();
+    }
+    size_t println() { return write("\n"); }
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+    virtual size_t readBytes(char* buffer, size_t length);
+    size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+    String readString();
+    String readStringUntil(char terminator);
+
+protected:
+    unsigned long _timeout = 1000;
+};
+
+#endif // SIM_PRINT_H
@@ -0,0 +1,35 @@
+#ifndef SIM_SD_H
+#define SIM_SD_H
+
+#include "FS.h"
+#include "SPI.h"
+
+typedef enum {
+    CARD_NONE,
+    CARD_MMC,
+    CARD_SD,
+    CARD_SDHC,
+    CARD_UNKNOWN
+} sdcard_type_t;
+
+namespace fs {
+
+// The card is a host directory (--sd, default ./sdcard), created if missing
+class SDFS : public FS {
+public:
+    bool begin(uint8_t ssPin = 5, SPIClass& spi = SPI, uint32_t frequency = 4000000,
+               const char* mountpoint = "/sd", uint8_t maxFiles = 5, bool formatIfEmpty = false);
+    void end() {}
+    sdcard_type_t cardType() { return _root.empty() ? CARD_NONE : CARD_SDHC; }
+    uint64_t cardSize();
+    uint64_t totalBytes();
+    uint64_t usedBytes();
+};
+
+} // namespace fs
+
+extern fs::SDFS SD;
+
+using namespace fs;
+
+#endif // SIM_SD_H
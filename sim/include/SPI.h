@@ -0,0 +1,23 @@
+#ifndef SIM_SPI_H
+#define SIM_SPI_H
+
+#include <Arduino.h>
+
+#define FSPI 1
+#define HSPI 2
+#define VSPI 3
+
+// Nothing sits on the simulated buses; the peripherals behind them (SD card,
+// PN532) are simulated at the library level instead
+class SPIClass {
+public:
+    SPIClass(uint8_t bus = HSPI) {}
+    void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1) {}
+    void end() {}
+    void setFrequency(uint32_t frequency) {}
+    uint8_t transfer(uint8_t data) { return 0xFF; }
+};
+
+extern SPIClass SPI;
+
+#endif // SIM_SPI_H
@@ -0,0 +1,134 @@
+#ifndef SIM_WSTRING_H
+#define SIM_WSTRING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+class __FlashStringHelper;
+#define FPSTR(p) (reinterpret_cast<const __FlashStringHelper*>(p))
+#define F(s) FPSTR(PSTR(s))
+
+// Arduino String over std::string: the ESP32 core's API, as far as the
+// firmware, ArduinoJson and ESP8266Audio use it
+class String {
+public:
+    String(const char* cstr = "");
+    String(const char* cstr, unsigned int length);
+    String(const __FlashStringHelper* str);
+    String(const std::string& str) : _s(str) {}
+    explicit String(char c);
+    explicit String(unsigned char value, unsigned char base = 10);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(long long value, unsigned char base = 10);
+    explicit String(unsigned long long value, unsigned char base = 10);
+    explicit String(float value, unsigned int decimalPlaces = 2);
+    explicit String(double value, unsigned int decimalPlaces = 2);
+    
+    String& operator=(const char* cstr);
+    
+    const char* c_str() const { return _s.c_str(); }
+    unsigned int length() const { return _s.length(); }
+    bool isEmpty() const { return _s.empty(); }
+    bool reserve(unsigned int size);
+    void clear() { _s.clear(); }
+    
+    bool concat(const String& str);
+    bool concat(const char* cstr);
+    bool concat(const char* cstr, unsigned int length);
+    bool concat(char c);
+    bool concat(unsigned char value);
+    bool concat(int value);
+    bool concat(unsigned int value);
+    bool concat(long value);
+    bool concat(unsigned long value);
+    bool concat(long long value);
+    bool concat(unsigned long long value);
+    bool concat(float value);
+    bool concat(double value);
+    
+    template <typename T>
+    String& operator+=(const T& rhs) {
+        concat(rhs);
+        return *this;
+    }
+    
+    bool equals(const String& s) const { return _s == s._s; }
+    bool equals(const char* cstr) const { return _s == (cstr ? cstr : ""); }
+    bool equalsIgnoreCase(const String& s) const;
+    int compareTo(const String& s) const { return _s.compare(s._s); }
+    bool startsWith(const String& prefix) const;
+    bool startsWith(const String& prefix, unsigned int offset) const;
+    bool endsWith(const String& suffix) const;
+    
+    char charAt(unsigned int index) const;
+    void setCharAt(unsigned int index, char c);
+    char operator[](unsigned int index) const { return charAt(index); }
+    char& operator[](unsigned int index);
+    void getBytes(unsigned char* buf, unsigned int bufsize, unsigned int index = 0) const;
+    void toCharArray(char* buf, unsigned int bufsize, unsigned int index = 0) const {
+        getBytes((unsigned char*)buf, bufsize, index);
+    }
+    const char* begin() const { return c_str(); }
+    const char* end() const { return c_str() + length(); }
+    
+    int indexOf(char ch, unsigned int fromIndex = 0) const;
+    int indexOf(const String& str, unsigned int fromIndex = 0) const;
+    int lastIndexOf(char ch) const;
+    int lastIndexOf(char ch, unsigned int fromIndex) const;
+    int lastIndexOf(const String& str) const;
+    int lastIndexOf(const String& str, unsigned int fromIndex) const;
+    String substring(unsigned int beginIndex) const;
+    String substring(unsigned int beginIndex, unsigned int endIndex) const;
+    
+    void replace(char find, char replace);
+    void replace(const String& find, const String& replace);
+    void remove(unsigned int index);
+    void remove(unsigned int index, unsigned int count);
+    void toLowerCase();
+    void toUpperCase();
+    void trim();
+    
+    long toInt() const;
+    float toFloat() const;
+    double toDouble() const;
+    
+    bool operator==(const String& rhs) const { return equals(rhs); }
+    bool operator==(const char* cstr) const { return equals(cstr); }
+    bool operator!=(const String& rhs) const { return !equals(rhs); }
+    bool operator!=(const char* cstr) const { return !equals(cstr); }
+    bool operator<(const String& rhs) const { return _s < rhs._s; }
+    bool operator>(const String& rhs) const { return _s > rhs._s; }
+    bool operator<=(const String& rhs) const { return _s <= rhs._s; }
+    bool operator>=(const String& rhs) const { return _s >= rhs._s; }
+
+private:
+    std::string _s;
+};
+
+inline bool operator==(const char* lhs, const String& rhs) { return rhs == lhs; }
+inline bool operator!=(const char* lhs, const String& rhs) { return rhs != lhs; }
+
+template <typename T>
+inline String operator+(const String& lhs, const T& rhs) {
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+inline String operator+(const char* lhs, const String& rhs) {
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+inline String operator+(char lhs, const String& rhs) {
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+#endif // SIM_WSTRING_H
@@ -0,0 +1,42 @@
+#ifndef SIM_WIFI_H
+#define SIM_WIFI_H
+
+#include <Arduino.h>
+
+typedef enum {
+    WIFI_OFF = 0,
+    WIFI_STA = 1,
+    WIFI_AP = 2,
+    WIFI_AP_STA = 3
+} wifi_mode_t;
+
+class IPAddress {
+public:
+    IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : _bytes{a, b, c, d} {}
+    
+    uint8_t operator[](int index) const { return _bytes[index]; }
+    String toString() const {
+        char text[16];
+        snprintf(text, sizeof(text), "%u.%u.%u.%u", _bytes[0], _bytes[1], _bytes[2], _bytes[3]);
+        return String(text);
+    }
+
+private:
+    uint8_t _bytes[4];
+};
+
+// No radio: the "access point" is the host, reachable on localhost
+class WiFiClass {
+public:
+    bool mode(wifi_mode_t mode) { return true; }
+    bool softAP(const char* ssid, const char* passphrase = nullptr, int channel = 1,
+                int hidden = 0, int maxConnections = 4) {
+        return true;
+    }
+    IPAddress softAPIP() { return IPAddress(127, 0, 0, 1); }
+    uint8_t softAPgetStationNum() { return 0; }
+};
+
+extern WiFiClass WiFi;
+
+#endif // SIM_WIFI_H
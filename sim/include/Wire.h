@@ -0,0 +1,15 @@
+#ifndef SIM_WIRE_H
+#define SIM_WIRE_H
+
+#include <Arduino.h>
+
+class TwoWire {
+public:
+    TwoWire(uint8_t bus = 0) {}
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0) { return true; }
+    void setClock(uint32_t frequency) {}
+};
+
+extern TwoWire Wire;
+
+#endif // SIM_WIRE_H
@@ -0,0 +1,44 @@
+#ifndef SIM_FREERTOS_H
+#define SIM_FREERTOS_H
+
+// FreeRTOS on host threads: one std::thread per task, 1 ms ticks. Priorities
+// and core affinity are accepted and ignored; the host scheduler decides.
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef void (*TaskFunction_t)(void*);
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+
+#define configTICK_RATE_HZ 1000
+#define configMAX_PRIORITIES 25
+#define portTICK_PERIOD_MS 1
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define tskIDLE_PRIORITY 0
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+// Critical sections are a spinlock: "ISRs" are host threads too
+typedef struct {
+    volatile int locked;
+} portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {0}
+
+void simEnterCritical(portMUX_TYPE* mux);
+void simExitCritical(portMUX_TYPE* mux);
+#define portENTER_CRITICAL(mux) simEnterCritical(mux)
+#define portEXIT_CRITICAL(mux) simExitCritical(mux)
+#define portENTER_CRITICAL_ISR(mux) simEnterCritical(mux)
+#define portEXIT_CRITICAL_ISR(mux) simExitCritical(mux)
+#define portYIELD_FROM_ISR(...) do {} while (0)
+
+BaseType_t xPortGetCoreID();
+
+#endif // SIM_FREERTOS_H
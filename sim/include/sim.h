@@ -0,0 +1,37 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <string>
+
+// Control surface of the host (native) build. Everything here stands in for
+// hardware: the firmware itself never includes this header.
+
+struct SimOptions {
+    std::string sdRoot = "sdcard";  // Host directory mounted as the SD card
+    std::string wavPath;            // I2S output recorded here; empty = discarded
+    std::string tagScript;          // Tag feed script; empty or "-" = stdin
+    uint16_t httpPort = 8080;       // Replaces WEB_SERVER_PORT (80 needs root)
+};
+
+SimOptions& simOptions();
+
+// GPIO: drive an input pin from the outside; attached interrupts fire on the
+// matching edge, in the calling thread
+void simGpioWrite(uint8_t pin, uint8_t level);
+
+// PN532 field: what a reader would see right now
+void simTagPlace(const uint8_t* uid, uint8_t length);
+void simTagRemove();
+
+// Runs a tag feed script (see sim/README.md) until it ends or says "quit"
+void simRunTagScript(const std::string& path);
+
+// Finishes the WAV file
+void simI2sClose();
+
+// Ends the process the way every exit path should: WAV file finished, output
+// flushed, no static destructors racing the still-running task threads
+[[noreturn]] void simExit(int code);
+
+#endif // SIM_H
@@ -0,0 +1,359 @@
+#include <Arduino.h>
+#include <SPI.h>
+#include <Wire.h>
+#include <WiFi.h>
+#include "sim.h"
+#include <unistd.h>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <thread>
+
+HardwareSerial Serial;
+EspClass ESP;
+SPIClass SPI(VSPI);
+TwoWire Wire(0);
+WiFiClass WiFi;
+
+// ============================================================================
+// Print / Stream
+// ============================================================================
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+        n += write(*buffer++);
+    }
+    return n;
+}
+
+size_t Print::write(const char* str) {
+    return str ? write((const uint8_t*)str, strlen(str)) : 0;
+}
+
+static size_t vprint(Print& out, const char* format, va_list args) {
+    char stackBuffer[256];
+    va_list copy;
+    va_copy(copy, args);
+    int len = vsnprintf(stackBuffer, sizeof(stackBuffer), format, copy);
+    va_end(copy);
+    if (len < 0) {
+        return 0;
+    }
+    if ((size_t)len < sizeof(stackBuffer)) {
+        return out.write((const uint8_t*)stackBuffer, len);
+    }
+    
+    char* buffer = (char*)malloc(len + 1);
+    if (!buffer) {
+        return 0;
+    }
+    vsnprintf(buffer, len + 1, format, args);
+    size_t n = out.write((const uint8_t*)buffer, len);
+    free(buffer);
+    return n;
+}
+
+size_t Print::printf(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    size_t n = vprint(*this, format, args);
+    va_end(args);
+    return n;
+}
+
+size_t Print::printf_P(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    size_t n = vprint(*this, format, args);
+    va_end(args);
+    return n;
+}
+
+size_t Print::print(long long value, int base) {
+    return print(String(value, (unsigned char)base));
+}
+
+size_t Print::print(unsigned long long value, int base) {
+    return print(String(value, (unsigned char)base));
+}
+
+size_t Print::print(double value, int digits) {
+    return print(String(value, (unsigned int)digits));
+}
+
+size_t Stream::readBytes(char* buffer, size_t length) {
+    size_t count = 0;
+    unsigned long start = millis();
+    while (count < length) {
+        int c = read();
+        if (c < 0) {
+            if (millis() - start >= _timeout) {
+                break;
+            }
+            delay(1);
+            continue;
+        }
+        buffer[count++] = (char)c;
+    }
+    return count;
+}
+
+String Stream::readString() {
+    String result;
+    int c;
+    while ((c = read()) >= 0) {
+        result += (char)c;
+    }
+    return result;
+}
+
+String Stream::readStringUntil(char terminator) {
+    String result;
+    int c;
+    while ((c = read()) >= 0 && c != terminator) {
+        result += (char)c;
+    }
+    return result;
+}
+
+// ============================================================================
+// Serial (stdout)
+// ============================================================================
+
+static std::mutex serialLock;
+
+size_t HardwareSerial::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    // One printf() is one write, so lines from different tasks don't mix
+    std::lock_guard<std::mutex> lock(serialLock);
+    return fwrite(buffer, 1, size, stdout);
+}
+
+void HardwareSerial::flush() {
+    std::lock_guard<std::mutex> lock(serialLock);
+    fflush(stdout);
+}
+
+// ============================================================================
+// Time
+// ============================================================================
+
+static const auto bootTime = std::chrono::steady_clock::now();
+
+unsigned long millis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - bootTime).count();
+}
+
+unsigned long micros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - bootTime).count();
+}
+
+void delay(uint32_t ms) {
+    vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+void delayMicroseconds(uint32_t us) {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield() {
+    std::this_thread::yield();
+}
+
+// ============================================================================
+// GPIO
+// ============================================================================
+
+static const uint8_t PIN_COUNT = 40;
+
+static struct {
+    volatile uint8_t level = HIGH;
+    void (*handler)(void) = nullptr;
+    int mode = 0;
+} pins[PIN_COUNT];
+
+static std::mutex pinLock;
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin < PIN_COUNT && (mode & PULLDOWN)) {
+        pins[pin].level = LOW;
+    }
+}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+    if (pin < PIN_COUNT) {
+        pins[pin].level = level ? HIGH : LOW;
+    }
+}
+
+int digitalRead(uint8_t pin) {
+    return pin < PIN_COUNT ? pins[pin].level : LOW;
+}
+
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode) {
+    if (pin < PIN_COUNT) {
+        std::lock_guard<std::mutex> lock(pinLock);
+        pins[pin].handler = handler;
+        pins[pin].mode = mode;
+    }
+}
+
+void detachInterrupt(uint8_t pin) {
+    if (pin < PIN_COUNT) {
+        std::lock_guard<std::mutex> lock(pinLock);
+        pins[pin].handler = nullptr;
+    }
+}
+
+void simGpioWrite(uint8_t pin, uint8_t level) {
+    if (pin >= PIN_COUNT) {
+        return;
+    }
+    
+    void (*handler)(void) = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(pinLock);
+        uint8_t previous = pins[pin].level;
+        pins[pin].level = level ? HIGH : LOW;
+        
+        int mode = pins[pin].mode;
+        bool falling = previous == HIGH && level == LOW;
+        bool rising = previous == LOW && level == HIGH;
+        if ((falling && (mode == FALLING || mode == CHANGE)) ||
+            (rising && (mode == RISING || mode == CHANGE)) ||
+            (level == LOW && mode == ONLOW) || (level == HIGH && mode == ONHIGH)) {
+            handler = pins[pin].handler;
+        }
+    }
+    if (handler) {
+        handler();
+    }
+}
+
+// ============================================================================
+// Misc core functions
+// ============================================================================
+
+static std::mt19937 rng;
+
+long random(long max) {
+    return max > 0 ? (long)(rng() % (unsigned long)max) : 0;
+}
+
+long random(long min, long max) {
+    return min < max ? min + random(max - min) : min;
+}
+
+void randomSeed(unsigned long seed) {
+    rng.seed(seed);
+}
+
+static uint32_t cpuFrequency = 240;
+
+bool setCpuFrequencyMhz(uint32_t mhz) {
+    cpuFrequency = mhz;
+    return true;
+}
+
+uint32_t getCpuFrequencyMhz() {
+    return cpuFrequency;
+}
+
+bool psramFound() {
+    return false;
+}
+
+void* ps_malloc(size_t size) {
+    return nullptr;
+}
+
+void* ps_calloc(size_t n, size_t size) {
+    return nullptr;
+}
+
+void* ps_realloc(void* ptr, size_t size) {
+    return nullptr;
+}
+
+#if !defined(__GLIBC__) || __GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38)
+extern "C" size_t strlcpy(char* dst, const char* src, size_t size) {
+    size_t len = strlen(src);
+    if (size > 0) {
+        size_t n = len < size - 1 ? len : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return len;
+}
+
+extern "C" size_t strlcat(char* dst, const char* src, size_t size) {
+    size_t used = strnlen(dst, size);
+    if (used == size) {
+        return size + strlen(src);
+    }
+    return used + strlcpy(dst + used, src, size - used);
+}
+#endif
+
+// ============================================================================
+// Heap
+// ============================================================================
+
+void* heap_caps_malloc(size_t size, uint32_t caps) {
+    return (caps & MALLOC_CAP_SPIRAM) ? nullptr : malloc(size);
+}
+
+void* heap_caps_calloc(size_t n, size_t size, uint32_t caps) {
+    return (caps & MALLOC_CAP_SPIRAM) ? nullptr : calloc(n, size);
+}
+
+void* heap_caps_realloc(void* ptr, size_t size, uint32_t caps) {
+    return (caps & MALLOC_CAP_SPIRAM) ? nullptr : realloc(ptr, size);
+}
+
+void heap_caps_free(void* ptr) {
+    free(ptr);
+}
+
+size_t heap_caps_get_total_size(uint32_t caps) {
+    return (caps & MALLOC_CAP_SPIRAM) ? 0 : SIM_INTERNAL_HEAP_SIZE;
+}
+
+size_t heap_caps_get_free_size(uint32_t caps) {
+    return (caps & MALLOC_CAP_SPIRAM) ? 0 : SIM_INTERNAL_HEAP_FREE;
+}
+
+size_t heap_caps_get_minimum_free_size(uint32_t caps) {
+    return heap_caps_get_free_size(caps);
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps) {
+    return heap_caps_get_free_size(caps);
+}
+
+uint32_t EspClass::getHeapSize() {
+    return heap_caps_get_total_size(MALLOC_CAP_INTERNAL);
+}
+
+uint32_t EspClass::getFreeHeap() {
+    return heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+}
+
+uint32_t EspClass::getMinFreeHeap() {
+    return heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+}
+
+uint32_t EspClass::getMaxAllocHeap() {
+    return heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL);
+}
+
+void EspClass::restart() {
+    Serial.println("ESP.restart(): exiting");
+    simExit(0);
+}
@@ -0,0 +1,847 @@
+#include <ESPAsyncWebServer.h>
+#include "sim.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <thread>
+
+// Everything that would run on the async_tcp task holds this
+static std::recursive_mutex tcpLock;
+
+static const size_t SEGMENT_SIZE = 1460;           // What one TCP segment would carry
+static const size_t MAX_HEAD_SIZE = 16384;
+static const unsigned long RESPONSE_TIMEOUT_MS = 30000;
+
+static bool sendAll(int fd, const void* data, size_t len) {
+    const char* p = (const char*)data;
+    while (len > 0) {
+        ssize_t n = ::send(fd, p, len, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+
+static String urlDecode(const String& text) {
+    String decoded;
+    decoded.reserve(text.length());
+    for (unsigned int i = 0; i < text.length(); i++) {
+        char c = text[i];
+        if (c == '%' && i + 2 < text.length() && isxdigit((unsigned char)text[i + 1]) &&
+            isxdigit((unsigned char)text[i + 2])) {
+            char hex[3] = { text[i + 1], text[i + 2], 0 };
+            decoded += (char)strtol(hex, nullptr, 16);
+            i += 2;
+        } else if (c == '+') {
+            decoded += ' ';
+        } else {
+            decoded += c;
+        }
+    }
+    return decoded;
+}
+
+static const char* statusText(int code) {
+    switch (code) {
+        case 200: return "OK";
+        case 201: return "Created";
+        case 204: return "No Content";
+        case 206: return "Partial Content";
+        case 304: return "Not Modified";
+        case 308: return "Permanent Redirect";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 413: return "Payload Too Large";
+        case 416: return "Range Not Satisfiable";
+        case 500: return "Internal Server Error";
+        case 503: return "Service Unavailable";
+        default: return "";
+    }
+}
+
+// ============================================================================
+// Request
+// ============================================================================
+
+AsyncWebServerRequest::~AsyncWebServerRequest() {
+    for (AsyncWebHeader* header : _headers) {
+        delete header;
+    }
+    for (AsyncWebParameter* param : _params) {
+        delete param;
+    }
+    delete _response;
+    free(_tempObject);
+}
+
+const char* AsyncWebServerRequest::methodToString() const {
+    switch (_method) {
+        case HTTP_GET: return "GET";
+        case HTTP_POST: return "POST";
+        case HTTP_DELETE: return "DELETE";
+        case HTTP_PUT: return "PUT";
+        case HTTP_PATCH: return "PATCH";
+        case HTTP_HEAD: return "HEAD";
+        case HTTP_OPTIONS: return "OPTIONS";
+        default: return "UNKNOWN";
+    }
+}
+
+bool AsyncWebServerRequest::hasHeader(const String& name) const {
+    return getHeader(name) != nullptr;
+}
+
+AsyncWebHeader* AsyncWebServerRequest::getHeader(const String& name) const {
+    for (AsyncWebHeader* header : _headers) {
+        if (header->name().equalsIgnoreCase(name)) {
+            return header;
+        }
+    }
+    return nullptr;
+}
+
+const String& AsyncWebServerRequest::header(const char* name) const {
+    static const String empty;
+    AsyncWebHeader* h = getHeader(name);
+    return h ? h->value() : empty;
+}
+
+bool AsyncWebServerRequest::hasParam(const String& name, bool post, bool file) const {
+    return getParam(name, post, file) != nullptr;
+}
+
+AsyncWebParameter* AsyncWebServerRequest::getParam(const String& name, bool post, bool file) const {
+    for (AsyncWebParameter* param : _params) {
+        if (param->name() == name && param->isPost() == post && param->isFile() == file) {
+            return param;
+        }
+    }
+    return nullptr;
+}
+
+AsyncWebParameter* AsyncWebServerRequest::getParam(size_t index) const {
+    return index < _params.size() ? _params[index] : nullptr;
+}
+
+bool AsyncWebServerRequest::hasArg(const char* name) const {
+    for (AsyncWebParameter* param : _params) {
+        if (param->name() == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const String& AsyncWebServerRequest::arg(const String& name) const {
+    static const String empty;
+    for (AsyncWebParameter* param : _params) {
+        if (param->name() == name) {
+            return param->value();
+        }
+    }
+    return empty;
+}
+
+void AsyncWebServerRequest::send(AsyncWebServerResponse* response) {
+    // Like the library: the first response wins, later ones are dropped
+    if (_response) {
+        delete response;
+        return;
+    }
+    _response = response;
+}
+
+void AsyncWebServerRequest::send(int code, const String& contentType, const String& content) {
+    send(beginResponse(code, contentType, content));
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(int code, const String& contentType,
+                                                             const String& content) {
+    return new AsyncBasicResponse(code, contentType, content);
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(const String& contentType, size_t len,
+                                                             AwsResponseFiller callback) {
+    return new AsyncCallbackResponse(contentType, len, callback);
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse_P(int code, const String& contentType,
+                                                               const uint8_t* content, size_t len) {
+    return new AsyncProgmemResponse(code, contentType, content, len);
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse_P(int code, const String& contentType,
+                                                               const char* content) {
+    return new AsyncProgmemResponse(code, contentType, (const uint8_t*)content, strlen(content));
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginChunkedResponse(const String& contentType,
+                                                                    AwsResponseFiller callback) {
+    return new AsyncChunkedResponse(contentType, callback);
+}
+
+AsyncResponseStream* AsyncWebServerRequest::beginResponseStream(const String& contentType, size_t bufferSize) {
+    return new AsyncResponseStream(contentType, bufferSize);
+}
+
+// ============================================================================
+// Responses
+// ============================================================================
+
+AsyncBasicResponse::AsyncBasicResponse(int code, const String& contentType, const String& content)
+    : AsyncWebServerResponse(code, contentType), _content(content) {
+    _contentLength = _content.length();
+}
+
+size_t AsyncBasicResponse::fill(uint8_t* buffer, size_t maxLen, size_t index) {
+    size_t n = std::min(maxLen, _content.length() - std::min(index, (size_t)_content.length()));
+    memcpy(buffer, _content.c_str() + index, n);
+    return n;
+}
+
+AsyncProgmemResponse::AsyncProgmemResponse(int code, const String& contentType, const uint8_t* content, size_t len)
+    : AsyncWebServerResponse(code, contentType), _content(content) {
+    _contentLength = len;
+}
+
+size_t AsyncProgmemResponse::fill(uint8_t* buffer, size_t maxLen, size_t index) {
+    size_t n = std::min(maxLen, _contentLength - std::min(index, _contentLength));
+    memcpy(buffer, _content + index, n);
+    return n;
+}
+
+AsyncCallbackResponse::AsyncCallbackResponse(const String& contentType, size_t len, AwsResponseFiller callback)
+    : AsyncWebServerResponse(200, contentType), _callback(callback) {
+    _contentLength = len;
+}
+
+size_t AsyncCallbackResponse::fill(uint8_t* buffer, size_t maxLen, size_t index) {
+    return _callback ? _callback(buffer, maxLen, index) : 0;
+}
+
+size_t AsyncResponseStream::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t AsyncResponseStream::write(const uint8_t* data, size_t len) {
+    _content.append((const char*)data, len);
+    _contentLength = _content.size();
+    return len;
+}
+
+size_t AsyncResponseStream::fill(uint8_t* buffer, size_t maxLen, size_t index) {
+    size_t n = std::min(maxLen, _content.size() - std::min(index, _content.size()));
+    memcpy(buffer, _content.data() + index, n);
+    return n;
+}
+
+// ============================================================================
+// Handlers
+// ============================================================================
+
+bool AsyncCallbackWebHandler::canHandle(AsyncWebServerRequest* request) {
+    // Same matching as the library: "prefix*", exact, or a sub-path
+    if (!_onRequest || !(_method & request->method())) {
+        return false;
+    }
+    if (_uri.length() && _uri.endsWith("*")) {
+        return request->url().startsWith(_uri.substring(0, _uri.length() - 1));
+    }
+    return !_uri.length() || _uri == request->url() || request->url().startsWith(_uri + "/");
+}
+
+void AsyncCallbackWebHandler::handleRequest(AsyncWebServerRequest* request) {
+    if (_onRequest) {
+        _onRequest(request);
+    } else {
+        request->send(500);
+    }
+}
+
+void AsyncCallbackWebHandler::handleUpload(AsyncWebServerRequest* request, const String& filename, size_t index,
+                                           uint8_t* data, size_t len, bool final) {
+    if (_onUpload) {
+        _onUpload(request, filename, index, data, len, final);
+    }
+}
+
+void AsyncCallbackWebHandler::handleBody(AsyncWebServerRequest* request, uint8_t* data, size_t len,
+                                         size_t index, size_t total) {
+    if (_onBody) {
+        _onBody(request, data, len, index, total);
+    }
+}
+
+// ============================================================================
+// Connection
+// ============================================================================
+
+class SimHttpConnection {
+public:
+    SimHttpConnection(AsyncWebServer* server, int fd) : _server(server), _fd(fd) {}
+    
+    void run();
+
+private:
+    bool readHead();
+    bool fillBuffer();
+    void parseQuery(const String& query, bool form);
+    AsyncWebHandler* findHandler();
+    bool readBody(AsyncWebHandler* handler);
+    bool readMultipart(AsyncWebHandler* handler, const String& boundary);
+    bool waitForResponse();
+    void writeResponse();
+    
+    AsyncWebServer* _server;
+    int _fd;
+    std::string _buffer;  // Received and not consumed yet
+    AsyncWebServerRequest _request;
+};
+
+bool SimHttpConnection::fillBuffer() {
+    char chunk[SEGMENT_SIZE];
+    ssize_t n = recv(_fd, chunk, sizeof(chunk), 0);
+    if (n <= 0) {
+        return false;
+    }
+    _buffer.append(chunk, n);
+    return true;
+}
+
+bool SimHttpConnection::readHead() {
+    size_t end;
+    while ((end = _buffer.find("\r\n\r\n")) == std::string::npos) {
+        if (_buffer.size() > MAX_HEAD_SIZE || !fillBuffer()) {
+            return false;
+        }
+    }
+    std::string head = _buffer.substr(0, end);
+    _buffer.erase(0, end + 4);
+    
+    size_t lineEnd = head.find("\r\n");
+    String requestLine = head.substr(0, lineEnd).c_str();
+    int space1 = requestLine.indexOf(' ');
+    int space2 = requestLine.indexOf(' ', space1 + 1);
+    if (space1 < 0 || space2 < 0) {
+        return false;
+    }
+    String method = requestLine.substring(0, space1);
+    String target = requestLine.substring(space1 + 1, space2);
+    
+    static const struct { const char* name; WebRequestMethod method; } methods[] = {
+        { "GET", HTTP_GET }, { "POST", HTTP_POST }, { "DELETE", HTTP_DELETE }, { "PUT", HTTP_PUT },
+        { "PATCH", HTTP_PATCH }, { "HEAD", HTTP_HEAD }, { "OPTIONS", HTTP_OPTIONS }
+    };
+    for (const auto& m : methods) {
+        if (method == m.name) {
+            _request._method = m.method;
+        }
+    }
+    
+    int question = target.indexOf('?');
+    _request._url = urlDecode(question < 0 ? target : target.substring(0, question));
+    if (question >= 0) {
+        parseQuery(target.substring(question + 1), false);
+    }
+    
+    while (lineEnd != std::string::npos) {
+        size_t start = lineEnd + 2;
+        lineEnd = head.find("\r\n", start);
+        String line = head.substr(start, lineEnd == std::string::npos ? std::string::npos : lineEnd - start).c_str();
+        int colon = line.indexOf(':');
+        if (colon <= 0) {
+            continue;
+        }
+        String name = line.substring(0, colon);
+        String value = line.substring(colon + 1);
+        value.trim();
+        _request._headers.push_back(new AsyncWebHeader(name, value));
+        if (name.equalsIgnoreCase("Content-Type")) {
+            _request._contentType = value;
+        } else if (name.equalsIgnoreCase("Content-Length")) {
+            _request._contentLength = strtoul(value.c_str(), nullptr, 10);
+        }
+    }
+    return true;
+}
+
+void SimHttpConnection::parseQuery(const String& query, bool form) {
+    int start = 0;
+    while (start < (int)query.length()) {
+        int amp = query.indexOf('&', start);
+        if (amp < 0) {
+            amp = query.length();
+        }
+        String pair = query.substring(start, amp);
+        int eq = pair.indexOf('=');
+        if (pair.length()) {
+            String name = urlDecode(eq < 0 ? pair : pair.substring(0, eq));
+            String value = eq < 0 ? String() : urlDecode(pair.substring(eq + 1));
+            _request._params.push_back(new AsyncWebParameter(name, value, form));
+        }
+        start = amp + 1;
+    }
+}
+
+AsyncWebHandler* SimHttpConnection::findHandler() {
+    for (AsyncWebHandler* handler : _server->_handlers) {
+        if (handler->canHandle(&_request)) {
+            return handler;
+        }
+    }
+    return nullptr;
+}
+
+// Form posts become parameters, multipart goes to the upload handler,
+// anything else to the body handler, a segment at a time
+bool SimHttpConnection::readBody(AsyncWebHandler* handler) {
+    size_t total = _request._contentLength;
+    if (total == 0) {
+        return true;
+    }
+    
+    String type = _request._contentType;
+    if (type.startsWith("multipart/form-data")) {
+        int b = type.indexOf("boundary=");
+        if (b < 0) {
+            return false;
+        }
+        String boundary = type.substring(b + 9);
+        boundary.replace("\"", "");
+        return readMultipart(handler, boundary);
+    }
+    
+    bool form = type.startsWith("application/x-www-form-urlencoded");
+    std::string formBody;
+    size_t index = 0;
+    while (index < total) {
+        if (_buffer.empty() && !fillBuffer()) {
+            return false;
+        }
+        size_t n = std::min(std::min(_buffer.size(), total - index), SEGMENT_SIZE);
+        if (form) {
+            formBody.append(_buffer, 0, n);
+        } else if (handler) {
+            std::lock_guard<std::recursive_mutex> lock(tcpLock);
+            handler->handleBody(&_request, (uint8_t*)&_buffer[0], n, index, total);
+        }
+        _buffer.erase(0, n);
+        index += n;
+    }
+    if (form) {
+        parseQuery(formBody.c_str(), true);
+    }
+    return true;
+}
+
+bool SimHttpConnection::readMultipart(AsyncWebHandler* handler, const String& boundary) {
+    // Streamed: everything but the bytes that could be the start of the
+    // next delimiter goes to the handler as soon as it arrives
+    std::string delimiter = std::string("--") + boundary.c_str();
+    std::string partDelimiter = "\r\n" + delimiter;
+    size_t remaining = _request._contentLength;
+    auto more = [&]() -> bool {
+        if (remaining == 0) {
+            return false;
+        }
+        size_t before = _buffer.size();
+        if (!fillBuffer()) {
+            return false;
+        }
+        remaining -= std::min(remaining, _buffer.size() - before);
+        return true;
+    };
+    remaining -= std::min(remaining, _buffer.size());
+    
+    size_t pos;
+    while ((pos = _buffer.find(delimiter)) == std::string::npos) {
+        if (!more()) {
+            return false;
+        }
+    }
+    _buffer.erase(0, pos + delimiter.size());
+    
+    for (;;) {
+        while (_buffer.size() < 2) {
+            if (!more()) {
+                return false;
+            }
+        }
+        if (_buffer.compare(0, 2, "--") == 0) {
+            break;  // Closing delimiter
+        }
+        
+        size_t headEnd;
+        while ((headEnd = _buffer.find("\r\n\r\n")) == std::string::npos) {
+            if (_buffer.size() > MAX_HEAD_SIZE || !more()) {
+                return false;
+            }
+        }
+        String partHead = _buffer.substr(0, headEnd).c_str();
+        _buffer.erase(0, headEnd + 4);
+        
+        String name, filename;
+        bool isFile = false;
+        int nameAt = partHead.indexOf(" name=\"");
+        if (nameAt >= 0) {
+            name = partHead.substring(nameAt + 7, partHead.indexOf('"', nameAt + 7));
+        }
+        int fileAt = partHead.indexOf("filename=\"");
+        if (fileAt >= 0) {
+            isFile = true;
+            filename = partHead.substring(fileAt + 10, partHead.indexOf('"', fileAt + 10));
+        }
+        
+        std::string value;
+        size_t index = 0;
+        for (;;) {
+            size_t end = _buffer.find(partDelimiter);
+            size_t safe = end != std::string::npos ? end
+                          : _buffer.size() > partDelimiter.size() ? _buffer.size() - partDelimiter.size() : 0;
+            while (safe > 0) {
+                size_t n = std::min(safe, SEGMENT_SIZE);
+                bool final = end != std::string::npos && n == safe;
+                if (isFile) {
+                    std::lock_guard<std::recursive_mutex> lock(tcpLock);
+                    if (handler) {
+                        handler->handleUpload(&_request, filename, index, (uint8_t*)&_buffer[0], n, final);
+                    }
+                } else {
+                    value.append(_buffer, 0, n);
+                }
+                _buffer.erase(0, n);
+                index += n;
+                safe -= n;
+                if (end != std::string::npos) {
+                    end -= n;
+                }
+            }
+            if (end != std::string::npos) {
+                if (isFile && index == 0 && handler) {
+                    std::lock_guard<std::recursive_mutex> lock(tcpLock);
+                    handler->handleUpload(&_request, filename, 0, (uint8_t*)&_buffer[0], 0, true);
+                }
+                _buffer.erase(0, partDelimiter.size());
+                break;
+            }
+            if (!more()) {
+                return false;
+            }
+        }
+        if (!isFile) {
+            _request._params.push_back(new AsyncWebParameter(name, value.c_str(), true));
+        }
+    }
+    return true;
+}
+
+bool SimHttpConnection::waitForResponse() {
+    // Handlers may answer later (from a body callback, say); give up when
+    // the client does
+    unsigned long start = millis();
+    for (;;) {
+        {
+            std::lock_guard<std::recursive_mutex> lock(tcpLock);
+            if (_request._response) {
+                return true;
+            }
+        }
+        if (millis() - start > RESPONSE_TIMEOUT_MS) {
+            return false;
+        }
+        char probe;
+        if (recv(_fd, &probe, 1, MSG_PEEK | MSG_DONTWAIT) == 0) {
+            return false;
+        }
+        delay(5);
+    }
+}
+
+void SimHttpConnection::writeResponse() {
+    AsyncWebServerResponse* response = _request._response;
+    bool chunked = response->chunked();
+    bool persistent = response->persistent();
+    
+    String head = "HTTP/1.1 " + String(response->_code) + " " + statusText(response->_code) + "\r\n";
+    if (response->_contentType.length()) {
+        head += "Content-Type: " + response->_contentType + "\r\n";
+    }
+    if (chunked) {
+        head += "Transfer-Encoding: chunked\r\n";
+    } else if (!persistent) {
+        head += "Content-Length: " + String((unsigned long)response->_contentLength) + "\r\n";
+    }
+    for (const AsyncWebHeader& header : response->_headers) {
+        head += header.name() + ": " + header.value() + "\r\n";
+    }
+    head += persistent ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    if (!sendAll(_fd, head.c_str(), head.length())) {
+        return;
+    }
+    
+    if (persistent) {
+        response->adopt(_fd);
+        return;
+    }
+    
+    uint8_t buffer[SEGMENT_SIZE];
+    size_t index = 0;
+    for (;;) {
+        size_t maxLen = sizeof(buffer);
+        if (!chunked) {
+            if (index >= response->_contentLength) {
+                break;
+            }
+            maxLen = std::min(maxLen, response->_contentLength - index);
+        }
+        
+        size_t n;
+        {
+            std::lock_guard<std::recursive_mutex> lock(tcpLock);
+            n = response->fill(buffer, maxLen, index);
+        }
+        if (n == RESPONSE_TRY_AGAIN) {
+            delay(1);
+            continue;
+        }
+        if (n == 0) {
+            break;
+        }
+        n = std::min(n, maxLen);
+        
+        if (chunked) {
+            char size[16];
+            snprintf(size, sizeof(size), "%zx\r\n", n);
+            if (!sendAll(_fd, size, strlen(size)) || !sendAll(_fd, buffer, n) || !sendAll(_fd, "\r\n", 2)) {
+                return;
+            }
+        } else if (!sendAll(_fd, buffer, n)) {
+            return;
+        }
+        index += n;
+    }
+    if (chunked) {
+        sendAll(_fd, "0\r\n\r\n", 5);
+    }
+}
+
+void SimHttpConnection::run() {
+    if (readHead()) {
+        AsyncWebHandler* handler;
+        {
+            std::lock_guard<std::recursive_mutex> lock(tcpLock);
+            handler = findHandler();
+        }
+        
+        if (readBody(handler)) {
+            {
+                std::lock_guard<std::recursive_mutex> lock(tcpLock);
+                if (handler) {
+                    handler->handleRequest(&_request);
+                } else if (_server->_notFound) {
+                    _server->_notFound(&_request);
+                } else {
+                    _request.send(404);
+                }
+            }
+            if (waitForResponse()) {
+                writeResponse();
+            }
+        }
+    }
+    
+    shutdown(_fd, SHUT_RDWR);
+    close(_fd);
+    
+    std::lock_guard<std::recursive_mutex> lock(tcpLock);
+    if (_request._onDisconnect) {
+        _request._onDisconnect();
+    }
+}
+
+// ============================================================================
+// Server
+// ============================================================================
+
+AsyncWebServer::AsyncWebServer(uint16_t port) : _port(port), _listenFd(-1) {}
+
+AsyncWebServer::~AsyncWebServer() {
+    end();
+    for (AsyncWebHandler* handler : _handlers) {
+        delete handler;
+    }
+}
+
+void AsyncWebServer::begin() {
+    // The firmware's port (80) would need root; --http-port replaces it
+    _port = simOptions().httpPort;
+    _listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    int yes = 1;
+    setsockopt(_listenFd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(_port);
+    if (bind(_listenFd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(_listenFd, 8) != 0) {
+        fprintf(stderr, "sim: can't listen on port %u\n", (unsigned)_port);
+        close(_listenFd);
+        _listenFd = -1;
+        return;
+    }
+    printf("sim: web server on http://localhost:%u/\n", (unsigned)_port);
+    
+    std::thread accepter(&AsyncWebServer::acceptLoop, this);
+    pthread_setname_np(accepter.native_handle(), "async_tcp");
+    accepter.detach();
+}
+
+void AsyncWebServer::end() {
+    if (_listenFd >= 0) {
+        shutdown(_listenFd, SHUT_RDWR);
+        close(_listenFd);
+        _listenFd = -1;
+    }
+}
+
+void AsyncWebServer::acceptLoop() {
+    for (;;) {
+        int listenFd = _listenFd;
+        if (listenFd < 0) {
+            return;
+        }
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        int yes = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+        
+        std::thread([this, fd]() {
+            SimHttpConnection connection(this, fd);
+            connection.run();
+        }).detach();
+    }
+}
+
+AsyncWebHandler& AsyncWebServer::addHandler(AsyncWebHandler* handler) {
+    std::lock_guard<std::recursive_mutex> lock(tcpLock);
+    _handlers.push_back(handler);
+    return *handler;
+}
+
+AsyncCallbackWebHandler& AsyncWebServer::on(const char* uri, WebRequestMethodComposite method,
+                                            ArRequestHandlerFunction onRequest, ArUploadHandlerFunction onUpload,
+                                            ArBodyHandlerFunction onBody) {
+    AsyncCallbackWebHandler* handler = new AsyncCallbackWebHandler(uri, method, onRequest, onUpload, onBody);
+    addHandler(handler);
+    return *handler;
+}
+
+// ============================================================================
+// Server-sent events
+// ============================================================================
+
+static String eventMessage(const char* message, const char* event, uint32_t id, uint32_t reconnect) {
+    String text;
+    if (reconnect) {
+        text += "retry: " + String(reconnect) + "\r\n";
+    }
+    if (id) {
+        text += "id: " + String(id) + "\r\n";
+    }
+    if (event) {
+        text += "event: " + String(event) + "\r\n";
+    }
+    if (message) {
+        // One data: line per message line
+        const char* line = message;
+        while (*line) {
+            size_t len = strcspn(line, "\r\n");
+            text += "data: " + String(line, len) + "\r\n";
+            line += len;
+            line += (*line == '\r' && line[1] == '\n') ? 2 : (*line ? 1 : 0);
+        }
+    }
+    return text + "\r\n";
+}
+
+void AsyncEventSourceClient::send(const char* message, const char* event, uint32_t id, uint32_t reconnect) {
+    String text = eventMessage(message, event, id, reconnect);
+    std::lock_guard<std::mutex> lock(_writeLock);
+    if (_fd >= 0 && sendAll(_fd, text.c_str(), text.length())) {
+        _lastId = id;
+    }
+}
+
+AsyncEventSourceResponse::AsyncEventSourceResponse(AsyncEventSource* source)
+    : AsyncWebServerResponse(200, "text/event-stream"), _source(source) {
+    addHeader("Cache-Control", "no-cache");
+}
+
+bool AsyncEventSource::canHandle(AsyncWebServerRequest* request) {
+    return request->method() == HTTP_GET && request->url() == _url;
+}
+
+void AsyncEventSource::handleRequest(AsyncWebServerRequest* request) {
+    request->send(new AsyncEventSourceResponse(this));
+}
+
+void AsyncEventSource::serve(int fd) {
+    AsyncEventSourceClient* client = new AsyncEventSourceClient(this, fd);
+    {
+        std::lock_guard<std::recursive_mutex> lock(tcpLock);
+        {
+            std::lock_guard<std::mutex> clients(_clientsLock);
+            _clients.push_back(client);
+        }
+        if (_connectCb) {
+            _connectCb(client);
+        }
+    }
+    
+    // Nothing is expected from the browser; a read returning means it left
+    char discard[64];
+    while (recv(fd, discard, sizeof(discard), 0) > 0) {
+    }
+    
+    std::lock_guard<std::mutex> clients(_clientsLock);
+    _clients.erase(std::remove(_clients.begin(), _clients.end(), client), _clients.end());
+    {
+        std::lock_guard<std::mutex> lock(client->_writeLock);
+        client->_fd = -1;
+    }
+    delete client;
+}
+
+void AsyncEventSource::send(const char* message, const char* event, uint32_t id, uint32_t reconnect) {
+    std::lock_guard<std::mutex> lock(_clientsLock);
+    for (AsyncEventSourceClient* client : _clients) {
+        client->send(message, event, id, reconnect);
+    }
+}
+
+size_t AsyncEventSource::count() {
+    std::lock_guard<std::mutex> lock(_clientsLock);
+    return _clients.size();
+}
+
+void AsyncEventSource::close() {
+    std::lock_guard<std::mutex> lock(_clientsLock);
+    for (AsyncEventSourceClient* client : _clients) {
+        std::lock_guard<std::mutex> write(client->_writeLock);
+        if (client->_fd >= 0) {
+            shutdown(client->_fd, SHUT_RDWR);
+        }
+    }
+}
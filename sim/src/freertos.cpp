@@ -0,0 +1,441 @@
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/event_groups.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+unsigned long millis();
+
+// ============================================================================
+// Waiting helpers
+// ============================================================================
+
+// Waits until pred() holds or the ticks (1 ms each) run out
+template <typename Pred>
+static bool waitFor(std::unique_lock<std::mutex>& lock, std::condition_variable& cv,
+                    TickType_t ticks, Pred pred) {
+    if (ticks == portMAX_DELAY) {
+        cv.wait(lock, pred);
+        return true;
+    }
+    return cv.wait_for(lock, std::chrono::milliseconds(ticks), pred);
+}
+
+// ============================================================================
+// Critical sections
+// ============================================================================
+
+void simEnterCritical(portMUX_TYPE* mux) {
+    while (__atomic_exchange_n(&mux->locked, 1, __ATOMIC_ACQUIRE)) {
+        sched_yield();
+    }
+}
+
+void simExitCritical(portMUX_TYPE* mux) {
+    __atomic_store_n(&mux->locked, 0, __ATOMIC_RELEASE);
+}
+
+BaseType_t xPortGetCoreID() {
+    return 0;
+}
+
+// ============================================================================
+// Tasks
+// ============================================================================
+
+struct SimTask {
+    std::string name;
+    uint32_t stackDepth;
+    std::mutex lock;
+    std::condition_variable notified;
+    uint32_t notifications = 0;
+};
+
+static thread_local SimTask* currentTask = nullptr;
+
+// Threads the sim didn't start itself (main, web connections, tag feed) get
+// a task record on first use, so notifications and mutex owners work
+static SimTask* taskForThisThread() {
+    if (!currentTask) {
+        char name[16] = "thread";
+        pthread_getname_np(pthread_self(), name, sizeof(name));
+        currentTask = new SimTask();
+        currentTask->name = name;
+        currentTask->stackDepth = 0;
+    }
+    return currentTask;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stackDepth,
+                                   void* param, UBaseType_t priority, TaskHandle_t* created,
+                                   BaseType_t coreId) {
+    SimTask* task = new SimTask();
+    task->name = name ? name : "";
+    task->stackDepth = stackDepth;
+    if (created) {
+        *created = task;
+    }
+    
+    std::thread([task, code, param]() {
+        currentTask = task;
+        // Named like the firmware task, for top/perf/gdb (15 chars max)
+        pthread_setname_np(pthread_self(), task->name.substr(0, 15).c_str());
+        code(param);
+    }).detach();
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char* name, uint32_t stackDepth,
+                       void* param, UBaseType_t priority, TaskHandle_t* created) {
+    return xTaskCreatePinnedToCore(code, name, stackDepth, param, priority, created, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if (task == nullptr || task == currentTask) {
+        pthread_exit(nullptr);
+    }
+}
+
+void vTaskDelay(TickType_t ticks) {
+    if (ticks == 0) {
+        sched_yield();
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+TickType_t xTaskGetTickCount() {
+    return (TickType_t)millis();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    return taskForThisThread();
+}
+
+const char* pcTaskGetName(TaskHandle_t task) {
+    return (task ? task : taskForThisThread())->name.c_str();
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    return (task ? task : taskForThisThread())->stackDepth;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+    SimTask* task = taskForThisThread();
+    std::unique_lock<std::mutex> lock(task->lock);
+    if (!waitFor(lock, task->notified, ticks, [task]() { return task->notifications > 0; })) {
+        return 0;
+    }
+    
+    uint32_t value = task->notifications;
+    task->notifications = clearOnExit ? 0 : value - 1;
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    {
+        std::lock_guard<std::mutex> lock(task->lock);
+        task->notifications++;
+    }
+    task->notified.notify_all();
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken) {
+    xTaskNotifyGive(task);
+    if (higherPriorityTaskWoken) {
+        *higherPriorityTaskWoken = pdFALSE;
+    }
+}
+
+// ============================================================================
+// Queues
+// ============================================================================
+
+struct SimQueue {
+    std::mutex lock;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::vector<uint8_t> storage;  // length slots of itemSize bytes
+    UBaseType_t length;
+    UBaseType_t itemSize;
+    UBaseType_t head = 0;
+    UBaseType_t count = 0;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    SimQueue* queue = new SimQueue();
+    queue->length = length;
+    queue->itemSize = itemSize;
+    queue->storage.resize((size_t)length * itemSize);
+    return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+    delete queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks) {
+    {
+        std::unique_lock<std::mutex> lock(queue->lock);
+        if (!waitFor(lock, queue->notFull, ticks, [queue]() { return queue->count < queue->length; })) {
+            return pdFALSE;
+        }
+        UBaseType_t tail = (queue->head + queue->count) % queue->length;
+        memcpy(&queue->storage[(size_t)tail * queue->itemSize], item, queue->itemSize);
+        queue->count++;
+    }
+    queue->notEmpty.notify_one();
+    return pdTRUE;
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void* item, TickType_t ticks) {
+    return xQueueSend(queue, item, ticks);
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void* item) {
+    {
+        std::lock_guard<std::mutex> lock(queue->lock);
+        queue->head = 0;
+        queue->count = 1;
+        memcpy(&queue->storage[0], item, queue->itemSize);
+    }
+    queue->notEmpty.notify_one();
+    return pdPASS;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void* item, BaseType_t* higherPriorityTaskWoken) {
+    if (higherPriorityTaskWoken) {
+        *higherPriorityTaskWoken = pdFALSE;
+    }
+    return xQueueSend(queue, item, 0);
+}
+
+static BaseType_t receive(QueueHandle_t queue, void* item, TickType_t ticks, bool remove) {
+    {
+        std::unique_lock<std::mutex> lock(queue->lock);
+        if (!waitFor(lock, queue->notEmpty, ticks, [queue]() { return queue->count > 0; })) {
+            return pdFALSE;
+        }
+        memcpy(item, &queue->storage[(size_t)queue->head * queue->itemSize], queue->itemSize);
+        if (!remove) {
+            return pdTRUE;
+        }
+        queue->head = (queue->head + 1) % queue->length;
+        queue->count--;
+    }
+    queue->notFull.notify_one();
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks) {
+    return receive(queue, item, ticks, true);
+}
+
+BaseType_t xQueueReceiveFromISR(QueueHandle_t queue, void* item, BaseType_t* higherPriorityTaskWoken) {
+    if (higherPriorityTaskWoken) {
+        *higherPriorityTaskWoken = pdFALSE;
+    }
+    return receive(queue, item, 0, true);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void* item, TickType_t ticks) {
+    return receive(queue, item, ticks, false);
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue) {
+    {
+        std::lock_guard<std::mutex> lock(queue->lock);
+        queue->head = 0;
+        queue->count = 0;
+    }
+    queue->notFull.notify_all();
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    std::lock_guard<std::mutex> lock(queue->lock);
+    return queue->count;
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue) {
+    std::lock_guard<std::mutex> lock(queue->lock);
+    return queue->length - queue->count;
+}
+
+// ============================================================================
+// Semaphores and mutexes
+// ============================================================================
+
+struct SimSemaphore {
+    std::mutex lock;
+    std::condition_variable changed;
+    bool isMutex;
+    bool recursive;
+    UBaseType_t count;     // Counting/binary
+    UBaseType_t maxCount;
+    SimTask* holder = nullptr;  // Mutexes
+    UBaseType_t depth = 0;
+};
+
+static SimSemaphore* createSemaphore(bool isMutex, bool recursive, UBaseType_t maxCount, UBaseType_t count) {
+    SimSemaphore* semaphore = new SimSemaphore();
+    semaphore->isMutex = isMutex;
+    semaphore->recursive = recursive;
+    semaphore->maxCount = maxCount;
+    semaphore->count = count;
+    return semaphore;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary() {
+    return createSemaphore(false, false, 1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initialCount) {
+    return createSemaphore(false, false, maxCount, initialCount);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return createSemaphore(true, false, 1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() {
+    return createSemaphore(true, true, 1, 1);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) {
+    delete semaphore;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks) {
+    SimTask* self = taskForThisThread();
+    std::unique_lock<std::mutex> lock(semaphore->lock);
+    
+    if (!semaphore->isMutex) {
+        if (!waitFor(lock, semaphore->changed, ticks, [semaphore]() { return semaphore->count > 0; })) {
+            return pdFALSE;
+        }
+        semaphore->count--;
+        return pdTRUE;
+    }
+    
+    if (semaphore->recursive && semaphore->holder == self) {
+        semaphore->depth++;
+        return pdTRUE;
+    }
+    if (!waitFor(lock, semaphore->changed, ticks, [semaphore]() { return semaphore->holder == nullptr; })) {
+        return pdFALSE;
+    }
+    semaphore->holder = self;
+    semaphore->depth = 1;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+    {
+        std::lock_guard<std::mutex> lock(semaphore->lock);
+        if (semaphore->isMutex) {
+            if (semaphore->holder != taskForThisThread() || semaphore->depth == 0) {
+                return pdFALSE;
+            }
+            if (--semaphore->depth > 0) {
+                return pdTRUE;
+            }
+            semaphore->holder = nullptr;
+        } else {
+            if (semaphore->count >= semaphore->maxCount) {
+                return pdFALSE;
+            }
+            semaphore->count++;
+        }
+    }
+    semaphore->changed.notify_all();
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore, BaseType_t* higherPriorityTaskWoken) {
+    if (higherPriorityTaskWoken) {
+        *higherPriorityTaskWoken = pdFALSE;
+    }
+    return xSemaphoreGive(semaphore);
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t semaphore, TickType_t ticks) {
+    return xSemaphoreTake(semaphore, ticks);
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t semaphore) {
+    return xSemaphoreGive(semaphore);
+}
+
+TaskHandle_t xSemaphoreGetMutexHolder(SemaphoreHandle_t semaphore) {
+    std::lock_guard<std::mutex> lock(semaphore->lock);
+    return semaphore->holder;
+}
+
+// ============================================================================
+// Event groups
+// ============================================================================
+
+struct SimEventGroup {
+    std::mutex lock;
+    std::condition_variable changed;
+    EventBits_t bits = 0;
+};
+
+EventGroupHandle_t xEventGroupCreate() {
+    return new SimEventGroup();
+}
+
+void vEventGroupDelete(EventGroupHandle_t group) {
+    delete group;
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits) {
+    EventBits_t value;
+    {
+        std::lock_guard<std::mutex> lock(group->lock);
+        group->bits |= bits;
+        value = group->bits;
+    }
+    group->changed.notify_all();
+    return value;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits) {
+    std::lock_guard<std::mutex> lock(group->lock);
+    EventBits_t value = group->bits;  // Like FreeRTOS: the bits before clearing
+    group->bits &= ~bits;
+    return value;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group) {
+    std::lock_guard<std::mutex> lock(group->lock);
+    return group->bits;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clearOnExit,
+                                BaseType_t waitForAll, TickType_t ticks) {
+    std::unique_lock<std::mutex> lock(group->lock);
+    auto satisfied = [group, bits, waitForAll]() {
+        return waitForAll ? (group->bits & bits) == bits : (group->bits & bits) != 0;
+    };
+    if (!waitFor(lock, group->changed, ticks, satisfied)) {
+        return group->bits;
+    }
+    
+    EventBits_t value = group->bits;
+    if (clearOnExit) {
+        group->bits &= ~bits;
+    }
+    return value;
+}
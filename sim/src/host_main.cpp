@@ -0,0 +1,84 @@
+#include <Arduino.h>
+#include "sim.h"
+#include <pthread.h>
+#include <signal.h>
+#include <thread>
+#include <unistd.h>
+
+SimOptions& simOptions() {
+    static SimOptions options;
+    return options;
+}
+
+void simExit(int code) {
+    simI2sClose();
+    fflush(stdout);
+    fflush(stderr);
+    _exit(code);
+}
+
+// Unit tests (pio test -e native) bring their own main()
+#ifndef PIO_UNIT_TESTING
+
+static void usage(const char* program) {
+    printf("Usage: %s [options]\n"
+           "  --sd DIR          Host directory used as the SD card (default: sdcard)\n"
+           "  --wav FILE        Record the I2S output to a WAV file\n"
+           "  --tags FILE       Tag feed script; - reads commands from stdin (default)\n"
+           "  --http-port PORT  Web server port (default: 8080)\n",
+           program);
+}
+
+// Ctrl-C and kill end the run cleanly. Handled on a thread of its own so
+// the WAV sink is never entered from a signal handler.
+static void waitForSignal(sigset_t signals) {
+    int signal;
+    sigwait(&signals, &signal);
+    simExit(0);
+}
+
+int main(int argc, char** argv) {
+    SimOptions& options = simOptions();
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--sd" && hasValue) {
+            options.sdRoot = argv[++i];
+        } else if (arg == "--wav" && hasValue) {
+            options.wavPath = argv[++i];
+        } else if (arg == "--tags" && hasValue) {
+            options.tagScript = argv[++i];
+        } else if (arg == "--http-port" && hasValue) {
+            options.httpPort = atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+    
+    setvbuf(stdout, nullptr, _IOLBF, 0);
+    signal(SIGPIPE, SIG_IGN);
+    
+    // Blocked before any other thread exists, so every thread inherits it
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    std::thread(waitForSignal, signals).detach();
+    
+    // Same shape as the Arduino core: setup() once, then loop() forever on
+    // the loopTask
+    pthread_setname_np(pthread_self(), "loopTask");
+    setup();
+    
+    std::thread feed(simRunTagScript, options.tagScript);
+    pthread_setname_np(feed.native_handle(), "tag_feed");
+    feed.detach();
+    
+    for (;;) {
+        loop();
+    }
+}
+
+#endif // PIO_UNIT_TESTING
@@ -0,0 +1,292 @@
+#include <driver/i2s.h>
+#include "sim.h"
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static const size_t FRAME_BYTES = 2 * sizeof(int16_t);
+
+// ============================================================================
+// WAV sink
+// ============================================================================
+
+// Everything the ports play, silence gaps included up to MAX_SILENCE_MS so an
+// idle box doesn't fill the disk. The header is patched on close.
+class WavSink {
+public:
+    static const uint32_t MAX_SILENCE_MS = 1000;
+    
+    void open(const std::string& path) {
+        std::lock_guard<std::mutex> lock(_lock);
+        if (_file || path.empty()) {
+            return;
+        }
+        _file = fopen(path.c_str(), "wb");
+        if (!_file) {
+            fprintf(stderr, "sim: can't write %s\n", path.c_str());
+            return;
+        }
+        uint8_t header[44] = {};
+        fwrite(header, 1, sizeof(header), _file);
+        _dataBytes = 0;
+        _silentFrames = 0;
+    }
+    
+    void write(const uint8_t* data, size_t frames, bool silent, uint32_t rate) {
+        std::lock_guard<std::mutex> lock(_lock);
+        if (!_file) {
+            return;
+        }
+        _rate = rate;
+        if (silent) {
+            size_t limit = (size_t)rate * MAX_SILENCE_MS / 1000;
+            if (_silentFrames >= limit) {
+                return;
+            }
+            frames = std::min(frames, limit - _silentFrames);
+            _silentFrames += frames;
+        } else {
+            _silentFrames = 0;
+        }
+        _dataBytes += fwrite(data, 1, frames * FRAME_BYTES, _file);
+    }
+    
+    void close() {
+        std::lock_guard<std::mutex> lock(_lock);
+        if (!_file) {
+            return;
+        }
+        uint8_t header[44];
+        memcpy(header, "RIFF", 4);
+        put32(header + 4, 36 + _dataBytes);
+        memcpy(header + 8, "WAVEfmt ", 8);
+        put32(header + 16, 16);
+        put16(header + 20, 1);               // PCM
+        put16(header + 22, 2);               // Stereo
+        put32(header + 24, _rate);
+        put32(header + 28, _rate * FRAME_BYTES);
+        put16(header + 32, FRAME_BYTES);
+        put16(header + 34, 16);
+        memcpy(header + 36, "data", 4);
+        put32(header + 40, _dataBytes);
+        fseek(_file, 0, SEEK_SET);
+        fwrite(header, 1, sizeof(header), _file);
+        fclose(_file);
+        _file = nullptr;
+    }
+
+private:
+    static void put16(uint8_t* p, uint16_t v) {
+        p[0] = v;
+        p[1] = v >> 8;
+    }
+    
+    static void put32(uint8_t* p, uint32_t v) {
+        put16(p, v);
+        put16(p + 2, v >> 16);
+    }
+    
+    std::mutex _lock;
+    FILE* _file = nullptr;
+    uint32_t _dataBytes = 0;
+    uint32_t _rate = 44100;
+    size_t _silentFrames = 0;
+};
+
+static WavSink& wavSink = *new WavSink();
+
+void simI2sClose() {
+    wavSink.close();
+}
+
+// ============================================================================
+// Ports
+// ============================================================================
+
+struct I2sPort {
+    bool installed = false;
+    std::atomic<bool> running{false};
+    std::thread clock;
+    
+    std::mutex lock;
+    std::condition_variable space;  // Signalled whenever the clock takes a buffer
+    
+    // The DMA ring, as a byte FIFO of dma_buf_count buffers
+    std::vector<uint8_t> ring;
+    size_t head = 0;
+    size_t fill = 0;
+    size_t bufferBytes = 0;
+    uint32_t rate = 44100;
+    
+    QueueHandle_t events = nullptr;
+};
+
+// Never destroyed: the clock threads outlive main()
+static I2sPort* const ports = new I2sPort[I2S_NUM_MAX];
+
+static void postEvent(I2sPort& port, i2s_event_type_t type) {
+    if (!port.events) {
+        return;
+    }
+    // The ISR drops the oldest event when nobody has been reading them
+    i2s_event_t event = { type, port.bufferBytes };
+    if (xQueueSendFromISR(port.events, &event, nullptr) != pdTRUE) {
+        i2s_event_t dropped;
+        xQueueReceiveFromISR(port.events, &dropped, nullptr);
+        xQueueSendFromISR(port.events, &event, nullptr);
+    }
+}
+
+// One buffer per period: a full buffer if the ring has one, otherwise what
+// is there followed by silence, reported as TX_Q_OVF like an underrun
+static void clockTask(I2sPort* port) {
+    std::vector<uint8_t> buffer;
+    auto next = std::chrono::steady_clock::now();
+    
+    while (port->running) {
+        uint32_t rate;
+        size_t take;
+        {
+            std::lock_guard<std::mutex> lock(port->lock);
+            rate = port->rate;
+            buffer.assign(port->bufferBytes, 0);
+            
+            take = std::min(port->fill, port->bufferBytes);
+            for (size_t i = 0; i < take; i++) {
+                buffer[i] = port->ring[(port->head + i) % port->ring.size()];
+            }
+            port->head = (port->head + take) % port->ring.size();
+            port->fill -= take;
+        }
+        port->space.notify_all();
+        
+        wavSink.write(buffer.data(), buffer.size() / FRAME_BYTES, take == 0, rate);
+        if (take < port->bufferBytes) {
+            postEvent(*port, I2S_EVENT_TX_Q_OVF);
+        }
+        postEvent(*port, I2S_EVENT_TX_DONE);
+        
+        next += std::chrono::microseconds(1000000ULL * (port->bufferBytes / FRAME_BYTES) / rate);
+        std::this_thread::sleep_until(next);
+    }
+}
+
+esp_err_t i2s_driver_install(i2s_port_t num, const i2s_config_t* config, int queueSize,
+                             QueueHandle_t* queue) {
+    if (num >= I2S_NUM_MAX || !config || config->bits_per_sample != I2S_BITS_PER_SAMPLE_16BIT ||
+        config->dma_buf_count < 2 || config->dma_buf_len < 8 || config->sample_rate == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    I2sPort& port = ports[num];
+    if (port.installed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    port.bufferBytes = config->dma_buf_len * FRAME_BYTES;
+    port.ring.assign(port.bufferBytes * config->dma_buf_count, 0);
+    port.head = 0;
+    port.fill = 0;
+    port.rate = config->sample_rate;
+    port.events = nullptr;
+    if (queue && queueSize > 0) {
+        port.events = xQueueCreate(queueSize, sizeof(i2s_event_t));
+        *queue = port.events;
+    }
+    
+    static bool sinkOpened = false;
+    if (!sinkOpened) {
+        sinkOpened = true;
+        wavSink.open(simOptions().wavPath);
+    }
+    
+    port.installed = true;
+    port.running = true;
+    port.clock = std::thread(clockTask, &port);
+    pthread_setname_np(port.clock.native_handle(), "i2s_dma");
+    return ESP_OK;
+}
+
+esp_err_t i2s_driver_uninstall(i2s_port_t num) {
+    if (num >= I2S_NUM_MAX || !ports[num].installed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    I2sPort& port = ports[num];
+    port.running = false;
+    port.clock.join();
+    if (port.events) {
+        vQueueDelete(port.events);
+        port.events = nullptr;
+    }
+    port.installed = false;
+    return ESP_OK;
+}
+
+esp_err_t i2s_set_pin(i2s_port_t num, const i2s_pin_config_t* pins) {
+    return num < I2S_NUM_MAX && ports[num].installed ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t i2s_set_sample_rates(i2s_port_t num, uint32_t rate) {
+    if (num >= I2S_NUM_MAX || !ports[num].installed || rate == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    std::lock_guard<std::mutex> lock(ports[num].lock);
+    ports[num].rate = rate;
+    return ESP_OK;
+}
+
+esp_err_t i2s_zero_dma_buffer(i2s_port_t num) {
+    if (num >= I2S_NUM_MAX || !ports[num].installed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    {
+        std::lock_guard<std::mutex> lock(ports[num].lock);
+        ports[num].fill = 0;
+    }
+    ports[num].space.notify_all();
+    return ESP_OK;
+}
+
+esp_err_t i2s_write(i2s_port_t num, const void* src, size_t size, size_t* bytesWritten,
+                    TickType_t ticks) {
+    if (num >= I2S_NUM_MAX || !ports[num].installed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    I2sPort& port = ports[num];
+    const uint8_t* data = (const uint8_t*)src;
+    size_t written = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(
+        ticks == portMAX_DELAY ? 24 * 3600 * 1000UL : ticks);
+    
+    std::unique_lock<std::mutex> lock(port.lock);
+    while (written < size) {
+        size_t room = port.ring.size() - port.fill;
+        size_t n = std::min(room, size - written);
+        size_t tail = (port.head + port.fill) % port.ring.size();
+        for (size_t i = 0; i < n; i++) {
+            port.ring[(tail + i) % port.ring.size()] = data[written + i];
+        }
+        port.fill += n;
+        written += n;
+        
+        if (written < size && port.space.wait_until(lock, deadline) == std::cv_status::timeout) {
+            break;
+        }
+    }
+    
+    if (bytesWritten) {
+        *bytesWritten = written;
+    }
+    return ESP_OK;
+}
+
+esp_err_t i2s_start(i2s_port_t num) {
+    return num < I2S_NUM_MAX && ports[num].installed ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t i2s_stop(i2s_port_t num) {
+    return num < I2S_NUM_MAX && ports[num].installed ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
@@ -0,0 +1,171 @@
+#include <Adafruit_PN532.h>
+#include "config.h"
+#include "sim.h"
+#include <ctype.h>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+
+// The field and the detection state of the one simulated reader
+static std::mutex fieldLock;
+static std::condition_variable fieldChanged;
+static bool tagPresent = false;
+static uint8_t tagUid[10];
+static uint8_t tagUidLength = 0;
+static bool armed = false;
+static bool irqAsserted = false;
+
+// Called without fieldLock: the ISR runs in this thread
+static void setIrq(bool asserted) {
+    if (NFC_IRQ >= 0) {
+        simGpioWrite(NFC_IRQ, asserted ? LOW : HIGH);
+    }
+}
+
+Adafruit_PN532::Adafruit_PN532(uint8_t clk, uint8_t miso, uint8_t mosi, uint8_t ss) {}
+
+Adafruit_PN532::Adafruit_PN532(uint8_t ss, SPIClass* spi) {}
+
+Adafruit_PN532::Adafruit_PN532(uint8_t irq, uint8_t reset, TwoWire* wire) {}
+
+bool Adafruit_PN532::readPassiveTargetID(uint8_t cardBaudRate, uint8_t* uid, uint8_t* uidLength,
+                                         uint16_t timeout) {
+    std::unique_lock<std::mutex> lock(fieldLock);
+    fieldChanged.wait_for(lock, std::chrono::milliseconds(timeout), [] { return tagPresent; });
+    if (!tagPresent) {
+        return false;
+    }
+    memcpy(uid, tagUid, tagUidLength);
+    *uidLength = tagUidLength;
+    return true;
+}
+
+bool Adafruit_PN532::startPassiveTargetIDDetection(uint8_t cardBaudRate) {
+    bool fire;
+    {
+        std::lock_guard<std::mutex> lock(fieldLock);
+        armed = true;
+        fire = tagPresent && !irqAsserted;
+        irqAsserted = irqAsserted || fire;
+    }
+    if (fire) {
+        setIrq(true);
+    }
+    return true;
+}
+
+bool Adafruit_PN532::readDetectedPassiveTargetID(uint8_t* uid, uint8_t* uidLength) {
+    bool found;
+    {
+        std::lock_guard<std::mutex> lock(fieldLock);
+        found = tagPresent;
+        if (found) {
+            memcpy(uid, tagUid, tagUidLength);
+            *uidLength = tagUidLength;
+        }
+        armed = false;
+        irqAsserted = false;
+    }
+    setIrq(false);
+    return found;
+}
+
+// ============================================================================
+// Field control
+// ============================================================================
+
+void simTagPlace(const uint8_t* uid, uint8_t length) {
+    bool fire;
+    {
+        std::lock_guard<std::mutex> lock(fieldLock);
+        tagUidLength = std::min<uint8_t>(length, sizeof(tagUid));
+        memcpy(tagUid, uid, tagUidLength);
+        tagPresent = true;
+        fire = armed && !irqAsserted;
+        irqAsserted = irqAsserted || fire;
+    }
+    fieldChanged.notify_all();
+    if (fire) {
+        setIrq(true);
+    }
+}
+
+void simTagRemove() {
+    std::lock_guard<std::mutex> lock(fieldLock);
+    tagPresent = false;
+}
+
+// ============================================================================
+// Tag script
+// ============================================================================
+
+static bool parseUid(const std::string& text, uint8_t* uid, uint8_t* length) {
+    std::string hex;
+    for (char c : text) {
+        if (isxdigit((unsigned char)c)) {
+            hex += c;
+        } else if (c != ':' && c != '-') {
+            return false;
+        }
+    }
+    if (hex.empty() || hex.size() % 2 != 0 || hex.size() / 2 > sizeof(tagUid)) {
+        return false;
+    }
+    *length = hex.size() / 2;
+    for (size_t i = 0; i < *length; i++) {
+        uid[i] = strtoul(hex.substr(i * 2, 2).c_str(), nullptr, 16);
+    }
+    return true;
+}
+
+void simRunTagScript(const std::string& path) {
+    std::ifstream file;
+    std::istream* in = &std::cin;
+    if (!path.empty() && path != "-") {
+        file.open(path);
+        if (!file) {
+            fprintf(stderr, "sim: can't read tag script %s\n", path.c_str());
+            return;
+        }
+        in = &file;
+    }
+    
+    std::string line;
+    while (std::getline(*in, line)) {
+        std::istringstream words(line);
+        std::string command;
+        if (!(words >> command) || command[0] == '#') {
+            continue;
+        }
+        
+        uint8_t uid[sizeof(tagUid)];
+        uint8_t length;
+        std::string arg;
+        if (command == "place" || command == "tap") {
+            if (!(words >> arg) || !parseUid(arg, uid, &length)) {
+                fprintf(stderr, "sim: bad UID in \"%s\"\n", line.c_str());
+                continue;
+            }
+            simTagPlace(uid, length);
+            if (command == "tap") {
+                unsigned long ms = 300;
+                words >> ms;
+                delay(ms);
+                simTagRemove();
+            }
+        } else if (command == "remove") {
+            simTagRemove();
+        } else if (command == "wait") {
+            unsigned long ms = 0;
+            words >> ms;
+            delay(ms);
+        } else if (command == "quit") {
+            simExit(0);
+        } else {
+            fprintf(stderr, "sim: unknown tag command \"%s\"\n", command.c_str());
+        }
+    }
+}
@@ -0,0 +1,291 @@
+#include <SD.h>
+#include "sim.h"
+#include <dirent.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+
+fs::SDFS SD;
+
+namespace fs {
+
+// One open file or directory. Card path kept for path()/name()
+class FileImpl {
+public:
+    FileImpl(const std::string& cardPath, const std::string& hostPath, FILE* file, DIR* dir)
+        : cardPath(cardPath), hostPath(hostPath), file(file), dir(dir) {}
+    
+    ~FileImpl() {
+        close();
+    }
+    
+    void close() {
+        if (file) {
+            fclose(file);
+            file = nullptr;
+        }
+        if (dir) {
+            closedir(dir);
+            dir = nullptr;
+        }
+    }
+    
+    std::string cardPath;
+    std::string hostPath;
+    FILE* file;
+    DIR* dir;
+};
+
+static std::string joinPath(const std::string& dir, const char* name) {
+    if (!dir.empty() && dir.back() == '/') {
+        return dir + name;
+    }
+    return dir + "/" + name;
+}
+
+// ============================================================================
+// File
+// ============================================================================
+
+size_t File::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t File::write(const uint8_t* buf, size_t size) {
+    if (!_p || !_p->file) {
+        return 0;
+    }
+    return fwrite(buf, 1, size, _p->file);
+}
+
+int File::available() {
+    if (!_p || !_p->file) {
+        return 0;
+    }
+    return (int)(size() - position());
+}
+
+int File::read() {
+    if (!_p || !_p->file) {
+        return -1;
+    }
+    int c = fgetc(_p->file);
+    return c == EOF ? -1 : c;
+}
+
+int File::peek() {
+    if (!_p || !_p->file) {
+        return -1;
+    }
+    int c = fgetc(_p->file);
+    if (c == EOF) {
+        return -1;
+    }
+    ungetc(c, _p->file);
+    return c;
+}
+
+void File::flush() {
+    if (_p && _p->file) {
+        fflush(_p->file);
+    }
+}
+
+size_t File::read(uint8_t* buf, size_t size) {
+    if (!_p || !_p->file) {
+        return 0;
+    }
+    size_t n = fread(buf, 1, size, _p->file);
+    clearerr(_p->file);
+    return n;
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+    if (!_p || !_p->file) {
+        return false;
+    }
+    int whence = mode == SeekCur ? SEEK_CUR : mode == SeekEnd ? SEEK_END : SEEK_SET;
+    return fseek(_p->file, pos, whence) == 0;
+}
+
+size_t File::position() const {
+    if (!_p || !_p->file) {
+        return 0;
+    }
+    long pos = ftell(_p->file);
+    return pos < 0 ? 0 : (size_t)pos;
+}
+
+size_t File::size() const {
+    if (!_p || !_p->file) {
+        return 0;
+    }
+    fflush(_p->file);
+    struct stat st;
+    return fstat(fileno(_p->file), &st) == 0 ? (size_t)st.st_size : 0;
+}
+
+void File::close() {
+    if (_p) {
+        _p->close();
+        _p.reset();
+    }
+}
+
+File::operator bool() const {
+    return _p && (_p->file || _p->dir);
+}
+
+time_t File::getLastWrite() {
+    if (!_p) {
+        return 0;
+    }
+    flush();
+    struct stat st;
+    return stat(_p->hostPath.c_str(), &st) == 0 ? st.st_mtime : 0;
+}
+
+const char* File::path() const {
+    return _p ? _p->cardPath.c_str() : nullptr;
+}
+
+const char* File::name() const {
+    if (!_p) {
+        return nullptr;
+    }
+    const char* slash = strrchr(_p->cardPath.c_str(), '/');
+    return slash ? slash + 1 : _p->cardPath.c_str();
+}
+
+bool File::isDirectory() const {
+    return _p && _p->dir;
+}
+
+File File::openNextFile(const char* mode) {
+    if (!_p || !_p->dir) {
+        return File();
+    }
+    struct dirent* entry;
+    while ((entry = readdir(_p->dir)) != nullptr) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+        std::string cardPath = joinPath(_p->cardPath, entry->d_name);
+        std::string hostPath = joinPath(_p->hostPath, entry->d_name);
+        
+        struct stat st;
+        if (stat(hostPath.c_str(), &st) != 0) {
+            continue;
+        }
+        if (S_ISDIR(st.st_mode)) {
+            DIR* dir = opendir(hostPath.c_str());
+            if (dir) {
+                return File(std::make_shared<FileImpl>(cardPath, hostPath, nullptr, dir));
+            }
+        } else {
+            FILE* file = fopen(hostPath.c_str(), mode);
+            if (file) {
+                return File(std::make_shared<FileImpl>(cardPath, hostPath, file, nullptr));
+            }
+        }
+    }
+    return File();
+}
+
+void File::rewindDirectory() {
+    if (_p && _p->dir) {
+        rewinddir(_p->dir);
+    }
+}
+
+// ============================================================================
+// FS
+// ============================================================================
+
+std::string FS::hostPath(const char* path) const {
+    if (!path || path[0] == '\0') {
+        return _root;
+    }
+    return path[0] == '/' ? _root + path : _root + "/" + path;
+}
+
+File FS::open(const char* path, const char* mode, bool create) {
+    if (_root.empty() || !path) {
+        return File();
+    }
+    std::string host = hostPath(path);
+    
+    struct stat st;
+    if (stat(host.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+        DIR* dir = opendir(host.c_str());
+        return dir ? File(std::make_shared<FileImpl>(path, host, nullptr, dir)) : File();
+    }
+    
+    FILE* file = fopen(host.c_str(), mode);
+    if (!file) {
+        return File();
+    }
+    return File(std::make_shared<FileImpl>(path, host, file, nullptr));
+}
+
+bool FS::exists(const char* path) {
+    struct stat st;
+    return !_root.empty() && path && stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool FS::remove(const char* path) {
+    return !_root.empty() && path && unlink(hostPath(path).c_str()) == 0;
+}
+
+bool FS::rename(const char* pathFrom, const char* pathTo) {
+    return !_root.empty() && pathFrom && pathTo &&
+           ::rename(hostPath(pathFrom).c_str(), hostPath(pathTo).c_str()) == 0;
+}
+
+bool FS::mkdir(const char* path) {
+    return !_root.empty() && path && ::mkdir(hostPath(path).c_str(), 0755) == 0;
+}
+
+bool FS::rmdir(const char* path) {
+    return !_root.empty() && path && ::rmdir(hostPath(path).c_str()) == 0;
+}
+
+// ============================================================================
+// SDFS
+// ============================================================================
+
+bool SDFS::begin(uint8_t ssPin, SPIClass& spi, uint32_t frequency, const char* mountpoint,
+                 uint8_t maxFiles, bool formatIfEmpty) {
+    std::string root = simOptions().sdRoot;
+    while (root.size() > 1 && root.back() == '/') {
+        root.pop_back();
+    }
+    if (::mkdir(root.c_str(), 0755) != 0 && errno != EEXIST) {
+        return false;
+    }
+    _root = root;
+    return true;
+}
+
+uint64_t SDFS::totalBytes() {
+    struct statvfs vfs;
+    if (_root.empty() || statvfs(_root.c_str(), &vfs) != 0) {
+        return 0;
+    }
+    return (uint64_t)vfs.f_blocks * vfs.f_frsize;
+}
+
+uint64_t SDFS::cardSize() {
+    return totalBytes();
+}
+
+uint64_t SDFS::usedBytes() {
+    struct statvfs vfs;
+    if (_root.empty() || statvfs(_root.c_str(), &vfs) != 0) {
+        return 0;
+    }
+    return (uint64_t)(vfs.f_blocks - vfs.f_bfree) * vfs.f_frsize;
+}
+
+} // namespace fs
@@ -0,0 +1,269 @@
+#include <WString.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static std::string formatInteger(unsigned long long value, bool negative, unsigned char base) {
+    static const char digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+    if (base < 2 || base > 36) {
+        base = 10;
+    }
+    
+    char buffer[72];
+    char* p = buffer + sizeof(buffer);
+    *--p = '\0';
+    do {
+        *--p = digits[value % base];
+        value /= base;
+    } while (value > 0);
+    if (negative) {
+        *--p = '-';
+    }
+    return p;
+}
+
+static std::string formatSigned(long long value, unsigned char base) {
+    // Like the ESP32 core: only base 10 is signed, other bases show the bits
+    if (base == 10 && value < 0) {
+        return formatInteger(0ULL - (unsigned long long)value, true, base);
+    }
+    return formatInteger((unsigned long long)value, false, base);
+}
+
+static std::string formatDouble(double value, unsigned int decimalPlaces) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.*f", (int)decimalPlaces, value);
+    return buffer;
+}
+
+String::String(const char* cstr) : _s(cstr ? cstr : "") {}
+
+String::String(const char* cstr, unsigned int length) : _s(cstr ? std::string(cstr, length) : "") {}
+
+String::String(const __FlashStringHelper* str) : _s(str ? (const char*)str : "") {}
+
+String::String(char c) : _s(1, c) {}
+
+String::String(unsigned char value, unsigned char base) : _s(formatInteger(value, false, base)) {}
+
+String::String(int value, unsigned char base)
+    : _s(base == 10 ? formatSigned(value, base) : formatInteger((unsigned int)value, false, base)) {}
+
+String::String(unsigned int value, unsigned char base) : _s(formatInteger(value, false, base)) {}
+
+String::String(long value, unsigned char base)
+    : _s(base == 10 ? formatSigned(value, base) : formatInteger((unsigned long)value, false, base)) {}
+
+String::String(unsigned long value, unsigned char base) : _s(formatInteger(value, false, base)) {}
+
+String::String(long long value, unsigned char base) : _s(formatSigned(value, base)) {}
+
+String::String(unsigned long long value, unsigned char base) : _s(formatInteger(value, false, base)) {}
+
+String::String(float value, unsigned int decimalPlaces) : _s(formatDouble(value, decimalPlaces)) {}
+
+String::String(double value, unsigned int decimalPlaces) : _s(formatDouble(value, decimalPlaces)) {}
+
+String& String::operator=(const char* cstr) {
+    _s = cstr ? cstr : "";
+    return *this;
+}
+
+bool String::reserve(unsigned int size) {
+    _s.reserve(size);
+    return true;
+}
+
+bool String::concat(const String& str) {
+    _s += str._s;
+    return true;
+}
+
+bool String::concat(const char* cstr) {
+    if (!cstr) {
+        return false;
+    }
+    _s += cstr;
+    return true;
+}
+
+bool String::concat(const char* cstr, unsigned int length) {
+    if (!cstr) {
+        return false;
+    }
+    _s.append(cstr, length);
+    return true;
+}
+
+bool String::concat(char c) {
+    _s += c;
+    return true;
+}
+
+bool String::concat(unsigned char value) { return concat(String(value)); }
+bool String::concat(int value) { return concat(String(value)); }
+bool String::concat(unsigned int value) { return concat(String(value)); }
+bool String::concat(long value) { return concat(String(value)); }
+bool String::concat(unsigned long value) { return concat(String(value)); }
+bool String::concat(long long value) { return concat(String(value)); }
+bool String::concat(unsigned long long value) { return concat(String(value)); }
+bool String::concat(float value) { return concat(String(value)); }
+bool String::concat(double value) { return concat(String(value)); }
+
+bool String::equalsIgnoreCase(const String& s) const {
+    return _s.length() == s._s.length() && strcasecmp(_s.c_str(), s._s.c_str()) == 0;
+}
+
+bool String::startsWith(const String& prefix) const {
+    return startsWith(prefix, 0);
+}
+
+bool String::startsWith(const String& prefix, unsigned int offset) const {
+    return offset <= _s.length() && _s.compare(offset, prefix._s.length(), prefix._s) == 0;
+}
+
+bool String::endsWith(const String& suffix) const {
+    return _s.length() >= suffix._s.length() &&
+           _s.compare(_s.length() - suffix._s.length(), suffix._s.length(), suffix._s) == 0;
+}
+
+char String::charAt(unsigned int index) const {
+    return index < _s.length() ? _s[index] : 0;
+}
+
+void String::setCharAt(unsigned int index, char c) {
+    if (index < _s.length()) {
+        _s[index] = c;
+    }
+}
+
+char& String::operator[](unsigned int index) {
+    static char dummy;
+    if (index >= _s.length()) {
+        dummy = 0;
+        return dummy;
+    }
+    return _s[index];
+}
+
+void String::getBytes(unsigned char* buf, unsigned int bufsize, unsigned int index) const {
+    if (!buf || bufsize == 0) {
+        return;
+    }
+    if (index >= _s.length()) {
+        buf[0] = 0;
+        return;
+    }
+    size_t n = std::min((size_t)bufsize - 1, _s.length() - index);
+    memcpy(buf, _s.data() + index, n);
+    buf[n] = 0;
+}
+
+static int position(size_t pos) {
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(char ch, unsigned int fromIndex) const {
+    return position(_s.find(ch, fromIndex));
+}
+
+int String::indexOf(const String& str, unsigned int fromIndex) const {
+    return position(_s.find(str._s, fromIndex));
+}
+
+int String::lastIndexOf(char ch) const {
+    return position(_s.rfind(ch));
+}
+
+int String::lastIndexOf(char ch, unsigned int fromIndex) const {
+    return position(_s.rfind(ch, fromIndex));
+}
+
+int String::lastIndexOf(const String& str) const {
+    return position(_s.rfind(str._s));
+}
+
+int String::lastIndexOf(const String& str, unsigned int fromIndex) const {
+    return position(_s.rfind(str._s, fromIndex));
+}
+
+String String::substring(unsigned int beginIndex) const {
+    return substring(beginIndex, _s.length());
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const {
+    if (beginIndex > endIndex) {
+        std::swap(beginIndex, endIndex);
+    }
+    if (beginIndex >= _s.length()) {
+        return String();
+    }
+    endIndex = std::min(endIndex, (unsigned int)_s.length());
+    return String(_s.substr(beginIndex, endIndex - beginIndex));
+}
+
+void String::replace(char find, char replace) {
+    for (char& c : _s) {
+        if (c == find) {
+            c = replace;
+        }
+    }
+}
+
+void String::replace(const String& find, const String& replace) {
+    if (find._s.empty()) {
+        return;
+    }
+    size_t pos = 0;
+    while ((pos = _s.find(find._s, pos)) != std::string::npos) {
+        _s.replace(pos, find._s.length(), replace._s);
+        pos += replace._s.length();
+    }
+}
+
+void String::remove(unsigned int index) {
+    if (index < _s.length()) {
+        _s.erase(index);
+    }
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+    if (index < _s.length()) {
+        _s.erase(index, count);
+    }
+}
+
+void String::toLowerCase() {
+    for (char& c : _s) {
+        c = tolower((unsigned char)c);
+    }
+}
+
+void String::toUpperCase() {
+    for (char& c : _s) {
+        c = toupper((unsigned char)c);
+    }
+}
+
+void String::trim() {
+    size_t begin = _s.find_first_not_of(" \t\r\n\f\v");
+    if (begin == std::string::npos) {
+        _s.clear();
+        return;
+    }
+    size_t end = _s.find_last_not_of(" \t\r\n\f\v");
+    _s = _s.substr(begin, end - begin + 1);
+}
+
+long String::toInt() const {
+    return atol(_s.c_str());
+}
+
+float String::toFloat() const {
+    return atof(_s.c_str());
+}
+
+double String::toDouble() const {
+    return atof(_s.c_str());
+}
@@ -2,146 +2,663 @@
 #include "config.h"
 // Include audio libraries only in .cpp to avoid SPI initialization conflicts
 #include "AudioFileSourceSD.h"
-#include "AudioFileSourceBuffer.h"
 #include "AudioFileSourceID3.h"
 #include "AudioGeneratorMP3.h"
-#include "AudioOutputI2S.h"
+#include "i2s_dma_output.h"
+#include "logger.h"
+#include "metrics.h"
+#include "prefetch_buffer.h"
+#include "sd_bus.h"
+#include "tap_latency.h"
+#include "track_chain_source.h"
+
+#include <algorithm>
+#include <new>
 
 AudioPlayer audioPlayer;
 
+// Storage for the pipeline objects. File sources, the chain and the decoder
+// are constructed once in begin(); the per-track buffer and ID3 wrappers are
+// constructed in place on every load and destroyed in place on release, so
+// track changes never touch the heap.
+alignas(AudioFileSourceSD) static uint8_t fileSlots[2][sizeof(AudioFileSourceSD)];
+alignas(PrefetchBuffer) static uint8_t buffSlots[2][sizeof(PrefetchBuffer)];
+alignas(AudioFileSourceID3) static uint8_t id3Slots[2][sizeof(AudioFileSourceID3)];
+alignas(TrackChainSource) static uint8_t chainSlot[sizeof(TrackChainSource)];
+alignas(AudioGeneratorMP3) static uint8_t mp3Slot[sizeof(AudioGeneratorMP3)];
+
 AudioPlayer::AudioPlayer() 
-    : _mp3(nullptr), _file(nullptr), _buff(nullptr), _id3(nullptr), _out(nullptr), 
-      _state(STOPPED), _volume(DEFAULT_VOLUME) {}
+    : _mp3(nullptr), _chain(nullptr), _current(0), _nextPrimed(false), _out(nullptr),
+      _streamBuffers(nullptr), _decoderState(nullptr), _baselineFreeHeap(0),
+      _playlistHead(0), _playlistCount(0), _queuedTracks(0),
+      _state(STOPPED), _currentSongSeq(0), _volume(DEFAULT_VOLUME),
+      _positionBytes(0), _positionSamples(0), _sampleRate(AUDIO_SAMPLE_RATE),
+      _durationMs(0), _trackStartFrame(0), _statusVersion(0), _seekIndexPending(false),
+      _seekDeferred(false), _deferredSeekMs(0),
+      _producerLock(portMUX_INITIALIZER_UNLOCKED),
+      _task(nullptr), _windowStart(0), _sleepMicros(0), _cpuLoad(0.0f) {
+    memset(_slots, 0, sizeof(_slots));
+    memset(_currentSong, 0, sizeof(_currentSong));
+}
 
 AudioPlayer::~AudioPlayer() {
     cleanup();
 }
 
 bool AudioPlayer::begin() {
-    // Initialize I2S output with optimized settings
-    _out = new AudioOutputI2S();
+    // Initialize I2S output (stereo, DMA events drive the audio task)
+    _out = new I2SDmaOutput();
     _out->SetPinout(I2S_BCLK, I2S_LRC, I2S_DOUT);
     _out->SetGain(_volume);
-    // Set output mode for better performance (internal DAC mode)
-    _out->SetOutputModeMono(false);  // Stereo output
+    if (!_out->begin()) {
+        return false;
+    }
+    
+    if (!allocateArena()) {
+        Serial.println("✗ Failed to allocate audio pipeline arena");
+        return false;
+    }
+    
+    if (!_seekIndexer.begin()) {
+        return false;
+    }
+    
+    _baselineFreeHeap = ESP.getFreeHeap();
+    logHeapUsage("init");
     
     Serial.println("Audio Player initialized");
     return true;
 }
 
+bool AudioPlayer::allocateArena() {
+    // The stream buffers are only touched in bulk by the SD reader, so they
+    // can live in PSRAM. Decoder state is hot and stays in internal RAM.
+    const size_t buffersSize = 2 * AUDIO_STREAM_BUFFER_SIZE;
+    bool inPsram = false;
+#ifdef BOARD_HAS_PSRAM
+    if (psramFound()) {
+        _streamBuffers = (uint8_t*)ps_malloc(buffersSize);
+        inPsram = (_streamBuffers != nullptr);
+    }
+#endif
+    if (!_streamBuffers) {
+        _streamBuffers = (uint8_t*)malloc(buffersSize);
+    }
+    
+    _decoderState = (uint8_t*)malloc(AudioGeneratorMP3::preAllocSize());
+    
+    if (!_streamBuffers || !_decoderState) {
+        free(_streamBuffers);
+        free(_decoderState);
+        _streamBuffers = nullptr;
+        _decoderState = nullptr;
+        return false;
+    }
+    
+    // The file sources, chain and decoder are reused across tracks
+    for (uint8_t i = 0; i < 2; i++) {
+        _slots[i].file = new (fileSlots[i]) AudioFileSourceSD();
+        _slots[i].buffer = _streamBuffers + i * AUDIO_STREAM_BUFFER_SIZE;
+    }
+    _chain = new (chainSlot) TrackChainSource();
+    _chain->setNextTrackCallback(onTrackEnd, this);
+    _mp3 = new (mp3Slot) AudioGeneratorMP3(_decoderState, AudioGeneratorMP3::preAllocSize());
+    
+    Serial.printf("✓ Audio arena: 2 x %d KB stream buffers (%s), %d KB decoder state\n",
+                  AUDIO_STREAM_BUFFER_SIZE / 1024,
+                  inPsram ? "PSRAM" : "internal",
+                  AudioGeneratorMP3::preAllocSize() / 1024);
+    return true;
+}
+
 void AudioPlayer::loop() {
-    if (_mp3 && _mp3->isRunning()) {
+    // Apply pending commands first so the pipeline is only ever
+    // modified from this task
+    processCommands();
+    
+    if (_state == PLAYING && _mp3 && _mp3->isRunning()) {
         if (!_mp3->loop()) {
-            // Song finished
-            Serial.println("Song finished");
-            stop();
+            // Last track of the playlist finished
+            LOG_INFO("Song finished");
+            doStop();
+            return;
+        }
+        
+        updatePosition();
+        
+        // Background SD I/O holds off while the decoder's buffer runs low
+        PrefetchBuffer* current = currentSlot().buff;
+        if (current) {
+            uint32_t level = current->sourceEnded() ? AUDIO_STREAM_BUFFER_SIZE : current->getFillLevel();
+            sdBus.setPlaybackLevel(level);
+            metrics.bufferFill.record(level * 100 / AUDIO_STREAM_BUFFER_SIZE);
         }
+        
+        // Use the time left until the DMA ring drains to warm up the next
+        // track and to extend the seek table
+        prefetchNext();
+        updateSeekIndex();
+    } else {
+        sdBus.setPlaybackIdle();
     }
 }
 
-bool AudioPlayer::play(const String& filepath) {
-    Serial.printf("♪ Playing: %s\n", filepath.c_str());
+void AudioPlayer::waitForWork() {
+    uint32_t sleepStart = micros();
     
-    // Stop current playback if any
-    stop();
+    if (_state == PLAYING && _mp3 && _mp3->isRunning()) {
+        // The decoder returned because the DMA ring is full. Sleep until the
+        // ISR has sent a buffer; a short timeout keeps commands responsive.
+        _out->waitForSpace(pdMS_TO_TICKS(AUDIO_COMMAND_LATENCY_MS));
+    } else {
+        // Nothing to decode - sleep until a command is posted
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
     
-    // Create new file source
-    _file = new AudioFileSourceSD(filepath.c_str());
-    if (!_file->isOpen()) {
-        Serial.println("✗ Failed to open audio file");
-        delete _file;
-        _file = nullptr;
+    uint32_t now = micros();
+    _sleepMicros += now - sleepStart;
+    
+    uint32_t window = now - _windowStart;
+    if (window >= 1000000) {
+        _cpuLoad = 1.0f - (float)_sleepMicros / (float)window;
+        _windowStart = now;
+        _sleepMicros = 0;
+    }
+}
+
+// ============================================================================
+// Command posting (any task)
+// ============================================================================
+
+bool AudioPlayer::post(const AudioCommand& cmd) {
+    // The ring is single-producer: the loop task (NFC) and AsyncTCP callbacks
+    // are serialised here. The audio task never takes this lock.
+    portENTER_CRITICAL(&_producerLock);
+    bool queued = _commands.push(cmd);
+    portEXIT_CRITICAL(&_producerLock);
+    
+    if (!queued) {
+        LOG_ERROR("✗ Audio command queue full, command dropped");
+    } else if (_task) {
+        xTaskNotifyGive(_task);
+    }
+    return queued;
+}
+
+bool AudioPlayer::play(const char* filepath) {
+    if (strnlen(filepath, AUDIO_MAX_PATH_LENGTH) == AUDIO_MAX_PATH_LENGTH) {
+        LOG_ERROR("✗ Audio file path too long");
         return false;
     }
     
-    // Create buffer (32KB for smooth playback on dedicated core)
-    _buff = new AudioFileSourceBuffer(_file, 32768);
-    Serial.println("✓ Created 32KB audio buffer");
+    AudioCommand cmd = {};
+    cmd.type = CMD_PLAY;
+    strlcpy(cmd.path, filepath, sizeof(cmd.path));
+    return post(cmd);
+}
+
+bool AudioPlayer::enqueue(const char* filepath) {
+    if (strnlen(filepath, AUDIO_MAX_PATH_LENGTH) == AUDIO_MAX_PATH_LENGTH) {
+        LOG_ERROR("✗ Audio file path too long");
+        return false;
+    }
     
-    // Create ID3 tag filter to skip metadata
-    _id3 = new AudioFileSourceID3(_buff);
-    _id3->RegisterMetadataCB([](void *cbData, const char *type, bool isUnicode, const char *string) {
-        // Callback for metadata - just log it
-        Serial.printf("  ID3 %s: %s\n", type, string);
-    }, nullptr);
-    Serial.println("✓ ID3 metadata filter enabled");
-    
-    // Create MP3 decoder
-    _mp3 = new AudioGeneratorMP3();
-    if (!_mp3->begin(_id3, _out)) {
-        Serial.println("✗ Failed to start MP3 decoder");
-        delete _id3;
-        delete _buff;
-        delete _file;
-        delete _mp3;
-        _id3 = nullptr;
-        _buff = nullptr;
-        _file = nullptr;
-        _mp3 = nullptr;
+    // Reserve a playlist slot first, so a full playlist is refused here
+    // instead of being dropped later on the audio task
+    if (_queuedTracks.fetch_add(1) >= AUDIO_PLAYLIST_SIZE) {
+        _queuedTracks.fetch_sub(1);
+        return false;
+    }
+    
+    AudioCommand cmd = {};
+    cmd.type = CMD_ENQUEUE;
+    strlcpy(cmd.path, filepath, sizeof(cmd.path));
+    if (!post(cmd)) {
+        _queuedTracks.fetch_sub(1);
+        return false;
+    }
+    return true;
+}
+
+bool AudioPlayer::pause() {
+    AudioCommand cmd = {};
+    cmd.type = CMD_PAUSE;
+    return post(cmd);
+}
+
+bool AudioPlayer::resume() {
+    AudioCommand cmd = {};
+    cmd.type = CMD_RESUME;
+    return post(cmd);
+}
+
+bool AudioPlayer::stop() {
+    AudioCommand cmd = {};
+    cmd.type = CMD_STOP;
+    return post(cmd);
+}
+
+bool AudioPlayer::seek(uint32_t positionMs) {
+    AudioCommand cmd = {};
+    cmd.type = CMD_SEEK;
+    cmd.position = positionMs;
+    return post(cmd);
+}
+
+bool AudioPlayer::setVolume(float volume) {
+    AudioCommand cmd = {};
+    cmd.type = CMD_SET_VOLUME;
+    cmd.volume = constrain(volume, 0.0f, 1.0f);
+    return post(cmd);
+}
+
+// ============================================================================
+// Command handlers (audio task)
+// ============================================================================
+
+void AudioPlayer::processCommands() {
+    AudioCommand cmd;
+    while (_commands.pop(cmd)) {
+        switch (cmd.type) {
+            case CMD_PLAY:       doPlay(cmd.path); break;
+            case CMD_ENQUEUE:    doEnqueue(cmd.path); break;
+            case CMD_PAUSE:      doPause(); break;
+            case CMD_RESUME:     doResume(); break;
+            case CMD_STOP:       doStop(); break;
+            case CMD_SEEK:       doSeek(cmd.position); break;
+            case CMD_SET_VOLUME: doSetVolume(cmd.volume); break;
+        }
+    }
+}
+
+bool AudioPlayer::doPlay(const char* filepath) {
+    tapLatency.mark(TAP_COMMAND);
+    LOG_INFO("♪ Playing: %s", filepath);
+    
+    // Stop current playback (and drop the old playlist) if any
+    doStop();
+    
+    if (!_mp3) {
+        LOG_ERROR("✗ Audio pipeline not initialized");
+        return false;
+    }
+    
+    if (!loadSlot(currentSlot(), filepath)) {
+        return false;
+    }
+    
+    // Start decoding after the first chunk instead of a full 32 KB fill;
+    // the buffer keeps topping itself up one chunk per read
+    _chain->setSource(currentSlot().id3);
+    if (!_mp3->begin(_chain, _out)) {
+        LOG_ERROR("✗ Failed to start MP3 decoder");
+        releaseSlot(currentSlot());
         return false;
     }
     
     _state = PLAYING;
-    _currentSong = filepath;
+    setCurrentSong(filepath);
+    _trackStartFrame = _out->getFramesConsumed();
+    _seekIndexPending = true;
+    updatePosition();
+    _statusVersion++;
     
-    Serial.println("Playback started");
+    LOG_INFO("Playback started");
+    logHeapUsage("play");
     return true;
 }
 
-void AudioPlayer::pause() {
+void AudioPlayer::doEnqueue(const char* filepath) {
+    if (_playlistCount == AUDIO_PLAYLIST_SIZE) {
+        // Only if a caller skipped the reservation in enqueue()
+        LOG_ERROR("✗ Playlist full, track dropped");
+        _queuedTracks.fetch_sub(1);
+        return;
+    }
+    
+    uint8_t tail = (_playlistHead + _playlistCount) % AUDIO_PLAYLIST_SIZE;
+    strlcpy(_playlist[tail], filepath, AUDIO_MAX_PATH_LENGTH);
+    _playlistCount++;
+}
+
+void AudioPlayer::doPause() {
     if (_state == PLAYING && _mp3) {
-        _mp3->stop();
+        // Only gate the decode loop: the decoder, its current frame and the
+        // read-ahead buffer stay as they are. The samples already in the
+        // DMA ring drain out (well under 50 ms) and the driver then sends
+        // silence, so nothing is lost and resume continues at the next sample.
         _state = PAUSED;
-        Serial.println("Playback paused");
+        _out->idle();
+        _statusVersion++;
+        LOG_INFO("Playback paused");
     }
 }
 
-void AudioPlayer::resume() {
-    if (_state == PAUSED && _mp3 && _file) {
-        // Resume playback
+void AudioPlayer::doResume() {
+    if (_state == PAUSED && _mp3 && _mp3->isRunning()) {
+        // The audio task was woken by this command and decodes straight away
         _state = PLAYING;
-        Serial.println("Playback resumed");
+        _statusVersion++;
+        LOG_INFO("Playback resumed");
     }
 }
 
-void AudioPlayer::stop() {
-    if (_mp3) {
+void AudioPlayer::doStop() {
+    if (_mp3 && _mp3->isRunning()) {
         _mp3->stop();
-        delete _mp3;
-        _mp3 = nullptr;
     }
     
-    if (_id3) {
-        delete _id3;
-        _id3 = nullptr;
+    releaseSlot(_slots[0]);
+    releaseSlot(_slots[1]);
+    if (_chain) {
+        _chain->setSource(nullptr);
+    }
+    _nextPrimed = false;
+    _queuedTracks.fetch_sub(_playlistCount);
+    _playlistHead = 0;
+    _playlistCount = 0;
+    
+    _state = STOPPED;
+    setCurrentSong("");
+    _positionBytes = 0;
+    _positionSamples = 0;
+    _durationMs = 0;
+    _seekIndexer.cancel();
+    _seekIndexPending = false;
+    _seekDeferred = false;
+    _statusVersion++;
+    LOG_INFO("⏹ Playback stopped");
+}
+
+void AudioPlayer::doSeek(uint32_t positionMs) {
+    TrackSlot& slot = currentSlot();
+    if (_state == STOPPED || !slot.buff) {
+        return;
     }
     
-    if (_buff) {
-        delete _buff;
-        _buff = nullptr;
+    // The table is built on Core 0; never wait for it here
+    uint32_t offset;
+    if (!_seekIndexer.lookup(positionMs, offset)) {
+        if (_seekIndexPending) {
+            _seekIndexPending = false;
+            _seekIndexer.request(slot.path);
+        }
+        _seekDeferred = !_seekIndexer.hasFailed();
+        _deferredSeekMs = positionMs;
+        if (!_seekDeferred) {
+            LOG_WARN("⚠ Seek ignored, no seek index for %s", slot.path);
+        }
+        return;
     }
+    _seekDeferred = false;
+    
+    SdLock lock(SdLock::PLAYBACK);
     
-    if (_file) {
-        _file->close();
-        delete _file;
-        _file = nullptr;
+    // Restart the decoder so nothing left over from the old position is
+    // decoded; the new stream syncs on the first frame header it finds
+    _mp3->stop();
+    bool ok = slot.buff->seek(offset, SEEK_SET);
+    if (!_mp3->begin(_chain, _out)) {
+        LOG_ERROR("✗ Failed to restart MP3 decoder after seek");
+        doStop();
+        return;
     }
     
-    _state = STOPPED;
-    _currentSong = "";
-    Serial.println("⏹ Playback stopped");
+    // Keep the reported position in step with the new offset
+    _trackStartFrame = _out->getFramesConsumed() - (uint32_t)((uint64_t)positionMs * _out->getRate() / 1000);
+    updatePosition();
+    _statusVersion++;
+    
+    if (ok) {
+        LOG_INFO("Seeked to %u ms (byte %u)", positionMs, offset);
+    } else {
+        LOG_ERROR("✗ Seek failed");
+    }
 }
 
-void AudioPlayer::setVolume(float volume) {
-    _volume = constrain(volume, 0.0f, 1.0f);
+void AudioPlayer::doSetVolume(float volume) {
+    _volume = volume;
     if (_out) {
         _out->SetGain(_volume);
     }
-    Serial.printf("Volume set to: %.2f\n", _volume);
+    _statusVersion++;
+    LOG_INFO("Volume set to: %.2f", _volume);
+}
+
+// ============================================================================
+// Track slots (audio task)
+// ============================================================================
+
+bool AudioPlayer::loadSlot(TrackSlot& slot, const char* filepath) {
+    SdLock lock(SdLock::PLAYBACK);
+    releaseSlot(slot);
+    
+    // Re-arm the slot's file source on the new track
+    if (!slot.file->open(filepath)) {
+        LOG_ERROR("✗ Failed to open audio file: %s", filepath);
+        return false;
+    }
+    tapLatency.mark(TAP_FILE_OPEN);
+    
+    // Wrap it in the pre-allocated read-ahead buffer
+    slot.buff = new (buffSlots[&slot - _slots])
+        PrefetchBuffer(slot.file, slot.buffer, AUDIO_STREAM_BUFFER_SIZE, AUDIO_PREFETCH_CHUNK);
+    
+    // ID3 tag filter to skip metadata
+    slot.id3 = new (id3Slots[&slot - _slots]) AudioFileSourceID3(slot.buff);
+    slot.id3->RegisterMetadataCB([](void*, const char *type, bool, const char *string) {
+        // Callback for metadata - just log it
+        LOG_DEBUG("  ID3 %s: %s", type, string);
+    }, nullptr);
+    
+    strlcpy(slot.path, filepath, sizeof(slot.path));
+    return true;
+}
+
+void AudioPlayer::releaseSlot(TrackSlot& slot) {
+    // Destroy the per-track wrappers in place; their storage is reused
+    if (slot.id3) {
+        slot.id3->~AudioFileSourceID3();
+        slot.id3 = nullptr;
+    }
+    
+    if (slot.buff) {
+        slot.buff->~PrefetchBuffer();
+        slot.buff = nullptr;
+    }
+    
+    if (slot.file && slot.file->isOpen()) {
+        SdLock lock(SdLock::PLAYBACK);
+        slot.file->close();
+    }
+    slot.path[0] = '\0';
+}
+
+void AudioPlayer::prefetchNext() {
+    // The current track's buffer has priority for SD bandwidth
+    PrefetchBuffer* current = currentSlot().buff;
+    if (!current || current->getFillLevel() < AUDIO_STREAM_BUFFER_SIZE / 2) {
+        return;
+    }
+    
+    TrackSlot& next = nextSlot();
+    if (!next.id3) {
+        if (_playlistCount == 0) {
+            return;
+        }
+        
+        const char* path = _playlist[_playlistHead];
+        _playlistHead = (_playlistHead + 1) % AUDIO_PLAYLIST_SIZE;
+        _playlistCount--;
+        _queuedTracks.fetch_sub(1);
+        
+        _nextPrimed = false;
+        if (!loadSlot(next, path)) {
+            return;  // Skip unreadable tracks; the next loop tries the one after
+        }
+        LOG_INFO("Prefetching next track: %s", path);
+        return;
+    }
+    
+    // One chunk per loop, so a single pass never outlasts the DMA ring
+    if (!_nextPrimed) {
+        _nextPrimed = next.buff->prefill();
+    }
+}
+
+void AudioPlayer::updateSeekIndex() {
+    if (_seekIndexPending) {
+        // Wait until the track is buffered before the indexer reads the file
+        PrefetchBuffer* current = currentSlot().buff;
+        if (!current || current->getFillLevel() < AUDIO_STREAM_BUFFER_SIZE / 2) {
+            return;
+        }
+        _seekIndexPending = false;
+        _seekIndexer.request(currentSlot().path);
+    }
+    if (_seekDeferred) {
+        doSeek(_deferredSeekMs);  // Defers again until the file is opened
+    }
+    
+    uint32_t durationMs = _seekIndexer.getDurationMs();
+    if (durationMs != _durationMs) {
+        _durationMs = durationMs;
+        _statusVersion++;
+    }
+}
+
+AudioFileSource* AudioPlayer::onTrackEnd(void* context) {
+    return static_cast<AudioPlayer*>(context)->advanceTrack();
+}
+
+AudioFileSource* AudioPlayer::advanceTrack() {
+    // Called from inside the decoder's read() when the current file ends.
+    // Hand it the next slot so decoding continues without a restart.
+    TrackSlot& next = nextSlot();
+    if (!next.id3 && _playlistCount > 0) {
+        // Prefetch did not get to it in time; load it now (audible gap)
+        const char* path = _playlist[_playlistHead];
+        _playlistHead = (_playlistHead + 1) % AUDIO_PLAYLIST_SIZE;
+        _playlistCount--;
+        _queuedTracks.fetch_sub(1);
+        loadSlot(next, path);
+    }
+    
+    if (!next.id3) {
+        return nullptr;  // End of playlist
+    }
+    
+    releaseSlot(currentSlot());
+    _current ^= 1;
+    _nextPrimed = false;
+    setCurrentSong(currentSlot().path);
+    
+    // The decoder is roughly one MP3 frame ahead of the output here
+    _trackStartFrame = _out->getFramesConsumed();
+    _seekIndexer.cancel();
+    _seekIndexPending = true;
+    _seekDeferred = false;
+    _durationMs = 0;
+    _statusVersion++;
+    
+    LOG_INFO("♪ Next track: %s", currentSlot().path);
+    return currentSlot().id3;
+}
+
+// ============================================================================
+
+void AudioPlayer::updatePosition() {
+    TrackSlot& slot = currentSlot();
+    if (!slot.buff) {
+        return;
+    }
+    
+    // Bytes read from the file minus what is still waiting in the buffer
+    uint32_t filePos = slot.file->getPos();
+    uint32_t buffered = slot.buff->getFillLevel();
+    _positionBytes = (filePos > buffered) ? filePos - buffered : 0;
+    _positionSamples = _out->getFramesConsumed() - _trackStartFrame;
+    _sampleRate = _out->getRate();
+}
+
+uint32_t AudioPlayer::getPositionMs() {
+    uint32_t rate = _sampleRate;
+    if (rate == 0) {
+        return 0;
+    }
+    return (uint32_t)((uint64_t)_positionSamples * 1000 / rate);
+}
+
+uint32_t AudioPlayer::getUnderruns() {
+    return _out ? _out->getUnderruns() : 0;
+}
+
+uint32_t AudioPlayer::getFramesDecoded() {
+    return _out ? _out->getFramesConsumed() : 0;
+}
+
+void AudioPlayer::logHeapUsage(const char* event) {
+    // After init the free heap should not drift across track changes
+    uint32_t freeHeap = ESP.getFreeHeap();
+    LOG_INFO("[HEAP] %s: free=%u (%+d vs init) min=%u largest=%u",
+             event, freeHeap, (int)(freeHeap - _baselineFreeHeap),
+             ESP.getMinFreeHeap(), ESP.getMaxAllocHeap());
+}
+
+void AudioPlayer::setCurrentSong(const char* filepath) {
+    uint32_t seq = _currentSongSeq.load(std::memory_order_relaxed);
+    _currentSongSeq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    strlcpy(_currentSong, filepath, sizeof(_currentSong));
+    _currentSongSeq.store(seq + 2, std::memory_order_release);
+}
+
+void AudioPlayer::getCurrentSong(char* out, size_t outLen) {
+    if (outLen == 0) {
+        return;
+    }
+    size_t length = std::min(outLen, sizeof(_currentSong)) - 1;
+    for (;;) {
+        // The audio task (Core 1) is mid-copy; it takes microseconds
+        uint32_t seq = _currentSongSeq.load(std::memory_order_acquire);
+        if (seq & 1) {
+            continue;
+        }
+        // Fixed length: a path being overwritten may have no terminator yet
+        memcpy(out, _currentSong, length);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (_currentSongSeq.load(std::memory_order_relaxed) == seq) {
+            break;
+        }
+    }
+    out[length] = '\0';
 }
 
 void AudioPlayer::cleanup() {
-    stop();
+    doStop();
+    
+    if (_mp3) {
+        _mp3->~AudioGeneratorMP3();
+        _mp3 = nullptr;
+    }
+    
+    if (_chain) {
+        _chain->~TrackChainSource();
+        _chain = nullptr;
+    }
+    
+    for (uint8_t i = 0; i < 2; i++) {
+        if (_slots[i].file) {
+            _slots[i].file->~AudioFileSourceSD();
+            _slots[i].file = nullptr;
+        }
+    }
+    
+    free(_streamBuffers);
+    free(_decoderState);
+    _streamBuffers = nullptr;
+    _decoderState = nullptr;
+    
     if (_out) {
         delete _out;
         _out = nullptr;
@@ -0,0 +1,455 @@
+#include "decode_bench.h"
+#include "AudioFileSourceSD.h"
+#include "AudioFileSourceID3.h"
+#include "AudioGeneratorMP3.h"
+#include "i2s_dma_output.h"
+#include "prefetch_buffer.h"
+#include "sd_bus.h"
+#include "track_chain_source.h"
+
+#include <SD.h>
+
+#ifndef ARDUINO_ARCH_ESP32
+#include "sim.h"
+#endif
+
+DecodeBench decodeBench;
+
+// Read-ahead sizes to compare (PrefetchBuffer allows up to 65535)
+static const uint32_t BUFFER_SIZES[] = { 4096, 8192, 16384, 32768 };
+static const uint8_t BUFFER_SIZE_COUNT = sizeof(BUFFER_SIZES) / sizeof(BUFFER_SIZES[0]);
+
+struct LoadProfile {
+    const char* name;
+    uint32_t readMicros;    // Added to every SD read
+    uint32_t stallMs;       // The card stops answering this long...
+    uint32_t stallEveryMs;  // ...this often (0: never)
+    uint32_t uploadKBps;    // Background writes, as from a Wi-Fi upload
+};
+
+static const LoadProfile PROFILES[] = {
+    { "clean",         0,    0,   0,    0   },
+    { "slow card",     2000, 0,   0,    0   },
+    { "card stalls",   0,    120, 2000, 0   },
+    { "upload",        0,    0,   0,    300 },
+    { "upload+stalls", 0,    120, 2000, 300 },
+};
+static const uint8_t PROFILE_COUNT = sizeof(PROFILES) / sizeof(PROFILES[0]);
+
+static const uint8_t MAX_FILES = 16;
+static const uint32_t SAMPLES_PER_FRAME = 1152;  // MPEG-1 Layer III
+
+// ============================================================================
+// Test doubles
+// ============================================================================
+
+// Sits between the SD file and the read-ahead buffer and slows reads down.
+// The delay happens under the SD bus lock, as a busy card would hold it.
+class LatencySource : public AudioFileSource {
+public:
+    LatencySource(AudioFileSource* src, const LoadProfile& profile)
+        : _src(src), _profile(profile), _lastStall(millis()) {}
+    
+    virtual uint32_t read(void* data, uint32_t len) override {
+        delayRead();
+        return _src->read(data, len);
+    }
+    virtual uint32_t readNonBlock(void* data, uint32_t len) override {
+        delayRead();
+        return _src->readNonBlock(data, len);
+    }
+    virtual bool seek(int32_t pos, int dir) override { return _src->seek(pos, dir); }
+    virtual bool close() override { return _src->close(); }
+    virtual bool isOpen() override { return _src->isOpen(); }
+    virtual uint32_t getSize() override { return _src->getSize(); }
+    virtual uint32_t getPos() override { return _src->getPos(); }
+
+private:
+    AudioFileSource* _src;
+    const LoadProfile& _profile;
+    unsigned long _lastStall;
+    
+    void delayRead() {
+        if (_profile.readMicros > 0) {
+            delayMicroseconds(_profile.readMicros);
+        }
+        if (_profile.stallEveryMs > 0 && millis() - _lastStall >= _profile.stallEveryMs) {
+            delay(_profile.stallMs);
+            _lastStall = millis();
+        }
+    }
+};
+
+// Takes samples as fast as the decoder makes them, but like the I2S output
+// only one DMA buffer's worth per decoder loop()
+class NullOutput : public AudioOutput {
+public:
+    NullOutput() : _budget(0), _frames(0), _firstSampleAt(0) {}
+    
+    virtual bool begin() override { return true; }
+    virtual bool stop() override { return true; }
+    virtual bool ConsumeSample(int16_t sample[2]) override {
+        if (_budget == 0) {
+            return false;
+        }
+        if (_frames == 0) {
+            _firstSampleAt = micros();
+        }
+        _budget--;
+        _frames++;
+        return true;
+    }
+    
+    void allow(uint32_t frames) { _budget = frames; }
+    uint32_t getFrames() { return _frames; }
+    uint32_t getFirstSampleAt() { return _firstSampleAt; }
+    int getRate() { return hertz; }
+    int getChannels() { return channels; }
+
+private:
+    uint32_t _budget;
+    uint32_t _frames;
+    uint32_t _firstSampleAt;
+};
+
+// ============================================================================
+// Setup
+// ============================================================================
+
+DecodeBench::DecodeBench()
+    : _out(nullptr), _buffer(nullptr), _decoderState(nullptr), _uploadKBps(0) {}
+
+bool DecodeBench::begin() {
+    _out = new I2SDmaOutput();
+    _out->SetPinout(I2S_BCLK, I2S_LRC, I2S_DOUT);
+    _out->SetGain(DEFAULT_VOLUME);
+    if (!_out->begin()) {
+        return false;
+    }
+    
+    // Same memory as the player's stream buffers
+    const uint32_t largest = BUFFER_SIZES[BUFFER_SIZE_COUNT - 1];
+#ifdef BOARD_HAS_PSRAM
+    if (psramFound()) {
+        _buffer = (uint8_t*)ps_malloc(largest);
+    }
+#endif
+    if (!_buffer) {
+        _buffer = (uint8_t*)malloc(largest);
+    }
+    _decoderState = (uint8_t*)malloc(AudioGeneratorMP3::preAllocSize());
+    if (!_buffer || !_decoderState) {
+        Serial.println("✗ Decode benchmark: not enough memory");
+        return false;
+    }
+    
+    // Where the audio and upload writer tasks run in the firmware
+    xTaskCreatePinnedToCore(loadTask, "BenchLoad", 4096, this, 1, nullptr, 0);
+    xTaskCreatePinnedToCore(benchTask, "DecodeBench", 8192, this, 2, nullptr, 1);
+    return true;
+}
+
+void DecodeBench::benchTask(void* param) {
+    static_cast<DecodeBench*>(param)->run();
+    vTaskDelete(nullptr);
+}
+
+void DecodeBench::loadTask(void* param) {
+    static_cast<DecodeBench*>(param)->runLoad();
+}
+
+// ============================================================================
+// Benchmark (Core 1)
+// ============================================================================
+
+static bool isMp3(const String& name) {
+    String lower = name;
+    lower.toLowerCase();
+    return lower.endsWith(".mp3");
+}
+
+void DecodeBench::run() {
+    static char files[MAX_FILES][AUDIO_MAX_PATH_LENGTH];
+    uint8_t fileCount = 0;
+    
+    {
+        SdLock lock;
+        File dir = SD.open(DECODE_BENCH_DIR);
+        if (dir && dir.isDirectory()) {
+            File file = dir.openNextFile();
+            while (file && fileCount < MAX_FILES) {
+                String name = String(file.name());
+                name = name.substring(name.lastIndexOf('/') + 1);
+                if (!file.isDirectory() && isMp3(name)) {
+                    snprintf(files[fileCount++], AUDIO_MAX_PATH_LENGTH, "%s/%s", DECODE_BENCH_DIR, name.c_str());
+                }
+                file = dir.openNextFile();
+            }
+        }
+    }
+    
+    // Directory order is arbitrary; keep the tables comparable between runs
+    qsort(files, fileCount, AUDIO_MAX_PATH_LENGTH, [](const void* a, const void* b) {
+        return strcmp((const char*)a, (const char*)b);
+    });
+    
+    if (fileCount == 0) {
+        Serial.printf("✗ Decode benchmark: no MP3 files in %s\n", DECODE_BENCH_DIR);
+#ifndef ARDUINO_ARCH_ESP32
+        simExit(1);
+#endif
+        return;
+    }
+    
+    Serial.printf("\n♪ Decoder throughput (null output, up to %d s of audio per file)\n", DECODE_BENCH_SECONDS);
+    Serial.printf("  %-24s %5s %3s %12s %10s %9s\n", "file", "kbps", "ch", "1st sample", "realtime", "us/frame");
+    for (uint8_t f = 0; f < fileCount; f++) {
+        measureThroughput(files[f]);
+    }
+    
+    Serial.printf("\n♪ Underruns / lowest read-ahead fill (%d s real time per run, I2S ring %d x %d frames)\n",
+                  DECODE_BENCH_SECONDS, I2S_DMA_BUF_COUNT, I2S_DMA_BUF_LEN);
+    Serial.printf("  %-24s", "file / load");
+    for (uint8_t b = 0; b < BUFFER_SIZE_COUNT; b++) {
+        Serial.printf(" %6u KB", BUFFER_SIZES[b] / 1024);
+    }
+    Serial.println();
+    
+    uint32_t totals[BUFFER_SIZE_COUNT] = {};
+    for (uint8_t f = 0; f < fileCount; f++) {
+        Serial.printf("  %s\n", files[f] + sizeof(DECODE_BENCH_DIR));
+        for (uint8_t l = 0; l < PROFILE_COUNT; l++) {
+            Serial.printf("    %-22s", PROFILES[l].name);
+            for (uint8_t b = 0; b < BUFFER_SIZE_COUNT; b++) {
+                uint32_t underruns = 0;
+                uint32_t minFill = 0;
+                if (measurePlayback(files[f], BUFFER_SIZES[b], l, underruns, minFill)) {
+                    Serial.printf(" %4u %3u%%", underruns, minFill * 100 / BUFFER_SIZES[b]);
+                    totals[b] += underruns;
+                } else {
+                    Serial.printf(" %9s", "error");
+                }
+            }
+            Serial.println();
+        }
+    }
+    
+    Serial.printf("  %-24s", "total underruns");
+    int8_t smallest = -1;
+    for (uint8_t b = 0; b < BUFFER_SIZE_COUNT; b++) {
+        Serial.printf(" %9u", totals[b]);
+        if (totals[b] == 0 && smallest < 0) {
+            smallest = b;
+        }
+    }
+    Serial.println();
+    
+    if (smallest >= 0) {
+        Serial.printf("✓ Smallest read-ahead without underruns: %u KB (AUDIO_STREAM_BUFFER_SIZE is %d KB)\n",
+                      BUFFER_SIZES[smallest] / 1024, AUDIO_STREAM_BUFFER_SIZE / 1024);
+    } else {
+        Serial.println("⚠ Every read-ahead size underran at least once");
+    }
+
+#ifndef ARDUINO_ARCH_ESP32
+    simExit(0);
+#endif
+}
+
+bool DecodeBench::open(Pipeline& p, const char* path, uint32_t bufferSize, uint8_t profile) {
+    // Heap churn doesn't matter here; the player carves the same objects
+    // from its arena
+    memset(&p, 0, sizeof(p));
+    p.file = new AudioFileSourceSD();
+    bool opened;
+    {
+        SdLock lock(SdLock::PLAYBACK);
+        opened = p.file->open(path);
+    }
+    if (!opened) {
+        Serial.printf("✗ Failed to open %s\n", path);
+        delete p.file;
+        p.file = nullptr;
+        return false;
+    }
+    
+    p.slow = new LatencySource(p.file, PROFILES[profile]);
+    p.buff = new PrefetchBuffer(p.slow, _buffer, bufferSize, AUDIO_PREFETCH_CHUNK);
+    p.id3 = new AudioFileSourceID3(p.buff);
+    p.chain = new TrackChainSource();
+    p.chain->setSource(p.id3);
+    p.mp3 = new AudioGeneratorMP3(_decoderState, AudioGeneratorMP3::preAllocSize());
+    return true;
+}
+
+void DecodeBench::close(Pipeline& p) {
+    if (p.mp3) {
+        if (p.mp3->isRunning()) {
+            p.mp3->stop();
+        }
+        delete p.mp3;
+    }
+    delete p.chain;
+    delete p.id3;
+    delete p.buff;
+    delete p.slow;
+    if (p.file) {
+        SdLock lock(SdLock::PLAYBACK);
+        p.file->close();
+        delete p.file;
+    }
+    memset(&p, 0, sizeof(p));
+}
+
+void DecodeBench::measureThroughput(const char* path) {
+    const char* name = path + sizeof(DECODE_BENCH_DIR);
+    uint32_t start = micros();
+    
+    Pipeline p;
+    NullOutput out;
+    if (!open(p, path, BUFFER_SIZES[BUFFER_SIZE_COUNT - 1], 0) || !p.mp3->begin(p.chain, &out)) {
+        Serial.printf("  %-24s failed to start\n", name);
+        close(p);
+        return;
+    }
+    
+    // Byte offset of the decoder in the file, as the player computes it
+    auto position = [&p]() {
+        uint32_t filePos = p.file->getPos();
+        uint32_t buffered = p.buff->getFillLevel();
+        return filePos > buffered ? filePos - buffered : 0;
+    };
+    
+    uint32_t firstBytes = 0;
+    while (out.getRate() == 0 || out.getFrames() < (uint32_t)out.getRate() * DECODE_BENCH_SECONDS) {
+        uint32_t before = out.getFrames();
+        out.allow(I2S_DMA_BUF_LEN);
+        if (!p.mp3->loop() && out.getFrames() == before) {
+            break;  // End of file
+        }
+        if (before == 0 && out.getFrames() > 0) {
+            firstBytes = position();
+        }
+    }
+    uint32_t end = micros();
+    uint32_t lastBytes = position();
+    close(p);
+    
+    uint32_t frames = out.getFrames();
+    if (frames == 0 || out.getRate() == 0) {
+        Serial.printf("  %-24s no audio decoded\n", name);
+        return;
+    }
+    
+    float seconds = (float)frames / out.getRate();
+    float decodeSeconds = (end - out.getFirstSampleAt()) / 1000000.0f;
+    Serial.printf("  %-24s %5u %3d %9.1f ms %9.1fx %9.0f\n",
+                  name,
+                  (unsigned)((lastBytes - firstBytes) * 8 / seconds / 1000),
+                  out.getChannels(),
+                  (out.getFirstSampleAt() - start) / 1000.0f,
+                  seconds / decodeSeconds,
+                  decodeSeconds * 1000000.0f * SAMPLES_PER_FRAME / frames);
+}
+
+bool DecodeBench::measurePlayback(const char* path, uint32_t bufferSize, uint8_t profile,
+                                  uint32_t& underruns, uint32_t& minFill) {
+    Pipeline p;
+    if (!open(p, path, bufferSize, profile)) {
+        return false;
+    }
+    
+    uint32_t underrunsBefore = _out->getUnderruns();
+    uint32_t startFrame = _out->getFramesConsumed();
+    if (!p.mp3->begin(p.chain, _out)) {
+        close(p);
+        return false;
+    }
+    _uploadKBps = PROFILES[profile].uploadKBps;
+    
+    // Same loop as the audio task
+    minFill = bufferSize;
+    for (;;) {
+        if (!p.mp3->loop()) {
+            break;  // End of file
+        }
+        
+        uint32_t rate = _out->getRate();
+        uint32_t frames = _out->getFramesConsumed() - startFrame;
+        if (frames >= rate * DECODE_BENCH_SECONDS) {
+            break;
+        }
+        
+        // The SD watermarks are fractions of AUDIO_STREAM_BUFFER_SIZE; report
+        // the same fraction of this buffer
+        uint32_t fill = p.buff->sourceEnded() ? bufferSize : p.buff->getFillLevel();
+        sdBus.setPlaybackLevel((uint64_t)fill * AUDIO_STREAM_BUFFER_SIZE / bufferSize);
+        
+        // The buffer starts from one chunk; judge it once it had a second
+        if (frames >= rate && fill < minFill) {
+            minFill = fill;
+        }
+        
+        _out->waitForSpace(pdMS_TO_TICKS(AUDIO_COMMAND_LATENCY_MS));
+    }
+    
+    _uploadKBps = 0;
+    sdBus.setPlaybackIdle();
+    close(p);
+    underruns = _out->getUnderruns() - underrunsBefore;
+    
+    // Let the ring drain so the next run starts from silence
+    delay(100);
+    return true;
+}
+
+// ============================================================================
+// Simulated upload (Core 0)
+// ============================================================================
+
+void DecodeBench::runLoad() {
+    uint8_t* block = (uint8_t*)malloc(UPLOAD_BLOCK_SIZE);
+    if (!block) {
+        Serial.println("✗ Decode benchmark: no memory for the upload block");
+        vTaskDelete(nullptr);
+        return;
+    }
+    memset(block, 0xA5, UPLOAD_BLOCK_SIZE);
+    
+    File file;
+    uint32_t written = 0;
+    for (;;) {
+        uint32_t rate = _uploadKBps;
+        if (rate == 0) {
+            if (file) {
+                SdLock lock;
+                file.close();
+                SD.remove(DECODE_BENCH_LOAD_FILE);
+            }
+            vTaskDelay(pdMS_TO_TICKS(50));
+            continue;
+        }
+        
+        unsigned long start = millis();
+        {
+            // Same lock and block size as UploadWriter
+            SdLock lock;
+            if (!file) {
+                file = SD.open(DECODE_BENCH_LOAD_FILE, FILE_WRITE);
+                written = 0;
+            }
+            if (written >= 1024UL * 1024) {
+                file.seek(0);  // Keep the scratch file at 1 MB
+                written = 0;
+            }
+            written += file.write(block, UPLOAD_BLOCK_SIZE);
+            file.flush();
+        }
+        
+        uint32_t period = UPLOAD_BLOCK_SIZE * 1000UL / (rate * 1024);
+        uint32_t elapsed = millis() - start;
+        if (elapsed < period) {
+            vTaskDelay(pdMS_TO_TICKS(period - elapsed));
+        }
+    }
+}
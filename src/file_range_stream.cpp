@@ -0,0 +1,42 @@
+#include "file_range_stream.h"
+#include "sd_bus.h"
+#include <ESPAsyncWebServer.h>
+#include <algorithm>
+
+FileRangeStream::FileRangeStream(const String& path, uint32_t start, uint32_t length)
+    : _start(start), _length(length) {
+    SdLock lock;
+    _file = SD.open(path, FILE_READ);
+    if (_file && !_file.seek(start)) {
+        _file.close();
+    }
+}
+
+FileRangeStream::~FileRangeStream() {
+    if (_file) {
+        SdLock lock;
+        _file.close();
+    }
+}
+
+size_t FileRangeStream::fill(uint8_t* buffer, size_t maxLen, size_t index) {
+    if (!_file || index >= _length) {
+        return 0;
+    }
+    
+    if (!sdBus.tryLockBackground()) {
+        return RESPONSE_TRY_AGAIN;
+    }
+    
+    size_t toRead = std::min(std::min(maxLen, (size_t)FILE_STREAM_CHUNK), (size_t)(_length - index));
+    uint32_t offset = _start + index;
+    if (_file.position() != offset) {
+        _file.seek(offset);
+    }
+    int n = _file.read(buffer, toRead);
+    sdBus.unlock();
+    
+    // A short read ends the response early; the client sees fewer bytes than
+    // Content-Length and retries the rest with a Range request
+    return (n > 0) ? n : 0;
+}
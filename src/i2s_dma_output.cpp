@@ -0,0 +1,180 @@
+#include "i2s_dma_output.h"
+#include "config.h"
+#include "tap_latency.h"
+
+I2SDmaOutput::I2SDmaOutput(i2s_port_t port)
+    : _port(port), _bclk(I2S_BCLK), _lrc(I2S_LRC), _dout(I2S_DOUT),
+      _installed(false), _events(nullptr), _pendingFrames(0), _framesConsumed(0),
+      _primed(false), _underruns(0) {
+    hertz = AUDIO_SAMPLE_RATE;
+    bps = 16;
+    channels = 2;
+    SetGain(1.0f);
+}
+
+I2SDmaOutput::~I2SDmaOutput() {
+    stop();
+    if (_installed) {
+        i2s_driver_uninstall(_port);
+        _installed = false;
+    }
+}
+
+bool I2SDmaOutput::SetPinout(int bclk, int lrc, int dout) {
+    _bclk = bclk;
+    _lrc = lrc;
+    _dout = dout;
+    return true;
+}
+
+bool I2SDmaOutput::SetRate(int hz) {
+    AudioOutput::SetRate(hz);
+    if (_installed) {
+        i2s_set_sample_rates(_port, hz);
+    }
+    return true;
+}
+
+bool I2SDmaOutput::SetBitsPerSample(int bits) {
+    // Source samples may be 8 or 16 bit; the bus is always 16 bit stereo
+    if (bits != 8 && bits != 16) {
+        return false;
+    }
+    return AudioOutput::SetBitsPerSample(bits);
+}
+
+bool I2SDmaOutput::SetChannels(int channels) {
+    if (channels < 1 || channels > 2) {
+        return false;
+    }
+    return AudioOutput::SetChannels(channels);
+}
+
+bool I2SDmaOutput::begin() {
+    if (_installed) {
+        return true;
+    }
+    
+    i2s_config_t config = {};
+    config.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_TX);
+    config.sample_rate = hertz;
+    config.bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT;
+    config.channel_format = I2S_CHANNEL_FMT_RIGHT_LEFT;
+    config.communication_format = I2S_COMM_FORMAT_STAND_I2S;
+    config.intr_alloc_flags = ESP_INTR_FLAG_LEVEL1;
+    config.dma_buf_count = I2S_DMA_BUF_COUNT;
+    config.dma_buf_len = I2S_DMA_BUF_LEN;
+    config.use_apll = false;
+    config.tx_desc_auto_clear = true;  // Output silence instead of repeating on underrun
+    
+    // One TX_DONE event per DMA buffer, so the queue never needs to be
+    // deeper than the ring itself
+    if (i2s_driver_install(_port, &config, I2S_DMA_BUF_COUNT, &_events) != ESP_OK) {
+        Serial.println("✗ Failed to install I2S driver");
+        return false;
+    }
+    
+    i2s_pin_config_t pins = {};
+    pins.mck_io_num = I2S_PIN_NO_CHANGE;
+    pins.bck_io_num = _bclk;
+    pins.ws_io_num = _lrc;
+    pins.data_out_num = _dout;
+    pins.data_in_num = I2S_PIN_NO_CHANGE;
+    i2s_set_pin(_port, &pins);
+    i2s_zero_dma_buffer(_port);
+    
+    _installed = true;
+    return true;
+}
+
+bool I2SDmaOutput::ConsumeSample(int16_t sample[2]) {
+    if (!_installed) {
+        return false;
+    }
+    
+    // Only try the DMA ring once the local batch is full; this keeps
+    // i2s_write() calls to one per DMA buffer instead of one per sample
+    if (_pendingFrames == I2S_DMA_BUF_LEN && !writePending()) {
+        return false;
+    }
+    
+    int16_t ms[2] = { sample[LEFTCHANNEL], sample[RIGHTCHANNEL] };
+    MakeSampleStereo16(ms);
+    
+    _pending[_pendingFrames * 2] = Amplify(ms[LEFTCHANNEL]);
+    _pending[_pendingFrames * 2 + 1] = Amplify(ms[RIGHTCHANNEL]);
+    _pendingFrames++;
+    _framesConsumed++;
+    tapLatency.mark(TAP_FIRST_FRAME);
+    return true;
+}
+
+bool I2SDmaOutput::writePending() {
+    if (_pendingFrames == 0) {
+        return true;
+    }
+    
+    size_t written = 0;
+    i2s_write(_port, _pending, _pendingFrames * 2 * sizeof(int16_t), &written, 0);
+    
+    size_t framesWritten = written / (2 * sizeof(int16_t));
+    if (framesWritten > 0) {
+        tapLatency.mark(TAP_FIRST_I2S_WRITE);
+    }
+    if (framesWritten < _pendingFrames) {
+        memmove(_pending, _pending + framesWritten * 2,
+                (_pendingFrames - framesWritten) * 2 * sizeof(int16_t));
+    }
+    _pendingFrames -= framesWritten;
+    
+    if (_pendingFrames > 0 && !_primed) {
+        // Ring is full: from here on an overflow event means we fell behind.
+        // Drop the events left over from the drain before this.
+        xQueueReset(_events);
+        _primed = true;
+    }
+    
+    return _pendingFrames < I2S_DMA_BUF_LEN;
+}
+
+bool I2SDmaOutput::waitForSpace(TickType_t timeout) {
+    if (!_events) {
+        vTaskDelay(timeout);
+        return false;
+    }
+    
+    i2s_event_t event;
+    while (xQueueReceive(_events, &event, timeout) == pdTRUE) {
+        if (event.type == I2S_EVENT_TX_DONE) {
+            // Push whatever was held back as soon as there is room
+            writePending();
+            return true;
+        }
+        if (event.type == I2S_EVENT_TX_Q_OVF && _primed) {
+            // The driver re-sent a buffer we hadn't refilled (as silence).
+            // Count the episode once; it re-arms when the ring is full again.
+            _underruns++;
+            _primed = false;
+        }
+    }
+    return false;
+}
+
+void I2SDmaOutput::flush() {
+    // Wait for the held-back samples to reach the DMA ring
+    while (_installed && _pendingFrames > 0) {
+        writePending();
+        if (_pendingFrames > 0) {
+            waitForSpace(pdMS_TO_TICKS(10));
+        }
+    }
+}
+
+bool I2SDmaOutput::stop() {
+    if (_installed) {
+        i2s_zero_dma_buffer(_port);
+    }
+    _pendingFrames = 0;
+    _primed = false;
+    return true;
+}
@@ -0,0 +1,173 @@
+#include "json_list_stream.h"
+#include "storage.h"
+#include <algorithm>
+
+// ============================================================================
+// JsonListStream
+// ============================================================================
+
+JsonListStream::JsonListStream(const char* key, const String& prefix, size_t offset, size_t limit)
+    : _offset(offset), _limit(limit), _key(key), _phase(PHASE_HEAD),
+      _emitted(0), _rowLen(0), _rowSent(0) {
+    strlcpy(_prefix, prefix.c_str(), sizeof(_prefix));
+}
+
+size_t JsonListStream::fill(uint8_t* buffer, size_t maxLen) {
+    size_t written = 0;
+    while (written < maxLen) {
+        if (_rowSent == _rowLen && !produce()) {
+            break;
+        }
+        size_t n = std::min(_rowLen - _rowSent, maxLen - written);
+        memcpy(buffer + written, _row + _rowSent, n);
+        _rowSent += n;
+        written += n;
+    }
+    return written;
+}
+
+bool JsonListStream::produce() {
+    _rowLen = 0;
+    _rowSent = 0;
+    
+    switch (_phase) {
+        case PHASE_HEAD:
+            _rowLen = snprintf(_row, sizeof(_row), "{\"total\":%u,\"offset\":%u,\"%s\":[",
+                               (unsigned)countRows(), (unsigned)_offset, _key);
+            _phase = PHASE_ROWS;
+            return true;
+        
+        case PHASE_ROWS:
+            if (_limit == 0 || _emitted < _limit) {
+                // Rows after the first carry their separator
+                size_t start = (_emitted > 0) ? 1 : 0;
+                if (nextRow(_row + start, sizeof(_row) - start)) {
+                    if (start) {
+                        _row[0] = ',';
+                    }
+                    _rowLen = start + strlen(_row + start);
+                    _emitted++;
+                    return true;
+                }
+            }
+            _phase = PHASE_TAIL;
+            // Fall through
+        
+        case PHASE_TAIL:
+            _rowLen = strlcpy(_row, "]}", sizeof(_row));
+            _phase = PHASE_DONE;
+            return true;
+        
+        default:
+            return false;
+    }
+}
+
+size_t JsonListStream::appendString(char* out, size_t outLen, size_t n, const char* s) {
+    // Reserve room for the closing quote and terminator
+    if (n + 3 > outLen) {
+        return n;
+    }
+    out[n++] = '"';
+    for (; *s; s++) {
+        uint8_t c = *s;
+        char escaped[7];
+        size_t len;
+        if (c == '"' || c == '\\') {
+            escaped[0] = '\\';
+            escaped[1] = c;
+            len = 2;
+        } else if (c < 0x20) {
+            len = snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+        } else {
+            escaped[0] = c;
+            len = 1;
+        }
+        if (n + len + 2 > outLen) {
+            break;
+        }
+        memcpy(out + n, escaped, len);
+        n += len;
+    }
+    out[n++] = '"';
+    out[n] = '\0';
+    return n;
+}
+
+// ============================================================================
+// SongListStream
+// ============================================================================
+
+SongListStream::SongListStream(const String& prefix, size_t offset, size_t limit)
+    : JsonListStream("songs", prefix, offset, limit) {
+    _lastName[0] = '\0';
+}
+
+size_t SongListStream::countRows() {
+    return storage.getCatalog().countPrefix(_prefix);
+}
+
+bool SongListStream::nextRow(char* out, size_t outLen) {
+    MusicCatalog& catalog = storage.getCatalog();
+    CatalogEntry entry;
+    
+    bool found = _lastName[0] ? catalog.nextAfter(_prefix, _lastName, entry)
+                              : catalog.findPrefix(_prefix, _offset, entry);
+    if (!found) {
+        return false;
+    }
+    
+    strlcpy(_lastName, entry.name, sizeof(_lastName));
+    appendString(out, outLen, 0, entry.name);
+    return true;
+}
+
+// ============================================================================
+// TagListStream
+// ============================================================================
+
+TagListStream::TagListStream(const String& prefix, size_t offset, size_t limit)
+    : JsonListStream("tags", prefix, offset, limit), _cursor(0), _skipped(0) {
+    // UIDs are stored as upper-case hex
+    for (char* c = _prefix; *c; c++) {
+        *c = toupper(*c);
+    }
+}
+
+size_t TagListStream::countRows() {
+    char uid[NFC_UID_MAX_LENGTH * 2 + 1];
+    char song[AUDIO_MAX_PATH_LENGTH];
+    size_t prefixLen = strlen(_prefix);
+    size_t count = 0;
+    
+    for (size_t cursor = 0; storage.nextLink(cursor, uid, song, sizeof(song)); ) {
+        if (strncmp(uid, _prefix, prefixLen) == 0) {
+            count++;
+        }
+    }
+    return count;
+}
+
+bool TagListStream::nextRow(char* out, size_t outLen) {
+    char uid[NFC_UID_MAX_LENGTH * 2 + 1];
+    char song[AUDIO_MAX_PATH_LENGTH];
+    size_t prefixLen = strlen(_prefix);
+    
+    while (storage.nextLink(_cursor, uid, song, sizeof(song))) {
+        if (strncmp(uid, _prefix, prefixLen) != 0) {
+            continue;
+        }
+        if (_skipped < _offset) {
+            _skipped++;
+            continue;
+        }
+        
+        size_t n = strlcpy(out, "{\"uid\":", outLen);
+        n = appendString(out, outLen, n, uid);
+        n += strlcpy(out + n, ",\"song\":", outLen - n);
+        n = appendString(out, outLen, n, song);
+        strlcpy(out + n, "}", outLen - n);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,220 @@
+#include "link_journal.h"
+
+#define SNAPSHOT_MAGIC "MBLS"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_TMP_SUFFIX ".tmp"
+
+LinkJournal::LinkJournal() : _journalSize(0) {}
+
+uint32_t LinkJournal::crc32(uint32_t crc, const uint8_t* data, size_t len) {
+    // Bitwise CRC-32 (IEEE); records are tiny so no table is needed
+    crc = ~crc;
+    while (len--) {
+        crc ^= *data++;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+// ============================================================================
+// Records
+// ============================================================================
+
+bool LinkJournal::writeRecord(File& file, RecordType type, const TagUid& uid, const char* path) {
+    size_t pathLength = path ? strlen(path) : 0;
+    if (pathLength >= AUDIO_MAX_PATH_LENGTH) {
+        return false;
+    }
+    
+    // Build the whole record first so it reaches the card in one write
+    uint8_t record[sizeof(RecordHeader) + AUDIO_MAX_PATH_LENGTH + sizeof(uint32_t)];
+    RecordHeader header;
+    header.type = type;
+    header.uid = uid;
+    header.pathLength = pathLength;
+    
+    memcpy(record, &header, sizeof(header));
+    if (pathLength > 0) {
+        memcpy(record + sizeof(header), path, pathLength);
+    }
+    size_t length = sizeof(header) + pathLength;
+    uint32_t crc = crc32(0, record, length);
+    memcpy(record + length, &crc, sizeof(crc));
+    length += sizeof(crc);
+    
+    return file.write(record, length) == length;
+}
+
+bool LinkJournal::readRecord(File& file, RecordHeader& header, char* path) {
+    if (file.read((uint8_t*)&header, sizeof(header)) != sizeof(header)) {
+        return false;
+    }
+    if ((header.type != RECORD_LINK && header.type != RECORD_UNLINK) ||
+        header.uid.length == 0 || header.uid.length > NFC_UID_MAX_LENGTH ||
+        header.pathLength >= AUDIO_MAX_PATH_LENGTH) {
+        return false;
+    }
+    
+    uint32_t crc;
+    if (file.read((uint8_t*)path, header.pathLength) != header.pathLength ||
+        file.read((uint8_t*)&crc, sizeof(crc)) != sizeof(crc)) {
+        return false;
+    }
+    path[header.pathLength] = '\0';
+    
+    uint32_t expected = crc32(0, (const uint8_t*)&header, sizeof(header));
+    expected = crc32(expected, (const uint8_t*)path, header.pathLength);
+    return crc == expected;
+}
+
+// ============================================================================
+// Load
+// ============================================================================
+
+bool LinkJournal::loadSnapshot(const char* filePath, NfcLinkTable& table) {
+    File file = SD.open(filePath, FILE_READ);
+    if (!file) {
+        return false;
+    }
+    
+    SnapshotHeader snapshot;
+    bool ok = file.read((uint8_t*)&snapshot, sizeof(snapshot)) == sizeof(snapshot) &&
+              memcmp(snapshot.magic, SNAPSHOT_MAGIC, 4) == 0 &&
+              snapshot.version == SNAPSHOT_VERSION;
+    
+    table.clear();
+    RecordHeader header;
+    char path[AUDIO_MAX_PATH_LENGTH];
+    for (uint32_t i = 0; ok && i < snapshot.count; i++) {
+        ok = readRecord(file, header, path) && header.type == RECORD_LINK &&
+             table.set(header.uid, path);
+    }
+    file.close();
+    
+    // A snapshot is all or nothing: a short one was cut off while writing
+    if (!ok) {
+        table.clear();
+    }
+    return ok;
+}
+
+bool LinkJournal::load(NfcLinkTable& table) {
+    String tmpPath = String(NFC_LINKS_SNAPSHOT) + SNAPSHOT_TMP_SUFFIX;
+    bool haveSnapshot = loadSnapshot(NFC_LINKS_SNAPSHOT, table);
+    
+    if (!haveSnapshot && loadSnapshot(tmpPath.c_str(), table)) {
+        // Power was lost between removing the old snapshot and the rename
+        Serial.println("⚠ Recovering NFC links from unfinished compaction");
+        SD.remove(NFC_LINKS_SNAPSHOT);
+        SD.rename(tmpPath.c_str(), NFC_LINKS_SNAPSHOT);
+        haveSnapshot = true;
+    } else if (!haveSnapshot && SD.exists(NFC_LINKS_SNAPSHOT)) {
+        Serial.println("✗ NFC links snapshot is corrupt, using journal only");
+    }
+    
+    _journalSize = 0;
+    File file = SD.open(NFC_LINKS_JOURNAL, FILE_READ);
+    if (!file) {
+        return haveSnapshot;
+    }
+    
+    // Replaying is idempotent, so records already folded into the snapshot
+    // by an interrupted compaction are harmless
+    uint32_t fileSize = file.size();
+    uint32_t records = 0;
+    RecordHeader header;
+    char path[AUDIO_MAX_PATH_LENGTH];
+    while (readRecord(file, header, path)) {
+        if (header.type == RECORD_LINK) {
+            table.set(header.uid, path);
+        } else {
+            table.remove(header.uid);
+        }
+        _journalSize = file.position();
+        records++;
+    }
+    file.close();
+    
+    Serial.printf("Replayed %lu NFC link journal records\n", (unsigned long)records);
+    
+    // Anything after the last good record is a torn write. Fold the good
+    // part into a snapshot so new appends don't land behind garbage.
+    if (_journalSize != fileSize) {
+        Serial.printf("⚠ NFC link journal truncated at byte %lu of %lu\n",
+                      (unsigned long)_journalSize, (unsigned long)fileSize);
+        compact(table);
+    }
+    return true;
+}
+
+// ============================================================================
+// Write
+// ============================================================================
+
+bool LinkJournal::append(RecordType type, const TagUid& uid, const char* path) {
+    File file = SD.open(NFC_LINKS_JOURNAL, FILE_APPEND);
+    if (!file) {
+        Serial.println("Failed to open NFC link journal");
+        return false;
+    }
+    
+    bool ok = writeRecord(file, type, uid, path);
+    _journalSize = file.size();
+    file.close();
+    
+    if (!ok) {
+        Serial.println("Failed to append to NFC link journal");
+    }
+    return ok;
+}
+
+bool LinkJournal::appendLink(const TagUid& uid, const char* path) {
+    return append(RECORD_LINK, uid, path);
+}
+
+bool LinkJournal::appendUnlink(const TagUid& uid) {
+    return append(RECORD_UNLINK, uid, nullptr);
+}
+
+bool LinkJournal::compact(const NfcLinkTable& table) {
+    String tmpPath = String(NFC_LINKS_SNAPSHOT) + SNAPSHOT_TMP_SUFFIX;
+    
+    File file = SD.open(tmpPath.c_str(), FILE_WRITE);
+    if (!file) {
+        Serial.println("Failed to open NFC links snapshot for writing");
+        return false;
+    }
+    
+    SnapshotHeader snapshot;
+    memcpy(snapshot.magic, SNAPSHOT_MAGIC, 4);
+    snapshot.version = SNAPSHOT_VERSION;
+    snapshot.reserved = 0;
+    snapshot.count = table.size();
+    
+    bool ok = file.write((const uint8_t*)&snapshot, sizeof(snapshot)) == sizeof(snapshot);
+    table.forEach([&](const TagUid& uid, const char* path) {
+        ok = ok && writeRecord(file, RECORD_LINK, uid, path);
+    });
+    file.close();
+    
+    if (!ok) {
+        Serial.println("Failed to write NFC links snapshot");
+        SD.remove(tmpPath.c_str());
+        return false;
+    }
+    
+    // FAT rename won't replace an existing file. load() handles a crash
+    // between these steps by falling back to the tmp snapshot.
+    SD.remove(NFC_LINKS_SNAPSHOT);
+    if (!SD.rename(tmpPath.c_str(), NFC_LINKS_SNAPSHOT)) {
+        Serial.println("Failed to rename NFC links snapshot");
+        return false;
+    }
+    SD.remove(NFC_LINKS_JOURNAL);
+    _journalSize = 0;
+    
+    Serial.printf("NFC links compacted (%u links)\n", (unsigned)table.size());
+    return true;
+}
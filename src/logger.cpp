@@ -0,0 +1,227 @@
+#include "logger.h"
+#include "metrics.h"
+#include "sd_bus.h"
+#include <algorithm>
+
+Logger logger;
+
+static const char LEVEL_LETTERS[] = "-EWID";
+
+void LogRecord::add(const char* v) {
+    if (argCount == LOG_MAX_ARGS) {
+        return;
+    }
+    if (!v) {
+        v = "(null)";
+    }
+    size_t room = LOG_ARG_BYTES - size;
+    if (room == 0) {
+        types[argCount++] = ARG_MISSING;
+        return;
+    }
+    size_t length = strnlen(v, room - 1);  // Cut to what is left
+    memcpy(&data[size], v, length);
+    data[size + length] = '\0';
+    size += length + 1;
+    types[argCount++] = ARG_STRING;
+}
+
+Logger::Logger()
+    : _head(0), _tail(0), _dropped(0), _droppedReported(0),
+      _sdEnabled(false), _sdLength(0) {
+    for (uint32_t i = 0; i < LOG_QUEUE_SLOTS; i++) {
+        _slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool Logger::begin() {
+    // Lowest priority on Core 0: the UART gets whatever time is left over
+    TaskHandle_t task;
+    if (xTaskCreatePinnedToCore(drainTask, "LogDrain", 4096, this, 1, &task, 0) != pdPASS) {
+        Serial.println("✗ Logger: failed to start task");
+        return false;
+    }
+    metrics.trackTask(task);
+    return true;
+}
+
+void Logger::beginSdLog() {
+    if (LOG_TO_SD) {
+        _sdEnabled = true;
+        Serial.printf("✓ Logging to %s\n", LOG_SD_FILE);
+    }
+}
+
+// ============================================================================
+// Drain task
+// ============================================================================
+
+void Logger::drainTask(void* param) {
+    static_cast<Logger*>(param)->drain();
+}
+
+void Logger::drain() {
+    LogRecord record;
+    char line[LOG_LINE_MAX];
+    
+    for (;;) {
+        while (pop(record)) {
+            size_t length = format(record, line, sizeof(line) - 1);
+            line[length++] = '\n';
+            Serial.write((const uint8_t*)line, length);
+            
+            if (_sdEnabled) {
+                char stamp[24];
+                int n = snprintf(stamp, sizeof(stamp), "%lu.%03lu %c ",
+                                 (unsigned long)(record.timeMs / 1000), (unsigned long)(record.timeMs % 1000),
+                                 LEVEL_LETTERS[record.level]);
+                writeSd(stamp, n);
+                writeSd(line, length);
+            }
+        }
+        
+        uint32_t dropped = _dropped.load(std::memory_order_relaxed);
+        if (dropped != _droppedReported) {
+            Serial.printf("⚠ Log queue full, %u messages dropped\n", (unsigned)(dropped - _droppedReported));
+            _droppedReported = dropped;
+        }
+        
+        flushSd();
+        vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_INTERVAL_MS));
+    }
+}
+
+bool Logger::pop(LogRecord& record) {
+    Slot& slot = _slots[_tail & (LOG_QUEUE_SLOTS - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != _tail + 1) {
+        return false;  // Empty, or the producer is still writing it
+    }
+    record = slot.record;
+    // Free for the producer that claims this slot on the next lap
+    slot.sequence.store(_tail + LOG_QUEUE_SLOTS, std::memory_order_release);
+    _tail++;
+    return true;
+}
+
+// printf over the stored arguments, one conversion at a time. The format was
+// checked against the arguments at compile time; the length modifier picks
+// the type handed to snprintf, the stored type only guards against garbage.
+size_t Logger::format(const LogRecord& record, char* out, size_t outLen) {
+    size_t n = 0;
+    size_t offset = 0;
+    uint8_t arg = 0;
+    const char* p = record.format;
+    
+    while (*p && n + 1 < outLen) {
+        if (*p != '%') {
+            out[n++] = *p++;
+            continue;
+        }
+        
+        // Flags, width, precision and length up to the conversion letter
+        const char* start = p++;
+        while (*p && !strchr("diouxXcsfFeEgGaAp%", *p)) {
+            p++;
+        }
+        if (!*p) {
+            break;
+        }
+        char conversion = *p++;
+        if (conversion == '%') {
+            out[n++] = '%';
+            continue;
+        }
+        char spec[16];
+        size_t specLength = p - start;
+        if (specLength >= sizeof(spec)) {
+            break;
+        }
+        memcpy(spec, start, specLength);
+        spec[specLength] = '\0';
+        
+        // Arguments past LOG_MAX_ARGS were not stored
+        uint8_t type = (arg < record.argCount) ? record.types[arg++] : (uint8_t)LogRecord::ARG_MISSING;
+        const uint8_t* value = &record.data[offset];
+        size_t room = outLen - n;
+        int written = -1;
+        
+        if (type == LogRecord::ARG_STRING) {
+            offset += strlen((const char*)value) + 1;
+            if (conversion == 's') {
+                written = snprintf(&out[n], room, spec, (const char*)value);
+            }
+        } else if (type != LogRecord::ARG_MISSING) {
+            uint64_t bits;
+            memcpy(&bits, value, sizeof(bits));
+            offset += sizeof(bits);
+            
+            if (type == LogRecord::ARG_DOUBLE && strchr("fFeEgGaA", conversion)) {
+                double d;
+                memcpy(&d, &bits, sizeof(d));
+                written = snprintf(&out[n], room, spec, d);
+            } else if (type == LogRecord::ARG_POINTER && conversion == 'p') {
+                written = snprintf(&out[n], room, spec, (void*)(uintptr_t)bits);
+            } else if (type == LogRecord::ARG_INT && strchr("diouxXc", conversion)) {
+                if (strstr(spec, "ll")) {
+                    written = snprintf(&out[n], room, spec, (long long)bits);
+                } else if (strchr(spec, 'l')) {
+                    written = snprintf(&out[n], room, spec, (long)bits);
+                } else if (strchr(spec, 'z')) {
+                    written = snprintf(&out[n], room, spec, (size_t)bits);
+                } else {
+                    written = snprintf(&out[n], room, spec, (int)bits);
+                }
+            }
+        }
+        
+        if (written < 0) {
+            out[n++] = '?';
+        } else {
+            n += ((size_t)written < room) ? (size_t)written : room - 1;
+        }
+    }
+    
+    out[n] = '\0';
+    return n;
+}
+
+// ============================================================================
+// SD log file
+// ============================================================================
+
+void Logger::writeSd(const char* text, size_t length) {
+    if (_sdLength + length > sizeof(_sdBuffer)) {
+        flushSd();
+    }
+    length = std::min(length, sizeof(_sdBuffer) - _sdLength);
+    memcpy(&_sdBuffer[_sdLength], text, length);
+    _sdLength += length;
+}
+
+void Logger::flushSd() {
+    if (_sdLength == 0) {
+        return;
+    }
+    
+    // One write per drain pass, through the arbiter like any background I/O
+    SdLock lock;
+    if (!_sdFile) {
+        _sdFile = SD.open(LOG_SD_FILE, FILE_APPEND);
+        if (!_sdFile) {
+            Serial.printf("✗ Cannot open %s, logging to Serial only\n", LOG_SD_FILE);
+            _sdEnabled = false;
+            _sdLength = 0;
+            return;
+        }
+    }
+    _sdFile.write((const uint8_t*)_sdBuffer, _sdLength);
+    _sdFile.flush();
+    _sdLength = 0;
+    
+    // Keep the current file and one old one
+    if (_sdFile.size() >= LOG_SD_MAX_SIZE) {
+        _sdFile.close();
+        SD.remove(LOG_SD_OLD_FILE);
+        SD.rename(LOG_SD_FILE, LOG_SD_OLD_FILE);
+    }
+}
@@ -1,20 +1,38 @@
 #include <Arduino.h>
 #include <WiFi.h>
 #include "config.h"
+#include "logger.h"
 #include "storage.h"
 #include "nfc_reader.h"
 #include "audio_player.h"
 #include "web_server.h"
+#include "tap_latency.h"
+#include "tap_bench.h"
+#include "decode_bench.h"
+#include "metrics.h"
 
 // Last tag seen for debouncing
-String lastTagUID = "";
+TagUid lastTagUID = {};
 unsigned long lastTagTime = 0;
 
+// Tag that started the current playback, for resume-from-position. A tap
+// fills the spare playlist and swaps it in once playback is requested.
+TagUid playingTagUID = {};
+char playingLink[AUDIO_MAX_PATH_LENGTH] = "";
+Playlist playlists[2];
+uint8_t playingPlaylist = 0;  // Index in playlists of the tag that is playing
+uint8_t playingNextTrack = 0;  // First track of it not handed to the player yet
+bool playbackStarted = false;  // Audio task has picked up the play command
+unsigned long lastPositionSample = 0;
+
 // FreeRTOS task handles
 TaskHandle_t audioTaskHandle = NULL;
 
-void onTagDetected(String uid);
+void onTagDetected(const TagUid& uid);
 void audioTask(void *parameter);
+void samplePlaybackPosition();
+void refillPlayerQueue();
+void reportTapLatency();
 
 void setup() {
     // Initialize serial
@@ -28,6 +46,17 @@ void setup() {
     setCpuFrequencyMhz(240);
     Serial.printf("CPU Frequency: %d MHz\n", getCpuFrequencyMhz());
     
+    // Audio, NFC and web messages go through the log queue from here on
+    logger.begin();
+    
+    if (DECODE_BENCH_SECONDS > 0) {
+        // Decoder benchmark build: only the SD card, no player, NFC or WiFi
+        if (!storage.begin() || !decodeBench.begin()) {
+            Serial.println("✗ Decode benchmark could not start");
+        }
+        return;
+    }
+    
     // Initialize SD card storage
     Serial.println("\n[1/5] Initializing SD Card...");
     if (!storage.begin()) {
@@ -39,6 +68,7 @@ void setup() {
         Serial.println("  - Wiring: CS=GPIO13, SCK=GPIO18, MISO=GPIO19, MOSI=GPIO23");
     } else {
         Serial.println("✓ SD Card ready");
+        logger.beginSdLog();
     }
     
     // Initialize audio player
@@ -97,11 +127,23 @@ void setup() {
         1                    // Core 1 (dedicated to audio)
     );
     
+    metrics.trackTask(audioTaskHandle);
+    metrics.trackTask(xTaskGetCurrentTaskHandle());
+    
     Serial.println("✓ Audio task created on Core 1 (dedicated)");
     Serial.println("✓ Main task running on Core 0");
+    
+    if (TAP_BENCH_TAPS > 0) {
+        tapBench.begin(TAP_BENCH_TAPS);
+    }
 }
 
 void loop() {
+    if (DECODE_BENCH_SECONDS > 0) {
+        delay(1000);  // The benchmark runs in its own task
+        return;
+    }
+    
     // Main loop runs on Core 0 - handles NFC and Web only
     
     // Update NFC reader
@@ -110,40 +152,60 @@ void loop() {
     // Web server is handled by async callbacks
     webServer.loop();
     
+    // Remember where each tag left off; SD writes are batched in storage.loop()
+    samplePlaybackPosition();
+    refillPlayerQueue();
+    storage.loop();
+    
+    // The benchmark collects the tap timings itself
+    if (tapBench.isRunning()) {
+        tapBench.loop();
+    } else {
+        reportTapLatency();
+    }
+    
     // Small delay for NFC/Web tasks (audio runs independently on Core 1)
     delay(10);
 }
 
 // Dedicated audio task running on Core 1
 void audioTask(void *parameter) {
-    Serial.println("[Audio Task] Started on Core 1");
+    LOG_INFO("[Audio Task] Started on Core 1");
+    audioPlayer.attachTask(xTaskGetCurrentTaskHandle());
     
     while (true) {
-        // Process audio continuously without interruption
+        // Apply commands and decode until the DMA ring is full
         audioPlayer.loop();
         
-        // Minimal delay to prevent watchdog (1ms)
-        vTaskDelay(1 / portTICK_PERIOD_MS);
+        // Block until a DMA buffer frees up or a command arrives
+        audioPlayer.waitForWork();
     }
 }
 
-void onTagDetected(String uid) {
+// A tap allocates nothing up to the AudioPlayer commands: the UID stays a
+// TagUid, and the link and its playlist are copied into fixed buffers. Only
+// a linked folder opens File objects, which the SD library allocates.
+void onTagDetected(const TagUid& uid) {
     unsigned long currentTime = millis();
     
-    Serial.println("\n--- NFC Tag Detected ---");
-    Serial.printf("UID: %s\n", uid.c_str());
+    char uidHex[TagUid::HEX_SIZE];
+    uid.toHex(uidHex);
+    tapLatency.mark(TAP_UID_HEX);
+    LOG_INFO("\n--- NFC Tag Detected ---");
+    LOG_INFO("UID: %s", uidHex);
     
     // Check if we have a song linked to this tag
-    String linkedSong = storage.getSongForNFC(uid);
-    
-    if (linkedSong.isEmpty()) {
-        Serial.println("⚠ No song linked to this tag");
-        Serial.println("→ Use the web interface to link a song");
-        Serial.println("------------------------\n");
+    char linkedSong[AUDIO_MAX_PATH_LENGTH];
+    if (!storage.getSongForNFC(uid, linkedSong, sizeof(linkedSong))) {
+        tapLatency.cancel();
+        LOG_WARN("⚠ No song linked to this tag");
+        LOG_INFO("→ Use the web interface to link a song");
+        LOG_INFO("------------------------\n");
         return;
     }
     
-    Serial.printf("♪ Linked song: %s\n", linkedSong.c_str());
+    tapLatency.mark(TAP_LINK_LOOKUP);
+    LOG_INFO("♪ Linked song: %s", linkedSong);
     
     // Behavior logic:
     // 1. If same tag while playing -> pause/resume
@@ -154,31 +216,153 @@ void onTagDetected(String uid) {
     
     if (isSameTag && withinDebounce && audioPlayer.isPlaying()) {
         // Same tag, recently detected, and playing -> PAUSE
-        Serial.println("→ Action: Pausing playback");
+        tapLatency.cancel();
+        LOG_INFO("→ Action: Pausing playback");
         audioPlayer.pause();
+        
+        // The box may be switched off while paused
+        lastPositionSample = 0;
+        samplePlaybackPosition();
+        storage.flushPositions(true);
     } else if (isSameTag && withinDebounce && audioPlayer.isPaused()) {
         // Same tag, recently detected, and paused -> RESUME
-        Serial.println("→ Action: Resuming playback");
+        tapLatency.cancel();
+        LOG_INFO("→ Action: Resuming playback");
         audioPlayer.resume();
     } else {
         // Different tag OR enough time passed OR stopped -> PLAY NEW SONG
-        String fullPath = storage.getMusicPath(linkedSong);
+        // A linked folder plays all of its songs back to back
+        Playlist& tracks = playlists[playingPlaylist ^ 1];
+        bool found = storage.getPlaylist(linkedSong, tracks);
+        tapLatency.mark(TAP_PLAYLIST);
         
-        if (!storage.musicFileExists(linkedSong)) {
-            Serial.println("✗ ERROR: Song file not found!");
-            Serial.println("------------------------\n");
+        if (!found) {
+            tapLatency.cancel();
+            LOG_ERROR("✗ ERROR: Song file not found!");
+            LOG_INFO("------------------------\n");
             return;
         }
         
-        Serial.println("→ Action: Playing song");
-        if (audioPlayer.play(fullPath)) {
-            Serial.println("✓ Playback started successfully");
+        // Save where the previous tag was before switching away from it
+        lastPositionSample = 0;
+        samplePlaybackPosition();
+        
+        // Pick up where this tag left off last time
+        uint8_t startTrack = 0;
+        uint32_t startMs = 0;
+        if (storage.getPosition(uid, linkedSong, startTrack, startMs) &&
+            startTrack < tracks.count && startMs >= RESUME_MIN_POSITION_MS) {
+            startMs -= RESUME_REWIND_MS;
         } else {
-            Serial.println("✗ ERROR: Failed to start playback");
+            startTrack = 0;
+            startMs = 0;
+        }
+        tapLatency.mark(TAP_RESUME_LOOKUP);
+        
+        // Only queues the commands; the audio task opens the file on Core 1
+        LOG_INFO("→ Action: Playing song");
+        if (audioPlayer.play(tracks.tracks[startTrack])) {
+            if (startMs > 0) {
+                LOG_INFO("→ Resuming at %lu ms", (unsigned long)startMs);
+                audioPlayer.seek(startMs);
+            }
+            
+            playingTagUID = uid;
+            strlcpy(playingLink, linkedSong, sizeof(playingLink));
+            playingPlaylist ^= 1;
+            playingNextTrack = startTrack + 1;
+            playbackStarted = false;
+            refillPlayerQueue();
+            LOG_INFO("✓ Playback requested");
+        } else {
+            tapLatency.cancel();
+            LOG_ERROR("✗ ERROR: Failed to request playback");
         }
     }
     
     lastTagUID = uid;
     lastTagTime = currentTime;
-    Serial.println("------------------------\n");
+    LOG_INFO("------------------------\n");
+}
+
+// Core 0: record the position of the tag that is playing. Only updates memory;
+// Storage writes it to SD in batches.
+void samplePlaybackPosition() {
+    unsigned long now = millis();
+    if (lastPositionSample != 0 && now - lastPositionSample < POSITION_SAMPLE_INTERVAL) {
+        return;
+    }
+    lastPositionSample = now;
+    
+    if (playingTagUID.isEmpty()) {
+        return;
+    }
+    
+    if (audioPlayer.getState() == STOPPED) {
+        // Play commands are asynchronous: STOPPED only means "finished" once
+        // the audio task has actually started this tag
+        if (playbackStarted) {
+            storage.setPosition(playingTagUID, playingLink, 0, 0);
+            playingTagUID.clear();
+        }
+        return;
+    }
+    playbackStarted = true;
+    
+    const Playlist& tracks = playlists[playingPlaylist];
+    char song[AUDIO_MAX_PATH_LENGTH];
+    audioPlayer.getCurrentSong(song, sizeof(song));
+    uint8_t track = 0;
+    for (uint8_t i = 0; i < tracks.count; i++) {
+        if (strcmp(tracks.tracks[i], song) == 0) {
+            track = i;
+            break;
+        }
+    }
+    
+    uint32_t positionMs = audioPlayer.getPositionMs();
+    uint32_t durationMs = audioPlayer.getDurationMs();
+    if (durationMs > 0 && positionMs + RESUME_END_MARGIN_MS > durationMs) {
+        // Almost done: the next tap starts the following track (or over)
+        positionMs = 0;
+        if (track + 1 < tracks.count) {
+            track++;
+        } else {
+            track = 0;
+        }
+    }
+    
+    storage.setPosition(playingTagUID, playingLink, track, positionMs);
+}
+
+// Core 0: hand the player the rest of the playing folder as tracks start. Its
+// queue holds AUDIO_PLAYLIST_SIZE tracks; enqueue() refuses the rest until
+// the audio task has loaded one (or, right after a tap, dropped the old ones).
+void refillPlayerQueue() {
+    if (playingTagUID.isEmpty() || (playbackStarted && audioPlayer.getState() == STOPPED)) {
+        return;
+    }
+    
+    const Playlist& tracks = playlists[playingPlaylist];
+    while (playingNextTrack < tracks.count && audioPlayer.enqueue(tracks.tracks[playingNextTrack])) {
+        playingNextTrack++;
+    }
+}
+
+// Core 0: log how long the last tap took to reach the speaker
+void reportTapLatency() {
+    TapTrace trace;
+    if (!tapLatency.takeTrace(trace)) {
+        return;
+    }
+    
+    uint8_t slowest = 0;
+    for (uint8_t i = 1; i < TAP_STAGE_COUNT; i++) {
+        if (trace.stageMicros[i] > trace.stageMicros[slowest]) {
+            slowest = i;
+        }
+    }
+    LOG_INFO("⏱ Tap to first sample: %.1f ms (slowest: %s, %.1f ms)",
+             trace.totalMicros / 1000.0f, TapLatency::stageName((TapStage)slowest),
+             trace.stageMicros[slowest] / 1000.0f);
 }
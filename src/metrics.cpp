@@ -0,0 +1,299 @@
+#include "metrics.h"
+#include "audio_player.h"
+#include "logger.h"
+#include "sd_bus.h"
+#include <esp_heap_caps.h>
+
+Metrics metrics;
+
+// Fill level of the read-ahead buffer, percent
+static const uint32_t FILL_BOUNDS[] = {5, 10, 25, 50, 75, 90, 100};
+// One SD chunk read, microseconds (a 4 KB chunk takes ~1 ms on a good card)
+static const uint32_t SD_READ_BOUNDS[] = {250, 500, 1000, 2000, 4000, 8000, 16000, 32000, 64000, 128000};
+
+static const struct {
+    const char* method;
+    const char* path;
+} ROUTES[HTTP_ROUTE_COUNT] = {
+    {"GET", "/"},
+    {"GET", "/api/songs"},
+    {"POST", "/api/songs/upload"},
+    {"PUT", "/api/songs/*"},
+    {"GET", "/api/songs/*/stream"},
+    {"DELETE", "/api/songs/*"},
+    {"GET", "/api/tags/scan"},
+    {"POST", "/api/tags/scan/clear"},
+    {"POST", "/api/tags/link"},
+    {"GET", "/api/tags"},
+    {"DELETE", "/api/tags/*"},
+    {"GET", "/api/status"},
+    {"POST", "/api/seek"},
+    {"GET", "/api/metrics"},
+    {"ANY", "not_found"},
+};
+
+static void initHistogram(Histogram& h, const uint32_t* bounds, uint8_t count) {
+    h.bounds = bounds;
+    h.boundCount = count;
+    for (uint8_t i = 0; i <= Histogram::MAX_BOUNDS; i++) {
+        h.counts[i] = 0;
+    }
+    h.sum = 0;
+}
+
+Metrics::Metrics()
+    : nfcPolls(0), nfcHits(0), nfcMisses(0), _http(), _tasks(), _taskCount(0),
+      _lastRunTimes(), _lastRunTimeCount(0), _lastTotalRunTime(0) {
+    initHistogram(bufferFill, FILL_BOUNDS, sizeof(FILL_BOUNDS) / sizeof(FILL_BOUNDS[0]));
+    initHistogram(sdReadMicros, SD_READ_BOUNDS, sizeof(SD_READ_BOUNDS) / sizeof(SD_READ_BOUNDS[0]));
+}
+
+void Metrics::recordHttp(HttpRoute route, uint32_t micros, bool request) {
+    RouteStats& stats = _http[route];
+    if (request) {
+        stats.count++;
+    }
+    stats.sumMicros += micros;
+    if (micros > stats.maxMicros) {
+        stats.maxMicros = micros;
+    }
+}
+
+void Metrics::trackTask(TaskHandle_t task) {
+    if (!task) {
+        return;
+    }
+    for (uint8_t i = 0; i < _taskCount; i++) {
+        if (_tasks[i] == task) {
+            return;
+        }
+    }
+    if (_taskCount < MAX_TRACKED_TASKS) {
+        _tasks[_taskCount++] = task;
+    }
+}
+
+uint8_t Metrics::collectTasks(TaskInfo* tasks, uint8_t maxTasks) {
+    uint8_t count = 0;
+
+#if configUSE_TRACE_FACILITY
+    // Every task in the system
+    UBaseType_t total = uxTaskGetNumberOfTasks() + 2;  // Room for tasks created meanwhile
+    TaskStatus_t* status = (TaskStatus_t*)malloc(total * sizeof(TaskStatus_t));
+    if (!status) {
+        return 0;
+    }
+    uint32_t totalRunTime = 0;
+    UBaseType_t n = uxTaskGetSystemState(status, total, &totalRunTime);
+
+#if configGENERATE_RUN_TIME_STATS
+    uint32_t elapsed = totalRunTime - _lastTotalRunTime;
+    TaskRunTime runTimes[MAX_TASKS];
+    uint8_t runTimeCount = 0;
+#endif
+    
+    for (UBaseType_t i = 0; i < n && count < maxTasks; i++) {
+        TaskInfo& info = tasks[count++];
+        info.name = status[i].pcTaskName;
+        info.stackFree = status[i].usStackHighWaterMark;  // Bytes on ESP-IDF
+        info.cpu = -1.0f;
+
+#if configGENERATE_RUN_TIME_STATS
+        // Share since the previous scrape; tasks new since then have no figure yet
+        for (uint8_t j = 0; j < _lastRunTimeCount; j++) {
+            if (_lastRunTimes[j].number == status[i].xTaskNumber && elapsed > 0 && _lastTotalRunTime > 0) {
+                info.cpu = (float)(status[i].ulRunTimeCounter - _lastRunTimes[j].runTime) / (float)elapsed;
+                break;
+            }
+        }
+        if (runTimeCount < MAX_TASKS) {
+            runTimes[runTimeCount].number = status[i].xTaskNumber;
+            runTimes[runTimeCount].runTime = status[i].ulRunTimeCounter;
+            runTimeCount++;
+        }
+#endif
+    }
+
+#if configGENERATE_RUN_TIME_STATS
+    memcpy(_lastRunTimes, runTimes, runTimeCount * sizeof(TaskRunTime));
+    _lastRunTimeCount = runTimeCount;
+    _lastTotalRunTime = totalRunTime;
+#endif
+    
+    free(status);
+#else
+    // No task list without the trace facility: report the tasks the
+    // firmware registered, without CPU figures
+    for (uint8_t i = 0; i < _taskCount && count < maxTasks; i++) {
+        TaskInfo& info = tasks[count++];
+        info.name = pcTaskGetName(_tasks[i]);
+        info.stackFree = uxTaskGetStackHighWaterMark(_tasks[i]);
+        info.cpu = -1.0f;
+    }
+#endif
+    
+    return count;
+}
+
+// ============================================================================
+// Prometheus text format
+// ============================================================================
+
+static void header(Print& out, const char* name, const char* type, const char* help) {
+    out.printf("# HELP musicbox_%s %s\n# TYPE musicbox_%s %s\n", name, help, name, type);
+}
+
+static void metric(Print& out, const char* name, const char* type, const char* help, uint32_t value) {
+    header(out, name, type, help);
+    out.printf("musicbox_%s %u\n", name, (unsigned)value);
+}
+
+static void histogram(Print& out, const char* name, const char* help, const Histogram& h) {
+    header(out, name, "histogram", help);
+    uint32_t cumulative = 0;
+    for (uint8_t i = 0; i < h.boundCount; i++) {
+        cumulative += h.counts[i];
+        out.printf("musicbox_%s_bucket{le=\"%u\"} %u\n", name, (unsigned)h.bounds[i], (unsigned)cumulative);
+    }
+    cumulative += h.counts[h.boundCount];
+    out.printf("musicbox_%s_bucket{le=\"+Inf\"} %u\n", name, (unsigned)cumulative);
+    out.printf("musicbox_%s_sum %u\nmusicbox_%s_count %u\n", name, (unsigned)h.sum, name, (unsigned)cumulative);
+}
+
+typedef size_t (*HeapQuery)(uint32_t caps);
+
+// One family per query: Prometheus wants a family's samples together
+static void heapGauge(Print& out, const char* name, const char* help, HeapQuery query, bool psram) {
+    header(out, name, "gauge", help);
+    out.printf("musicbox_%s{memory=\"internal\"} %u\n", name, (unsigned)query(MALLOC_CAP_INTERNAL));
+    if (psram) {
+        out.printf("musicbox_%s{memory=\"psram\"} %u\n", name, (unsigned)query(MALLOC_CAP_SPIRAM));
+    }
+}
+
+void Metrics::writePrometheus(Print& out) {
+    metric(out, "uptime_seconds", "counter", "Seconds since boot", millis() / 1000);
+    
+    // Audio
+    metric(out, "audio_frames_total", "counter", "Sample frames decoded and sent to I2S", audioPlayer.getFramesDecoded());
+    metric(out, "audio_underruns_total", "counter", "Times the I2S DMA ring ran dry while playing", audioPlayer.getUnderruns());
+    header(out, "audio_cpu_load", "gauge", "Share of the last second the audio task spent awake");
+    out.printf("musicbox_audio_cpu_load %.3f\n", audioPlayer.getCpuLoad());
+    histogram(out, "audio_buffer_fill_percent", "Read-ahead buffer fill, sampled every audio loop", bufferFill);
+    histogram(out, "sd_read_microseconds", "Playback SD chunk read time", sdReadMicros);
+    metric(out, "sd_background_timeouts_total", "counter", "Times background SD I/O stopped waiting for playback", sdBus.getBackgroundTimeouts());
+    
+    // NFC
+    metric(out, "nfc_polls_total", "counter", "NFC detection attempts", nfcPolls);
+    metric(out, "nfc_hits_total", "counter", "NFC polls that read a tag", nfcHits);
+    metric(out, "nfc_misses_total", "counter", "NFC polls that found no tag", nfcMisses);
+    metric(out, "log_dropped_total", "counter", "Log messages dropped because the queue was full", logger.getDropped());
+    
+    // HTTP
+    header(out, "http_requests_total", "counter", "HTTP requests per route");
+    for (uint8_t i = 0; i < HTTP_ROUTE_COUNT; i++) {
+        out.printf("musicbox_http_requests_total{method=\"%s\",route=\"%s\"} %u\n",
+                   ROUTES[i].method, ROUTES[i].path, (unsigned)_http[i].count);
+    }
+    header(out, "http_handler_microseconds_total", "counter", "Time spent in route handlers, including body and upload chunks");
+    for (uint8_t i = 0; i < HTTP_ROUTE_COUNT; i++) {
+        out.printf("musicbox_http_handler_microseconds_total{method=\"%s\",route=\"%s\"} %u\n",
+                   ROUTES[i].method, ROUTES[i].path, (unsigned)_http[i].sumMicros);
+    }
+    header(out, "http_handler_max_microseconds", "gauge", "Longest single handler call since boot");
+    for (uint8_t i = 0; i < HTTP_ROUTE_COUNT; i++) {
+        out.printf("musicbox_http_handler_max_microseconds{method=\"%s\",route=\"%s\"} %u\n",
+                   ROUTES[i].method, ROUTES[i].path, (unsigned)_http[i].maxMicros);
+    }
+    
+    // Heap
+    bool psram = heap_caps_get_total_size(MALLOC_CAP_SPIRAM) > 0;
+    heapGauge(out, "heap_free_bytes", "Free heap", heap_caps_get_free_size, psram);
+    heapGauge(out, "heap_largest_block_bytes", "Largest free heap block", heap_caps_get_largest_free_block, psram);
+    heapGauge(out, "heap_min_free_bytes", "Lowest free heap since boot", heap_caps_get_minimum_free_size, psram);
+    
+    // Tasks
+    TaskInfo tasks[MAX_TASKS];
+    uint8_t taskCount = collectTasks(tasks, MAX_TASKS);
+    header(out, "task_stack_free_bytes", "gauge", "Stack never used since the task started");
+    for (uint8_t i = 0; i < taskCount; i++) {
+        out.printf("musicbox_task_stack_free_bytes{task=\"%s\"} %u\n", tasks[i].name, (unsigned)tasks[i].stackFree);
+    }
+    header(out, "task_cpu_ratio", "gauge", "Share of one core used since the previous scrape");
+    for (uint8_t i = 0; i < taskCount; i++) {
+        if (tasks[i].cpu >= 0.0f) {
+            out.printf("musicbox_task_cpu_ratio{task=\"%s\"} %.4f\n", tasks[i].name, tasks[i].cpu);
+        }
+    }
+}
+
+// ============================================================================
+// JSON
+// ============================================================================
+
+static void jsonHistogram(Print& out, const char* key, const Histogram& h) {
+    out.printf("\"%s\":{\"bounds\":[", key);
+    for (uint8_t i = 0; i < h.boundCount; i++) {
+        out.printf(i ? ",%u" : "%u", (unsigned)h.bounds[i]);
+    }
+    out.print("],\"counts\":[");
+    for (uint8_t i = 0; i <= h.boundCount; i++) {
+        out.printf(i ? ",%u" : "%u", (unsigned)h.counts[i]);
+    }
+    out.printf("],\"sum\":%u}", (unsigned)h.sum);
+}
+
+static void jsonHeap(Print& out, const char* key, uint32_t caps) {
+    out.printf("\"%s\":{\"free\":%u,\"largestBlock\":%u,\"minFree\":%u}", key,
+               (unsigned)heap_caps_get_free_size(caps),
+               (unsigned)heap_caps_get_largest_free_block(caps),
+               (unsigned)heap_caps_get_minimum_free_size(caps));
+}
+
+// Histogram counts are per bucket here, not cumulative; the last one is the
+// overflow above the highest bound
+void Metrics::writeJson(Print& out) {
+    out.printf("{\"uptimeMs\":%u,", (unsigned)millis());
+    
+    out.printf("\"audio\":{\"frames\":%u,\"underruns\":%u,\"cpuLoad\":%.3f,",
+               (unsigned)audioPlayer.getFramesDecoded(), (unsigned)audioPlayer.getUnderruns(),
+               audioPlayer.getCpuLoad());
+    jsonHistogram(out, "bufferFillPercent", bufferFill);
+    out.print("},");
+    
+    out.print("\"sd\":{");
+    jsonHistogram(out, "readMicros", sdReadMicros);
+    out.printf(",\"backgroundTimeouts\":%u},", (unsigned)sdBus.getBackgroundTimeouts());
+    
+    out.printf("\"nfc\":{\"polls\":%u,\"hits\":%u,\"misses\":%u},",
+               (unsigned)nfcPolls, (unsigned)nfcHits, (unsigned)nfcMisses);
+    out.printf("\"logDropped\":%u,", (unsigned)logger.getDropped());
+    
+    out.print("\"http\":[");
+    for (uint8_t i = 0; i < HTTP_ROUTE_COUNT; i++) {
+        out.printf("%s{\"method\":\"%s\",\"route\":\"%s\",\"requests\":%u,\"totalMicros\":%u,\"maxMicros\":%u}",
+                   i ? "," : "", ROUTES[i].method, ROUTES[i].path,
+                   (unsigned)_http[i].count, (unsigned)_http[i].sumMicros, (unsigned)_http[i].maxMicros);
+    }
+    out.print("],");
+    
+    out.print("\"heap\":{");
+    jsonHeap(out, "internal", MALLOC_CAP_INTERNAL);
+    if (heap_caps_get_total_size(MALLOC_CAP_SPIRAM) > 0) {
+        out.print(",");
+        jsonHeap(out, "psram", MALLOC_CAP_SPIRAM);
+    }
+    out.print("},");
+    
+    TaskInfo tasks[MAX_TASKS];
+    uint8_t taskCount = collectTasks(tasks, MAX_TASKS);
+    out.print("\"tasks\":[");
+    for (uint8_t i = 0; i < taskCount; i++) {
+        out.printf("%s{\"name\":\"%s\",\"stackFree\":%u", i ? "," : "", tasks[i].name, (unsigned)tasks[i].stackFree);
+        if (tasks[i].cpu >= 0.0f) {
+            out.printf(",\"cpu\":%.4f", tasks[i].cpu);
+        }
+        out.print("}");
+    }
+    out.print("]}");
+}
@@ -0,0 +1,442 @@
+#include "mp3_seek_index.h"
+#include "logger.h"
+
+// On-disk cache layout (little endian):
+//   header, then _entryCount x uint32_t for MODE_SCAN or 100 bytes for MODE_TOC
+struct SeekIndexHeader {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t mode;
+    uint16_t samplesPerFrame;
+    uint32_t fileSize;        // Cache is discarded if the MP3 changes size
+    uint32_t dataStart;
+    uint32_t dataBytes;
+    uint32_t sampleRate;
+    uint32_t bitrate;
+    uint32_t frameCount;
+    uint16_t entryCount;
+    uint16_t interval;
+};
+
+#define SEEK_INDEX_MAGIC 0x4953424D  // "MBSI"
+#define SEEK_INDEX_VERSION 1
+#define SEEK_INDEX_CBR_PROBES 8
+
+static const uint16_t BITRATES_V1[16] = {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0};
+static const uint16_t BITRATES_V2[16] = {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0};
+static const uint16_t SAMPLE_RATES[3] = {44100, 48000, 32000};
+
+static uint32_t readBE32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+Mp3SeekIndex::Mp3SeekIndex()
+    : _mode(MODE_NONE), _complete(false), _fileSize(0), _dataStart(0), _dataBytes(0),
+      _sampleRate(0), _samplesPerFrame(0), _bitrate(0), _frameCount(0),
+      _entryCount(0), _interval(1), _scanPos(0), _scanFrames(0) {
+    _path[0] = '\0';
+}
+
+bool Mp3SeekIndex::open(const char* mp3Path) {
+    close();
+    strlcpy(_path, mp3Path, sizeof(_path));
+    
+    _file = SD.open(mp3Path, FILE_READ);
+    if (!_file) {
+        return false;
+    }
+    _fileSize = _file.size();
+    
+    if (loadCache()) {
+        _file.close();
+        return true;
+    }
+    
+    _dataStart = skipId3v2();
+    _dataBytes = _fileSize - _dataStart;
+    
+    uint32_t firstPos;
+    FrameInfo first;
+    if (!findFrame(_dataStart, firstPos, first)) {
+        _file.close();
+        return false;
+    }
+    _dataStart = firstPos;
+    _dataBytes = _fileSize - _dataStart;
+    _sampleRate = first.sampleRate;
+    _samplesPerFrame = first.samplesPerFrame;
+    _bitrate = first.bitrate;
+    
+    if (parseVbrHeader(first) || probeCbr(first)) {
+        _complete = true;
+        _file.close();
+        saveCache();
+        return true;
+    }
+    
+    // Variable bitrate without a TOC: scan while the track plays
+    _mode = MODE_SCAN;
+    _scanPos = _dataStart;
+    _scanFrames = 0;
+    _entryCount = 0;
+    _interval = 1;
+    LOG_INFO("Seek index: scanning %s", mp3Path);
+    return true;
+}
+
+void Mp3SeekIndex::close() {
+    if (_file) {
+        _file.close();
+    }
+    _mode = MODE_NONE;
+    _complete = false;
+    _path[0] = '\0';
+}
+
+bool Mp3SeekIndex::buildStep(uint32_t maxFrames) {
+    if (_complete || _mode != MODE_SCAN || !_file) {
+        return _complete;
+    }
+    
+    FrameInfo info;
+    for (uint32_t i = 0; i < maxFrames; i++) {
+        if (_scanPos + 4 > _fileSize || !readFrameAt(_scanPos, info)) {
+            // End of audio (or trailing tags)
+            _frameCount = _scanFrames;
+            _dataBytes = _scanPos - _dataStart;
+            _complete = true;
+            _file.close();
+            saveCache();
+            LOG_INFO("Seek index: %u frames, %u entries", (unsigned)_frameCount, (unsigned)_entryCount);
+            return true;
+        }
+        
+        if (_scanFrames % _interval == 0) {
+            addEntry(_scanPos);
+        }
+        _scanPos += info.length;
+        _scanFrames++;
+    }
+    return false;
+}
+
+void Mp3SeekIndex::addEntry(uint32_t offset) {
+    if (_entryCount == AUDIO_SEEK_INDEX_ENTRIES) {
+        // Table full: keep every other entry and halve the resolution
+        for (uint16_t i = 0; i < AUDIO_SEEK_INDEX_ENTRIES / 2; i++) {
+            _entries[i] = _entries[i * 2];
+        }
+        _entryCount = AUDIO_SEEK_INDEX_ENTRIES / 2;
+        _interval *= 2;
+        if (_scanFrames % _interval != 0) {
+            return;
+        }
+    }
+    _entries[_entryCount++] = offset;
+}
+
+uint32_t Mp3SeekIndex::lookup(uint32_t positionMs) {
+    if (_mode == MODE_NONE || positionMs == 0) {
+        return _dataStart;
+    }
+    
+    uint32_t duration = getDurationMs();
+    if (duration > 0 && positionMs >= duration) {
+        return _dataStart + _dataBytes;
+    }
+    
+    switch (_mode) {
+        case MODE_CBR:
+            return _dataStart + (uint32_t)((uint64_t)positionMs * _bitrate / 8000);
+        
+        case MODE_TOC: {
+            // Linear interpolation between the two surrounding TOC points
+            float percent = (float)positionMs * 100.0f / (float)duration;
+            int index = (int)percent;
+            if (index > 99) index = 99;
+            float a = _toc[index];
+            float b = (index < 99) ? _toc[index + 1] : 256.0f;
+            float scaled = a + (b - a) * (percent - index);
+            return _dataStart + (uint32_t)(scaled / 256.0f * _dataBytes);
+        }
+        
+        case MODE_SCAN: {
+            if (_entryCount == 0) {
+                return _dataStart;
+            }
+            
+            uint32_t frame = (uint32_t)((uint64_t)positionMs * _sampleRate / 1000 / _samplesPerFrame);
+            uint32_t index = frame / _interval;
+            if (index >= _entryCount) {
+                // Not scanned that far yet: extrapolate from the bitrate
+                uint32_t last = _entries[_entryCount - 1];
+                uint32_t lastMs = frameToMs((_entryCount - 1) * _interval);
+                return last + (uint32_t)((uint64_t)(positionMs - lastMs) * _bitrate / 8000);
+            }
+            
+            uint32_t base = _entries[index];
+            uint32_t next = (index + 1 < _entryCount) ? _entries[index + 1] : _dataStart + _dataBytes;
+            uint32_t within = frame - index * _interval;
+            return base + (uint32_t)((uint64_t)(next - base) * within / _interval);
+        }
+        
+        default:
+            return _dataStart;
+    }
+}
+
+uint32_t Mp3SeekIndex::getDurationMs() {
+    if (_mode == MODE_CBR && _bitrate > 0) {
+        return (uint32_t)((uint64_t)_dataBytes * 8000 / _bitrate);
+    }
+    if (_frameCount > 0) {
+        return frameToMs(_frameCount);
+    }
+    return 0;
+}
+
+uint32_t Mp3SeekIndex::getBitrate() {
+    if (_mode == MODE_CBR) {
+        return _bitrate;
+    }
+    uint32_t duration = getDurationMs();
+    if (duration > 0) {
+        return (uint32_t)((uint64_t)_dataBytes * 8000 / duration);
+    }
+    return _bitrate;
+}
+
+uint32_t Mp3SeekIndex::frameToMs(uint32_t frame) {
+    if (_sampleRate == 0) {
+        return 0;
+    }
+    return (uint32_t)((uint64_t)frame * _samplesPerFrame * 1000 / _sampleRate);
+}
+
+// ============================================================================
+// MPEG audio parsing
+// ============================================================================
+
+bool Mp3SeekIndex::parseHeader(const uint8_t* h, FrameInfo& info) {
+    if (h[0] != 0xFF || (h[1] & 0xE0) != 0xE0) {
+        return false;
+    }
+    
+    uint8_t version = (h[1] >> 3) & 0x03;     // 0: 2.5, 2: 2, 3: 1
+    uint8_t layer = (h[1] >> 1) & 0x03;       // 1: Layer III
+    uint8_t bitrateIndex = (h[2] >> 4) & 0x0F;
+    uint8_t rateIndex = (h[2] >> 2) & 0x03;
+    uint8_t padding = (h[2] >> 1) & 0x01;
+    bool mono = ((h[3] >> 6) & 0x03) == 0x03;
+    
+    if (version == 1 || layer != 1 || bitrateIndex == 0 || bitrateIndex == 15 || rateIndex == 3) {
+        return false;
+    }
+    
+    bool mpeg1 = (version == 3);
+    info.bitrate = (mpeg1 ? BITRATES_V1 : BITRATES_V2)[bitrateIndex] * 1000;
+    info.sampleRate = SAMPLE_RATES[rateIndex] >> (mpeg1 ? 0 : (version == 2 ? 1 : 2));
+    info.samplesPerFrame = mpeg1 ? 1152 : 576;
+    info.length = (mpeg1 ? 144 : 72) * info.bitrate / info.sampleRate + padding;
+    info.sideInfoSize = mpeg1 ? (mono ? 17 : 32) : (mono ? 9 : 17);
+    return true;
+}
+
+bool Mp3SeekIndex::readFrameAt(uint32_t pos, FrameInfo& info) {
+    uint8_t header[4];
+    if (!_file.seek(pos) || _file.read(header, 4) != 4) {
+        return false;
+    }
+    return parseHeader(header, info);
+}
+
+bool Mp3SeekIndex::findFrame(uint32_t from, uint32_t& pos, FrameInfo& info) {
+    // Look for two consecutive valid headers to avoid false syncs
+    uint8_t window[512];
+    uint32_t limit = min(_fileSize, from + (uint32_t)AUDIO_SEEK_SYNC_WINDOW);
+    
+    for (uint32_t base = from; base + 4 <= limit; base += sizeof(window) - 3) {
+        if (!_file.seek(base)) {
+            return false;
+        }
+        size_t got = _file.read(window, sizeof(window));
+        for (size_t i = 0; i + 4 <= got; i++) {
+            FrameInfo candidate;
+            if (!parseHeader(&window[i], candidate)) {
+                continue;
+            }
+            FrameInfo following;
+            if (readFrameAt(base + i + candidate.length, following)) {
+                pos = base + i;
+                info = candidate;
+                return true;
+            }
+        }
+        if (got < sizeof(window)) {
+            break;
+        }
+    }
+    return false;
+}
+
+uint32_t Mp3SeekIndex::skipId3v2() {
+    uint8_t h[10];
+    if (!_file.seek(0) || _file.read(h, 10) != 10) {
+        return 0;
+    }
+    if (h[0] != 'I' || h[1] != 'D' || h[2] != '3') {
+        return 0;
+    }
+    // Synchsafe size, plus optional footer
+    uint32_t size = ((uint32_t)(h[6] & 0x7F) << 21) | ((uint32_t)(h[7] & 0x7F) << 14) |
+                    ((uint32_t)(h[8] & 0x7F) << 7) | (h[9] & 0x7F);
+    return 10 + size + ((h[5] & 0x10) ? 10 : 0);
+}
+
+bool Mp3SeekIndex::parseVbrHeader(const FrameInfo& first) {
+    uint8_t buf[120];
+    if (!_file.seek(_dataStart + 4 + first.sideInfoSize) || _file.read(buf, sizeof(buf)) != sizeof(buf)) {
+        return false;
+    }
+    
+    bool xing = memcmp(buf, "Xing", 4) == 0;
+    bool info = memcmp(buf, "Info", 4) == 0;  // Written by LAME for CBR files
+    if (!xing && !info) {
+        return false;
+    }
+    
+    uint32_t flags = readBE32(buf + 4);
+    const uint8_t* p = buf + 8;
+    if (flags & 0x1) {
+        _frameCount = readBE32(p);
+        p += 4;
+    }
+    if (flags & 0x2) {
+        _dataBytes = readBE32(p);
+        p += 4;
+    }
+    
+    // The tag frame itself carries no audio
+    _dataStart += first.length;
+    if (!(flags & 0x2)) {
+        _dataBytes = _fileSize - _dataStart;
+    }
+    
+    if (info) {
+        _mode = MODE_CBR;
+        return true;
+    }
+    
+    if ((flags & 0x4) && _frameCount > 0) {
+        memcpy(_toc, p, sizeof(_toc));
+        _mode = MODE_TOC;
+        return true;
+    }
+    return false;
+}
+
+bool Mp3SeekIndex::probeCbr(const FrameInfo& first) {
+    // Sample frames across the file; any bitrate change means VBR
+    for (uint8_t i = 1; i <= SEEK_INDEX_CBR_PROBES; i++) {
+        uint32_t from = _dataStart + (uint32_t)((uint64_t)_dataBytes * i / (SEEK_INDEX_CBR_PROBES + 2));
+        uint32_t pos;
+        FrameInfo info;
+        if (!findFrame(from, pos, info)) {
+            return false;
+        }
+        if (info.bitrate != first.bitrate || info.sampleRate != first.sampleRate) {
+            return false;
+        }
+    }
+    _mode = MODE_CBR;
+    return true;
+}
+
+// ============================================================================
+// Cache file
+// ============================================================================
+
+void Mp3SeekIndex::cachePath(char* out, size_t len) {
+    snprintf(out, len, "%s%s", _path, SEEK_INDEX_SUFFIX);
+}
+
+bool Mp3SeekIndex::loadCache() {
+    char path[AUDIO_MAX_PATH_LENGTH + sizeof(SEEK_INDEX_SUFFIX)];
+    cachePath(path, sizeof(path));
+    if (!SD.exists(path)) {
+        return false;
+    }
+    
+    File cache = SD.open(path, FILE_READ);
+    if (!cache) {
+        return false;
+    }
+    
+    SeekIndexHeader header;
+    bool ok = cache.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+              header.magic == SEEK_INDEX_MAGIC &&
+              header.version == SEEK_INDEX_VERSION &&
+              header.fileSize == _fileSize &&
+              header.entryCount <= AUDIO_SEEK_INDEX_ENTRIES;
+    
+    if (ok) {
+        _mode = (Mode)header.mode;
+        _samplesPerFrame = header.samplesPerFrame;
+        _dataStart = header.dataStart;
+        _dataBytes = header.dataBytes;
+        _sampleRate = header.sampleRate;
+        _bitrate = header.bitrate;
+        _frameCount = header.frameCount;
+        _entryCount = header.entryCount;
+        _interval = header.interval ? header.interval : 1;
+        
+        if (_mode == MODE_TOC) {
+            ok = cache.read(_toc, sizeof(_toc)) == sizeof(_toc);
+        } else if (_mode == MODE_SCAN) {
+            size_t bytes = _entryCount * sizeof(uint32_t);
+            ok = cache.read((uint8_t*)_entries, bytes) == bytes;
+        }
+    }
+    cache.close();
+    
+    if (!ok) {
+        _mode = MODE_NONE;
+        return false;
+    }
+    _complete = true;
+    return true;
+}
+
+bool Mp3SeekIndex::saveCache() {
+    char path[AUDIO_MAX_PATH_LENGTH + sizeof(SEEK_INDEX_SUFFIX)];
+    cachePath(path, sizeof(path));
+    
+    File cache = SD.open(path, FILE_WRITE);
+    if (!cache) {
+        LOG_ERROR("Failed to write seek index");
+        return false;
+    }
+    
+    SeekIndexHeader header = {};
+    header.magic = SEEK_INDEX_MAGIC;
+    header.version = SEEK_INDEX_VERSION;
+    header.mode = _mode;
+    header.samplesPerFrame = _samplesPerFrame;
+    header.fileSize = _fileSize;
+    header.dataStart = _dataStart;
+    header.dataBytes = _dataBytes;
+    header.sampleRate = _sampleRate;
+    header.bitrate = _bitrate;
+    header.frameCount = _frameCount;
+    header.entryCount = (_mode == MODE_SCAN) ? _entryCount : 0;
+    header.interval = _interval;
+    
+    cache.write((const uint8_t*)&header, sizeof(header));
+    if (_mode == MODE_TOC) {
+        cache.write(_toc, sizeof(_toc));
+    } else if (_mode == MODE_SCAN) {
+        cache.write((const uint8_t*)_entries, _entryCount * sizeof(uint32_t));
+    }
+    cache.close();
+    return true;
+}
@@ -0,0 +1,650 @@
+#include "music_catalog.h"
+#include "mp3_seek_index.h"
+#include "sd_bus.h"
+#include <algorithm>
+
+#define CATALOG_MAGIC "MBMC"
+#define CATALOG_VERSION 1
+
+static bool isMp3Name(const String& name) {
+    return name.endsWith(".mp3") || name.endsWith(".MP3");
+}
+
+static uint32_t synchsafe(const uint8_t* b) {
+    return ((uint32_t)(b[0] & 0x7F) << 21) | ((uint32_t)(b[1] & 0x7F) << 14) |
+           ((uint32_t)(b[2] & 0x7F) << 7) | (b[3] & 0x7F);
+}
+
+static uint32_t bigEndian(const uint8_t* b, uint8_t bytes) {
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < bytes; i++) {
+        value = (value << 8) | b[i];
+    }
+    return value;
+}
+
+// Append one code point as UTF-8; false once out is full
+static bool appendUtf8(char* out, size_t outLen, size_t& n, uint32_t cp) {
+    uint8_t bytes[4];
+    size_t len;
+    if (cp < 0x80) {
+        bytes[0] = cp;
+        len = 1;
+    } else if (cp < 0x800) {
+        bytes[0] = 0xC0 | (cp >> 6);
+        bytes[1] = 0x80 | (cp & 0x3F);
+        len = 2;
+    } else {
+        bytes[0] = 0xE0 | (cp >> 12);
+        bytes[1] = 0x80 | ((cp >> 6) & 0x3F);
+        bytes[2] = 0x80 | (cp & 0x3F);
+        len = 3;
+    }
+    if (n + len >= outLen) {
+        return false;
+    }
+    memcpy(out + n, bytes, len);
+    n += len;
+    return true;
+}
+
+MusicCatalog::MusicCatalog()
+    : _entries(nullptr), _count(0), _capacity(0), _lock(nullptr),
+      _dirty(false), _lastChange(0), _pendingProbes(0) {}
+
+bool MusicCatalog::begin() {
+    if (!_lock) {
+        _lock = xSemaphoreCreateMutex();
+    }
+    
+    unsigned long start = millis();
+    bool loaded = load();
+    scanDirectory();
+    
+    Serial.printf("✓ Music catalog: %u songs (%s, %lu ms), %u to probe\n",
+                  (unsigned)_count, loaded ? "cached" : "rebuilt",
+                  millis() - start, (unsigned)_pendingProbes);
+    return true;
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+size_t MusicCatalog::count() {
+    lock();
+    size_t n = _count;
+    unlock();
+    return n;
+}
+
+bool MusicCatalog::get(size_t index, CatalogEntry& entry) {
+    lock();
+    bool ok = index < _count;
+    if (ok) {
+        entry = _entries[index];
+    }
+    unlock();
+    return ok;
+}
+
+bool MusicCatalog::find(const char* name, CatalogEntry* entry) {
+    lock();
+    int index = indexOf(name, _count);
+    if (index >= 0 && entry) {
+        *entry = _entries[index];
+    }
+    unlock();
+    return index >= 0;
+}
+
+int MusicCatalog::indexOf(const char* name, size_t limit) {
+    size_t lo = 0;
+    size_t hi = limit;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        int cmp = strcmp(_entries[mid].name, name);
+        if (cmp == 0) {
+            return mid;
+        }
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return -1;
+}
+
+size_t MusicCatalog::lowerBound(const char* name, bool strict) {
+    size_t lo = 0;
+    size_t hi = _count;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        int cmp = strcmp(_entries[mid].name, name);
+        if (cmp < 0 || (strict && cmp == 0)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+size_t MusicCatalog::countPrefix(const char* prefix) {
+    size_t prefixLen = strlen(prefix);
+    
+    lock();
+    // Names with the prefix form one run starting at lowerBound(prefix)
+    size_t first = lowerBound(prefix, false);
+    size_t lo = first;
+    size_t hi = _count;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (strncmp(_entries[mid].name, prefix, prefixLen) == 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    unlock();
+    
+    return lo - first;
+}
+
+bool MusicCatalog::findPrefix(const char* prefix, size_t offset, CatalogEntry& entry) {
+    lock();
+    size_t index = lowerBound(prefix, false) + offset;
+    bool ok = index < _count && strncmp(_entries[index].name, prefix, strlen(prefix)) == 0;
+    if (ok) {
+        entry = _entries[index];
+    }
+    unlock();
+    return ok;
+}
+
+bool MusicCatalog::nextAfter(const char* prefix, const char* after, CatalogEntry& entry) {
+    lock();
+    size_t index = after[0] ? lowerBound(after, true) : lowerBound(prefix, false);
+    bool ok = index < _count && strncmp(_entries[index].name, prefix, strlen(prefix)) == 0;
+    if (ok) {
+        entry = _entries[index];
+    }
+    unlock();
+    return ok;
+}
+
+// ============================================================================
+// Updates
+// ============================================================================
+
+bool MusicCatalog::reserve(size_t capacity) {
+    if (capacity <= _capacity) {
+        return true;
+    }
+    size_t newCapacity = std::max(capacity, std::max(_capacity * 2, (size_t)64));
+    
+    CatalogEntry* entries = nullptr;
+#ifdef BOARD_HAS_PSRAM
+    if (psramFound()) {
+        entries = (CatalogEntry*)ps_realloc(_entries, newCapacity * sizeof(CatalogEntry));
+    }
+#endif
+    if (!entries) {
+        entries = (CatalogEntry*)realloc(_entries, newCapacity * sizeof(CatalogEntry));
+    }
+    if (!entries) {
+        Serial.printf("✗ Music catalog: out of memory for %u songs\n", (unsigned)newCapacity);
+        return false;
+    }
+    
+    _entries = entries;
+    _capacity = newCapacity;
+    return true;
+}
+
+CatalogEntry* MusicCatalog::insertSorted(const char* name) {
+    if (!reserve(_count + 1)) {
+        return nullptr;
+    }
+    
+    size_t pos = 0;
+    while (pos < _count && strcmp(_entries[pos].name, name) < 0) {
+        pos++;
+    }
+    memmove(&_entries[pos + 1], &_entries[pos], (_count - pos) * sizeof(CatalogEntry));
+    _count++;
+    
+    memset(&_entries[pos], 0, sizeof(CatalogEntry));
+    strlcpy(_entries[pos].name, name, sizeof(_entries[pos].name));
+    return &_entries[pos];
+}
+
+void MusicCatalog::sortEntries() {
+    std::sort(_entries, _entries + _count, [](const CatalogEntry& a, const CatalogEntry& b) {
+        return strcmp(a.name, b.name) < 0;
+    });
+}
+
+bool MusicCatalog::update(const char* name) {
+    if (strlen(name) >= MAX_FILENAME_LENGTH) {
+        return false;
+    }
+    
+    String path = String(MUSIC_DIR) + "/" + name;
+    CatalogEntry entry;
+    {
+        SdLock busLock;
+        File file = SD.open(path, FILE_READ);
+        if (!file || file.isDirectory()) {
+            return false;
+        }
+        
+        // Probe before taking the catalog lock; it reads from the card
+        memset(&entry, 0, sizeof(entry));
+        strlcpy(entry.name, name, sizeof(entry.name));
+        entry.size = file.size();
+        entry.mtime = file.getLastWrite();
+        file.close();
+        probe(entry);
+    }
+    
+    lock();
+    int index = indexOf(name, _count);
+    CatalogEntry* slot = (index >= 0) ? &_entries[index] : insertSorted(name);
+    if (slot) {
+        if (!(slot->flags & ENTRY_PROBED) && index >= 0) {
+            _pendingProbes--;
+        }
+        *slot = entry;
+        _dirty = true;
+        _lastChange = millis();
+    }
+    unlock();
+    
+    return slot != nullptr;
+}
+
+bool MusicCatalog::remove(const char* name) {
+    lock();
+    int index = indexOf(name, _count);
+    if (index >= 0) {
+        if (!(_entries[index].flags & ENTRY_PROBED)) {
+            _pendingProbes--;
+        }
+        memmove(&_entries[index], &_entries[index + 1], (_count - index - 1) * sizeof(CatalogEntry));
+        _count--;
+        _dirty = true;
+        _lastChange = millis();
+    }
+    unlock();
+    return index >= 0;
+}
+
+// ============================================================================
+// Directory scan
+// ============================================================================
+
+void MusicCatalog::scanDirectory() {
+    SdLock busLock;
+    File root = SD.open(MUSIC_DIR);
+    if (!root || !root.isDirectory()) {
+        Serial.println("Failed to open music directory");
+        return;
+    }
+    
+    lock();
+    
+    // Only the cached (sorted) part is searched; new files are appended and
+    // sorted once at the end
+    size_t cached = _count;
+    bool changed = false;
+    
+    File file = root.openNextFile();
+    while (file) {
+        if (!file.isDirectory()) {
+            String name = String(file.name());
+            name = name.substring(name.lastIndexOf('/') + 1);
+            
+            if (isMp3Name(name) && name.length() < MAX_FILENAME_LENGTH) {
+                uint32_t size = file.size();
+                uint32_t mtime = file.getLastWrite();
+                int index = indexOf(name.c_str(), cached);
+                
+                if (index >= 0) {
+                    CatalogEntry& entry = _entries[index];
+                    if (entry.size != size || entry.mtime != mtime) {
+                        // Changed behind our back (e.g. edited on a PC)
+                        entry.size = size;
+                        entry.mtime = mtime;
+                        entry.flags &= ~ENTRY_PROBED;
+                        changed = true;
+                    }
+                    entry.flags |= ENTRY_SEEN;
+                } else if (reserve(_count + 1)) {
+                    CatalogEntry& entry = _entries[_count++];
+                    memset(&entry, 0, sizeof(entry));
+                    strlcpy(entry.name, name.c_str(), sizeof(entry.name));
+                    entry.size = size;
+                    entry.mtime = mtime;
+                    entry.flags = ENTRY_SEEN;
+                    changed = true;
+                }
+            }
+        }
+        file = root.openNextFile();
+    }
+    
+    // Drop files that are gone and count what still needs probing
+    size_t kept = 0;
+    _pendingProbes = 0;
+    for (size_t i = 0; i < _count; i++) {
+        if (!(_entries[i].flags & ENTRY_SEEN)) {
+            changed = true;
+            continue;
+        }
+        _entries[i].flags &= ~ENTRY_SEEN;
+        if (!(_entries[i].flags & ENTRY_PROBED)) {
+            _pendingProbes++;
+        }
+        if (kept != i) {
+            _entries[kept] = _entries[i];
+        }
+        kept++;
+    }
+    _count = kept;
+    
+    if (changed) {
+        sortEntries();
+        _dirty = true;
+        _lastChange = millis();
+    }
+    
+    unlock();
+}
+
+void MusicCatalog::loop() {
+    if (_pendingProbes > 0) {
+        // One file per call keeps the main loop responsive
+        CatalogEntry entry;
+        bool found = false;
+        
+        lock();
+        for (size_t i = 0; i < _count; i++) {
+            if (!(_entries[i].flags & ENTRY_PROBED)) {
+                entry = _entries[i];
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            _pendingProbes = 0;
+        }
+        unlock();
+        
+        if (found) {
+            {
+                SdLock busLock;
+                probe(entry);
+            }
+            
+            lock();
+            int index = indexOf(entry.name, _count);
+            // Skip if the file was replaced while we were reading it
+            if (index >= 0 && !(_entries[index].flags & ENTRY_PROBED) &&
+                _entries[index].size == entry.size && _entries[index].mtime == entry.mtime) {
+                _entries[index] = entry;
+                _pendingProbes--;
+                _dirty = true;
+                _lastChange = millis();
+            }
+            unlock();
+        }
+        return;
+    }
+    
+    // Save once uploads, deletes and probing have settled
+    if (_dirty && millis() - _lastChange >= CATALOG_SAVE_DELAY) {
+        save();
+    }
+}
+
+// ============================================================================
+// Catalog file
+// ============================================================================
+
+bool MusicCatalog::load() {
+    SdLock busLock;
+    File file = SD.open(CATALOG_FILE, FILE_READ);
+    if (!file) {
+        return false;
+    }
+    
+    FileHeader header;
+    bool ok = file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+              memcmp(header.magic, CATALOG_MAGIC, 4) == 0 &&
+              header.version == CATALOG_VERSION &&
+              header.entrySize == sizeof(CatalogEntry) &&
+              file.size() == sizeof(header) + (size_t)header.count * sizeof(CatalogEntry);
+    
+    lock();
+    if (ok && reserve(header.count)) {
+        size_t bytes = header.count * sizeof(CatalogEntry);
+        ok = file.read((uint8_t*)_entries, bytes) == bytes;
+        _count = ok ? header.count : 0;
+    } else {
+        ok = false;
+    }
+    
+    for (size_t i = 0; i < _count; i++) {
+        CatalogEntry& entry = _entries[i];
+        entry.name[sizeof(entry.name) - 1] = '\0';
+        entry.title[sizeof(entry.title) - 1] = '\0';
+        entry.artist[sizeof(entry.artist) - 1] = '\0';
+        entry.flags &= ~ENTRY_SEEN;
+        if (i > 0 && strcmp(_entries[i - 1].name, entry.name) >= 0) {
+            ok = false;  // Not the sorted, unique list we wrote
+        }
+    }
+    if (!ok) {
+        _count = 0;
+    }
+    unlock();
+    
+    file.close();
+    
+    if (!ok) {
+        Serial.println("⚠ Music catalog file invalid, rebuilding");
+    }
+    return ok;
+}
+
+bool MusicCatalog::save() {
+    SdLock busLock;
+    File file = SD.open(CATALOG_FILE, FILE_WRITE);
+    if (!file) {
+        Serial.println("Failed to open music catalog for writing");
+        return false;
+    }
+    
+    lock();
+    FileHeader header;
+    memcpy(header.magic, CATALOG_MAGIC, 4);
+    header.version = CATALOG_VERSION;
+    header.entrySize = sizeof(CatalogEntry);
+    header.count = _count;
+    
+    size_t bytes = _count * sizeof(CatalogEntry);
+    bool ok = file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+              file.write((const uint8_t*)_entries, bytes) == bytes;
+    _dirty = !ok;
+    unlock();
+    
+    file.close();
+    
+    if (!ok) {
+        // A short file fails validation on the next boot and gets rebuilt
+        Serial.println("Failed to write music catalog");
+    }
+    return ok;
+}
+
+// ============================================================================
+// Metadata probing
+// ============================================================================
+
+bool MusicCatalog::probe(CatalogEntry& entry) {
+    String path = String(MUSIC_DIR) + "/" + entry.name;
+    
+    File file = SD.open(path, FILE_READ);
+    if (file) {
+        readId3v2(file, entry);
+        if (!entry.title[0] && !entry.artist[0]) {
+            readId3v1(file, entry);
+        }
+        file.close();
+    }
+    
+    // Duration and bitrate come from the seek index, which also caches
+    // itself for later seeks. Unindexed VBR files get an estimate.
+    Mp3SeekIndex* index = new Mp3SeekIndex();
+    if (index->open(path.c_str())) {
+        uint32_t bitrate = index->getBitrate();
+        entry.durationMs = index->getDurationMs();
+        if (entry.durationMs == 0 && bitrate > 0) {
+            entry.durationMs = (uint32_t)((uint64_t)entry.size * 8000 / bitrate);
+        }
+        entry.bitrate = bitrate / 1000;
+    }
+    index->close();
+    delete index;
+    
+    // Mark as done even if unreadable, so it isn't retried every loop
+    entry.flags |= ENTRY_PROBED;
+    return entry.durationMs > 0;
+}
+
+void MusicCatalog::readId3v2(File& file, CatalogEntry& entry) {
+    uint8_t h[10];
+    if (!file.seek(0) || file.read(h, 10) != 10 || memcmp(h, "ID3", 3) != 0) {
+        return;
+    }
+    
+    uint8_t version = h[3];
+    if (version < 2 || version > 4) {
+        return;
+    }
+    uint32_t end = 10 + synchsafe(h + 6);
+    uint32_t pos = 10;
+    
+    // Extended header (v2.3 size excludes itself, v2.4 includes it)
+    if (version >= 3 && (h[5] & 0x40)) {
+        uint8_t ext[4];
+        if (file.read(ext, 4) != 4) {
+            return;
+        }
+        pos += (version == 4) ? synchsafe(ext) : 4 + bigEndian(ext, 4);
+    }
+    
+    const uint8_t headerLen = (version == 2) ? 6 : 10;
+    while (pos + headerLen <= end && (!entry.title[0] || !entry.artist[0])) {
+        uint8_t fh[10];
+        if (!file.seek(pos) || file.read(fh, headerLen) != headerLen || fh[0] == 0) {
+            break;  // Padding
+        }
+        
+        uint32_t frameSize;
+        bool isTitle;
+        bool isArtist;
+        if (version == 2) {
+            frameSize = bigEndian(fh + 3, 3);
+            isTitle = memcmp(fh, "TT2", 3) == 0;
+            isArtist = memcmp(fh, "TP1", 3) == 0;
+        } else {
+            frameSize = (version == 4) ? synchsafe(fh + 4) : bigEndian(fh + 4, 4);
+            isTitle = memcmp(fh, "TIT2", 4) == 0;
+            isArtist = memcmp(fh, "TPE1", 4) == 0;
+        }
+        if (frameSize == 0 || pos + headerLen + frameSize > end) {
+            break;
+        }
+        
+        if (isTitle || isArtist) {
+            // Encoding byte plus enough UTF-16 for a full field
+            uint8_t data[1 + 2 + CATALOG_TAG_LENGTH * 2];
+            size_t len = std::min((size_t)frameSize, sizeof(data));
+            if (file.read(data, len) == len && len > 1) {
+                char* out = isTitle ? entry.title : entry.artist;
+                size_t outLen = isTitle ? sizeof(entry.title) : sizeof(entry.artist);
+                copyTagText(out, outLen, data[0], data + 1, len - 1);
+            }
+        }
+        pos += headerLen + frameSize;
+    }
+}
+
+void MusicCatalog::readId3v1(File& file, CatalogEntry& entry) {
+    uint8_t tag[128];
+    if (file.size() < sizeof(tag) || !file.seek(file.size() - sizeof(tag)) ||
+        file.read(tag, sizeof(tag)) != sizeof(tag) || memcmp(tag, "TAG", 3) != 0) {
+        return;
+    }
+    
+    // Fixed 30-byte Latin-1 fields padded with spaces or NULs
+    copyTagText(entry.title, sizeof(entry.title), 0, tag + 3, 30);
+    copyTagText(entry.artist, sizeof(entry.artist), 0, tag + 33, 30);
+    for (char* field : {entry.title, entry.artist}) {
+        size_t n = strlen(field);
+        while (n > 0 && field[n - 1] == ' ') {
+            field[--n] = '\0';
+        }
+    }
+}
+
+void MusicCatalog::copyTagText(char* out, size_t outLen, uint8_t encoding, const uint8_t* data, size_t len) {
+    size_t n = 0;
+    out[0] = '\0';
+    
+    if (encoding == 1 || encoding == 2) {
+        // UTF-16: 1 = with BOM, 2 = big endian without
+        bool bigEndianText = (encoding == 2);
+        size_t i = 0;
+        if (encoding == 1 && len >= 2) {
+            bigEndianText = (data[0] == 0xFE && data[1] == 0xFF);
+            i = 2;
+        }
+        for (; i + 1 < len; i += 2) {
+            uint32_t unit = bigEndianText ? (data[i] << 8) | data[i + 1] : (data[i + 1] << 8) | data[i];
+            if (unit == 0) {
+                break;
+            }
+            if (unit >= 0xD800 && unit <= 0xDFFF) {
+                unit = '?';  // Outside the BMP
+            }
+            if (!appendUtf8(out, outLen, n, unit)) {
+                break;
+            }
+        }
+    } else if (encoding == 3) {
+        // UTF-8: copy whole sequences only
+        size_t i = 0;
+        while (i < len && data[i] != 0) {
+            size_t seqLen = (data[i] < 0x80) ? 1 : (data[i] >= 0xF0) ? 4 : (data[i] >= 0xE0) ? 3 : 2;
+            if (i + seqLen > len || n + seqLen >= outLen) {
+                break;
+            }
+            memcpy(out + n, data + i, seqLen);
+            n += seqLen;
+            i += seqLen;
+        }
+    } else {
+        // ISO-8859-1
+        for (size_t i = 0; i < len && data[i] != 0; i++) {
+            if (!appendUtf8(out, outLen, n, data[i])) {
+                break;
+            }
+        }
+    }
+    
+    out[n] = '\0';
+}
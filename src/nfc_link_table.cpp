@@ -0,0 +1,184 @@
+#include "nfc_link_table.h"
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// NfcLinkTable
+// ============================================================================
+
+NfcLinkTable::NfcLinkTable() : _slots(nullptr), _capacity(0), _count(0), _deleted(0) {}
+
+NfcLinkTable::~NfcLinkTable() {
+    clear();
+}
+
+size_t NfcLinkTable::findSlot(const TagUid& key) const {
+    if (_capacity == 0) {
+        return _capacity;
+    }
+    
+    size_t mask = _capacity - 1;
+    for (size_t i = key.hash() & mask, probes = 0; probes < _capacity; i = (i + 1) & mask, probes++) {
+        if (_slots[i].key.length == SLOT_EMPTY) {
+            break;
+        }
+        if (isUsed(_slots[i]) && _slots[i].key == key) {
+            return i;
+        }
+    }
+    return _capacity;
+}
+
+const char* NfcLinkTable::find(const TagUid& uid) const {
+    size_t i = findSlot(uid);
+    return (i < _capacity) ? _paths[_slots[i].path] : nullptr;
+}
+
+bool NfcLinkTable::next(size_t& cursor, TagUid& uid, const char*& path) const {
+    while (cursor < _capacity) {
+        const Slot& slot = _slots[cursor++];
+        if (isUsed(slot)) {
+            uid = slot.key;
+            path = _paths[slot.path];
+            return true;
+        }
+    }
+    return false;
+}
+
+bool NfcLinkTable::set(const TagUid& uid, const char* path) {
+    if (uid.length == 0 || uid.length > NFC_UID_MAX_LENGTH) {
+        return false;
+    }
+    
+    size_t existing = findSlot(uid);
+    if (existing < _capacity) {
+        int index = internPath(path);
+        if (index < 0) {
+            return false;
+        }
+        releasePath(_slots[existing].path);
+        _slots[existing].path = index;
+        return true;
+    }
+    
+    // Keep the load (including tombstones) under 3/4 so probes stay short
+    if ((_count + _deleted + 1) * 4 > _capacity * 3) {
+        size_t capacity = _capacity ? _capacity : MIN_CAPACITY;
+        while ((_count + 1) * 2 > capacity) {
+            capacity *= 2;
+        }
+        if (!rehash(capacity)) {
+            return false;
+        }
+    }
+    
+    int index = internPath(path);
+    if (index < 0) {
+        return false;
+    }
+    
+    size_t mask = _capacity - 1;
+    size_t i = uid.hash() & mask;
+    while (isUsed(_slots[i])) {
+        i = (i + 1) & mask;
+    }
+    if (_slots[i].key.length == SLOT_DELETED) {
+        _deleted--;
+    }
+    _slots[i].key = uid;
+    _slots[i].path = index;
+    _count++;
+    return true;
+}
+
+bool NfcLinkTable::remove(const TagUid& uid) {
+    size_t i = findSlot(uid);
+    if (i >= _capacity) {
+        return false;
+    }
+    
+    releasePath(_slots[i].path);
+    _slots[i].key.length = SLOT_DELETED;
+    _count--;
+    _deleted++;
+    return true;
+}
+
+void NfcLinkTable::clear() {
+    free(_slots);
+    _slots = nullptr;
+    _capacity = 0;
+    _count = 0;
+    _deleted = 0;
+    
+    for (char* path : _paths) {
+        free(path);
+    }
+    _paths.clear();
+    _pathRefs.clear();
+}
+
+bool NfcLinkTable::rehash(size_t capacity) {
+    Slot* slots = (Slot*)calloc(capacity, sizeof(Slot));
+    if (!slots) {
+        return false;
+    }
+    
+    // Reinsert live entries; tombstones are dropped
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i < _capacity; i++) {
+        if (!isUsed(_slots[i])) {
+            continue;
+        }
+        size_t j = _slots[i].key.hash() & mask;
+        while (slots[j].key.length != SLOT_EMPTY) {
+            j = (j + 1) & mask;
+        }
+        slots[j] = _slots[i];
+    }
+    
+    free(_slots);
+    _slots = slots;
+    _capacity = capacity;
+    _deleted = 0;
+    return true;
+}
+
+int NfcLinkTable::internPath(const char* path) {
+    // Only runs when linking, never on a tag tap
+    int freeIndex = -1;
+    for (size_t i = 0; i < _paths.size(); i++) {
+        if (!_paths[i]) {
+            if (freeIndex < 0) {
+                freeIndex = i;
+            }
+        } else if (strcmp(_paths[i], path) == 0) {
+            _pathRefs[i]++;
+            return i;
+        }
+    }
+    
+    if (freeIndex < 0) {
+        if (_paths.size() > UINT16_MAX) {
+            return -1;
+        }
+        _paths.push_back(nullptr);
+        _pathRefs.push_back(0);
+        freeIndex = _paths.size() - 1;
+    }
+    
+    _paths[freeIndex] = strdup(path);
+    if (!_paths[freeIndex]) {
+        return -1;
+    }
+    _pathRefs[freeIndex] = 1;
+    return freeIndex;
+}
+
+void NfcLinkTable::releasePath(uint16_t index) {
+    if (--_pathRefs[index] == 0) {
+        free(_paths[index]);
+        _paths[index] = nullptr;
+    }
+}
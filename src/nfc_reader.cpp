@@ -1,14 +1,32 @@
 #include "nfc_reader.h"
 #include "config.h"
+#include "logger.h"
+#include "tap_latency.h"
+#include "metrics.h"
 
 NFCReader nfcReader;
 
-NFCReader::NFCReader() 
-    : _nfc(nullptr), _lastReadTime(0), _lastTagTime(0), _hasNewTag(false), _onTagDetected(nullptr) {}
+NFCReader::NFCReader()
+    : _spi(nullptr), _nfc(nullptr), _hasNewTag(false), _onTagDetected(nullptr), _task(nullptr),
+      _armed(false), _lastTagTime(0), _irqAt(0), _retrigger(false),
+      _pendingLock(portMUX_INITIALIZER_UNLOCKED) {
+    _lastUID.clear();
+    _currentUid.clear();
+    _pendingUid.clear();
+}
 
 bool NFCReader::begin() {
+#if NFC_HARDWARE_SPI
+    // HSPI, routed through the GPIO matrix to the same pins software SPI
+    // uses (SD owns VSPI). Started here with our pins: the library's own
+    // begin() finds the bus running and leaves it alone.
+    _spi = new SPIClass(HSPI);
+    _spi->begin(NFC_SCK, NFC_MISO, NFC_MOSI, NFC_SS);
+    _nfc = new Adafruit_PN532(NFC_SS, _spi);
+#else
     // Initialize software SPI for PN532
     _nfc = new Adafruit_PN532(NFC_SCK, NFC_MISO, NFC_MOSI, NFC_SS);
+#endif
     
     _nfc->begin();
     
@@ -28,62 +46,148 @@ bool NFCReader::begin() {
     // Configure board to read RFID tags
     _nfc->SAMConfig();
     
-    Serial.println("NFC Reader initialized");
+    // Above the loop task so a tap is handled right away, below AsyncTCP;
+    // it only runs when the PN532 has something to say
+    xTaskCreatePinnedToCore(taskEntry, "NFCTask", 4096, this, 2, &_task, 0);
+    metrics.trackTask(_task);
+    
+    if (NFC_IRQ >= 0) {
+        pinMode(NFC_IRQ, INPUT_PULLUP);
+        attachInterrupt(digitalPinToInterrupt(NFC_IRQ), onIrq, FALLING);
+        Serial.println("NFC Reader initialized (IRQ)");
+    } else {
+        Serial.println("NFC Reader initialized (polling)");
+    }
     return true;
 }
 
+void NFCReader::retrigger() {
+    _retrigger = true;
+    if (_task) {
+        xTaskNotifyGive(_task);
+    }
+}
+
 void NFCReader::loop() {
-    unsigned long currentTime = millis();
+    portENTER_CRITICAL(&_pendingLock);
+    TagUid uid = _pendingUid;
+    _pendingUid.clear();
+    portEXIT_CRITICAL(&_pendingLock);
     
-    // Poll every NFC_POLL_INTERVAL ms
-    if (currentTime - _lastReadTime < NFC_POLL_INTERVAL) {
+    if (uid.isEmpty()) {
         return;
     }
+    tapLatency.mark(TAP_HANDOFF);
     
-    _lastReadTime = currentTime;
+    _lastUID = uid;
+    _hasNewTag = true;
     
-    uint8_t uid[] = { 0, 0, 0, 0, 0, 0, 0 };
-    uint8_t uidLength;
+    char hex[TagUid::HEX_SIZE];
+    uid.toHex(hex);
+    LOG_INFO("NFC Tag detected: %s", hex);
     
-    // Check for a tag
-    bool success = _nfc->readPassiveTargetID(PN532_MIFARE_ISO14443A, uid, &uidLength, 50);
-    
-    if (success) {
-        String uidStr = uidToString(uid, uidLength);
+    if (_onTagDetected) {
+        _onTagDetected(uid);
+    }
+}
+
+// ============================================================================
+// NFC task (Core 0)
+// ============================================================================
+
+void NFCReader::taskEntry(void* param) {
+    static_cast<NFCReader*>(param)->run();
+}
+
+void IRAM_ATTR NFCReader::onIrq() {
+    nfcReader._irqAt = micros();
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(nfcReader._task, &woken);
+    if (woken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+void NFCReader::run() {
+    for (;;) {
+        uint8_t uid[NFC_UID_MAX_LENGTH] = { 0 };
+        uint8_t uidLength = 0;
+        uint32_t seenAt;
+        bool found;
         
-        // Check if this is a different tag or enough time has passed since last detection
-        if (uidStr != _currentUID || 
-            (currentTime - _lastTagTime > NFC_DEBOUNCE_TIME)) {
-            
-            _currentUID = uidStr;
-            _lastUID = uidStr;
-            _lastTagTime = currentTime;  // Update last tag detection time
-            _hasNewTag = true;
-            
-            Serial.print("NFC Tag detected: ");
-            Serial.println(uidStr);
-            
-            if (_onTagDetected) {
-                _onTagDetected(uidStr);
-            }
+        if (NFC_IRQ >= 0) {
+            // Empty reader: sleep until a tag shows up. Tag present: only
+            // wait long enough to see whether it is still there.
+            TickType_t timeout = !_currentUid.isEmpty() ? pdMS_TO_TICKS(NFC_REMOVAL_TIMEOUT) : portMAX_DELAY;
+            found = waitForTarget(timeout) && _nfc->readDetectedPassiveTargetID(uid, &uidLength);
+            seenAt = _irqAt;  // Reading the response doesn't move it (falling edges only)
+        } else {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(NFC_POLL_INTERVAL));
+            seenAt = micros();
+            found = _nfc->readPassiveTargetID(PN532_MIFARE_ISO14443A, uid, &uidLength, 50);
         }
-    } else {
-        // No tag present
-        if (_currentUID != "") {
-            Serial.println("NFC Tag removed");
-            _currentUID = "";
+        
+        metrics.nfcPolls++;
+        if (found && uidLength > 0 && uidLength <= NFC_UID_MAX_LENGTH) {
+            metrics.nfcHits++;
+            onTarget(TagUid::fromBytes(uid, uidLength), seenAt);
+            if (NFC_IRQ >= 0) {
+                // A resting tag would answer again at once; re-read it at
+                // the poll rate only (retrigger() cuts this short)
+                ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(NFC_POLL_INTERVAL));
+            }
+        } else {
+            metrics.nfcMisses++;
+            if (!_currentUid.isEmpty()) {
+                LOG_INFO("NFC Tag removed");
+                _currentUid.clear();
+            }
         }
     }
 }
 
-String NFCReader::uidToString(uint8_t* uid, uint8_t uidLength) {
-    String uidStr = "";
-    for (uint8_t i = 0; i < uidLength; i++) {
-        if (uid[i] < 0x10) {
-            uidStr += "0";
+bool NFCReader::waitForTarget(TickType_t timeout) {
+    if (!_armed) {
+        if (!_nfc->startPassiveTargetIDDetection(PN532_MIFARE_ISO14443A)) {
+            // No ACK; give the chip a moment before asking again
+            vTaskDelay(pdMS_TO_TICKS(NFC_REMOVAL_TIMEOUT));
+            return false;
+        }
+        _armed = true;
+        // The ACK also pulled IRQ low; only the response counts
+        ulTaskNotifyTake(pdTRUE, 0);
+    }
+    
+    // IRQ stays low until the response is read
+    while (digitalRead(NFC_IRQ) != LOW) {
+        if (ulTaskNotifyTake(pdTRUE, timeout) == 0) {
+            return false;  // Still armed; the next wait picks it up
         }
-        uidStr += String(uid[i], HEX);
     }
-    uidStr.toUpperCase();
-    return uidStr;
+    _armed = false;
+    return true;
+}
+
+void NFCReader::onTarget(const TagUid& uid, uint32_t seenAt) {
+    unsigned long currentTime = millis();
+    
+    if (_retrigger) {
+        _retrigger = false;
+        _currentUid.clear();
+    }
+    
+    // Check if this is a different tag or enough time has passed since last detection
+    if (uid == _currentUid && currentTime - _lastTagTime <= NFC_DEBOUNCE_TIME) {
+        return;
+    }
+    
+    _currentUid = uid;
+    _lastTagTime = currentTime;  // Update last tag detection time
+    
+    tapLatency.start(seenAt);
+    tapLatency.mark(TAP_PN532);
+    
+    portENTER_CRITICAL(&_pendingLock);
+    _pendingUid = uid;
+    portEXIT_CRITICAL(&_pendingLock);
 }
@@ -0,0 +1,94 @@
+#include "prefetch_buffer.h"
+#include "sd_bus.h"
+#include "metrics.h"
+#include "tap_latency.h"
+
+PrefetchBuffer::PrefetchBuffer(AudioFileSource* source, void* buffer, uint32_t size, uint32_t chunkSize)
+    : AudioFileSourceBuffer(source, buffer, size), _chunkSize(chunkSize),
+      _lowWatermark((uint64_t)SD_PLAYBACK_LOW_WATERMARK * size / AUDIO_STREAM_BUFFER_SIZE) {}
+
+bool PrefetchBuffer::prefill() {
+    if (!buffer || filled) {
+        return true;
+    }
+    
+    // Nothing has been consumed yet, so the data is linear from offset 0
+    uint32_t room = buffSize - length;
+    int32_t cnt = (room > 0) ? readChunk(room, false) : 0;
+    if (cnt < 0) {
+        return false;  // Bus busy, next pass
+    }
+    
+    if (cnt == 0 || length == buffSize) {
+        filled = (length > 0);
+        return true;
+    }
+    return false;
+}
+
+uint32_t PrefetchBuffer::read(void* data, uint32_t len) {
+    // The base class would block on a full-buffer refill here. Start
+    // serving as soon as one chunk is in; fill() tops up the rest.
+    if (buffer && !filled) {
+        readChunk(buffSize - length, true);
+        filled = (length > 0);
+        tapLatency.mark(TAP_BUFFER_PRIME);
+    }
+    
+    if (!buffer || len > length) {
+        // The base class reads the shortfall straight from the file
+        SdLock lock(SdLock::PLAYBACK);
+        return AudioFileSourceBuffer::read(data, len);
+    }
+    return AudioFileSourceBuffer::read(data, len);
+}
+
+bool PrefetchBuffer::seek(int32_t pos, int dir) {
+    SdLock lock(SdLock::PLAYBACK);
+    bool ok = AudioFileSourceBuffer::seek(pos, dir);
+    if (length == 0) {
+        // The base class dropped the buffer; refill it one chunk at a time
+        // rather than through a direct read and a forced full refill
+        filled = false;
+    }
+    return ok;
+}
+
+void PrefetchBuffer::fill() {
+    if (!buffer || length >= buffSize) {
+        return;
+    }
+    
+    // Contiguous free region starting at writePtr, with the same gap the
+    // base class keeps in front of readPtr
+    uint32_t room;
+    if (readPtr > writePtr) {
+        room = readPtr - writePtr - 1;
+    } else {
+        room = buffSize - writePtr;
+    }
+    
+    if (room > 0) {
+        readChunk(room, length < _lowWatermark);
+    }
+}
+
+int32_t PrefetchBuffer::readChunk(uint32_t maxBytes, bool urgent) {
+    // Background I/O holds the bus for one operation at most; only wait it
+    // out when the decoder is about to run dry
+    if (!sdBus.lockPlayback(urgent)) {
+        return -1;
+    }
+    
+    uint32_t toRead = (maxBytes < _chunkSize) ? maxBytes : _chunkSize;
+    uint32_t start = micros();
+    int cnt = src->readNonBlock(&buffer[writePtr], toRead);
+    metrics.sdReadMicros.record(micros() - start);
+    sdBus.unlock();
+    if (cnt <= 0) {
+        return 0;
+    }
+    length += cnt;
+    writePtr = (writePtr + cnt) % buffSize;
+    return cnt;
+}
@@ -0,0 +1,70 @@
+#include "sd_bus.h"
+
+SdBus sdBus;
+
+SdBus::SdBus() : _lock(nullptr), _state(nullptr), _slack(true), _backgroundTimeouts(0) {}
+
+bool SdBus::begin() {
+    if (_lock) {
+        return true;
+    }
+    
+    _lock = xSemaphoreCreateRecursiveMutex();
+    _state = xEventGroupCreate();
+    if (!_lock || !_state) {
+        Serial.println("✗ SD bus: out of memory");
+        return false;
+    }
+    
+    xEventGroupSetBits(_state, PLAYBACK_SLACK);
+    return true;
+}
+
+bool SdBus::lockPlayback(bool wait) {
+    // Priority inheritance boosts a background holder until it lets go
+    return xSemaphoreTakeRecursive(_lock, wait ? portMAX_DELAY : 0) == pdTRUE;
+}
+
+void SdBus::lockBackground() {
+    // Nested calls already own the bus; waiting for slack here would only
+    // stretch the operation that is holding it
+    if (xSemaphoreGetMutexHolder(_lock) != xTaskGetCurrentTaskHandle()) {
+        EventBits_t bits = xEventGroupWaitBits(_state, PLAYBACK_SLACK, pdFALSE, pdTRUE,
+                                               pdMS_TO_TICKS(SD_BACKGROUND_MAX_WAIT_MS));
+        if (!(bits & PLAYBACK_SLACK)) {
+            // Playback is barely keeping up (very high bitrate or a slow
+            // card); don't starve uploads and saves forever
+            _backgroundTimeouts++;
+        }
+    }
+    xSemaphoreTakeRecursive(_lock, portMAX_DELAY);
+}
+
+bool SdBus::tryLockBackground() {
+    if (!(xEventGroupGetBits(_state) & PLAYBACK_SLACK) &&
+        xSemaphoreGetMutexHolder(_lock) != xTaskGetCurrentTaskHandle()) {
+        return false;
+    }
+    return xSemaphoreTakeRecursive(_lock, 0) == pdTRUE;
+}
+
+void SdBus::unlock() {
+    xSemaphoreGiveRecursive(_lock);
+}
+
+void SdBus::setPlaybackLevel(uint32_t bytes) {
+    // Hysteresis, so background I/O doesn't start and stop with every chunk
+    if (_slack && bytes < SD_PLAYBACK_LOW_WATERMARK) {
+        _slack = false;
+        xEventGroupClearBits(_state, PLAYBACK_SLACK);
+    } else if (!_slack && bytes >= SD_PLAYBACK_HIGH_WATERMARK) {
+        setPlaybackIdle();
+    }
+}
+
+void SdBus::setPlaybackIdle() {
+    if (!_slack) {
+        _slack = true;
+        xEventGroupSetBits(_state, PLAYBACK_SLACK);
+    }
+}
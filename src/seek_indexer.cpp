@@ -0,0 +1,118 @@
+#include "seek_indexer.h"
+#include "logger.h"
+#include "metrics.h"
+#include "sd_bus.h"
+
+SeekIndexer::SeekIndexer()
+    : _requests(nullptr), _generation(0),
+      _openedGeneration(UINT32_MAX), _readyGeneration(UINT32_MAX) {  // Nothing published yet
+    memset(&_summary, 0, sizeof(_summary));
+}
+
+bool SeekIndexer::begin() {
+    // Lowest priority on Core 0: the table is never urgent, and the SD
+    // arbiter holds it off while the playback buffer runs low
+    _requests = xQueueCreate(1, sizeof(Request));
+    TaskHandle_t task;
+    if (!_requests ||
+        xTaskCreatePinnedToCore(indexerTask, "SeekIndexer", 4096, this, 1, &task, 0) != pdPASS) {
+        Serial.println("✗ Seek indexer: failed to start task");
+        return false;
+    }
+    metrics.trackTask(task);
+    return true;
+}
+
+// ============================================================================
+// Audio task side
+// ============================================================================
+
+void SeekIndexer::request(const char* mp3Path) {
+    post(mp3Path);
+}
+
+void SeekIndexer::cancel() {
+    post("");
+}
+
+void SeekIndexer::post(const char* mp3Path) {
+    // From here on nothing published for the old generation is read again,
+    // so the indexer is free to reuse it once it sees this request
+    Request request;
+    request.generation = ++_generation;
+    strlcpy(request.path, mp3Path, sizeof(request.path));
+    if (_requests) {
+        xQueueOverwrite(_requests, &request);
+    }
+}
+
+bool SeekIndexer::lookup(uint32_t positionMs, uint32_t& offset) {
+    if (isReady()) {
+        offset = _index.lookup(positionMs);
+        return true;
+    }
+    if (!isOpened() || !_summary.valid) {
+        return false;
+    }
+    offset = _summary.dataStart + (uint32_t)((uint64_t)positionMs * _summary.bitrate / 8000);
+    return true;
+}
+
+bool SeekIndexer::hasFailed() {
+    return isOpened() && !_summary.valid;
+}
+
+uint32_t SeekIndexer::getDurationMs() {
+    if (isReady()) {
+        return _index.getDurationMs();
+    }
+    return isOpened() ? _summary.durationMs : 0;
+}
+
+// ============================================================================
+// Indexer task
+// ============================================================================
+
+void SeekIndexer::indexerTask(void* param) {
+    static_cast<SeekIndexer*>(param)->run();
+}
+
+void SeekIndexer::run() {
+    Request request;
+    for (;;) {
+        if (xQueueReceive(_requests, &request, portMAX_DELAY) == pdTRUE) {
+            build(request);
+        }
+    }
+}
+
+void SeekIndexer::build(const Request& request) {
+    _index.close();
+    if (request.path[0] == '\0') {
+        return;
+    }
+    
+    {
+        // Probing reads a few KB; the cache is written here for CBR/TOC files
+        SdLock lock;
+        _summary.valid = _index.open(request.path);
+    }
+    _summary.dataStart = _index.getDataStart();
+    _summary.bitrate = _index.getBitrate();
+    _summary.durationMs = _index.getDurationMs();
+    _openedGeneration.store(request.generation, std::memory_order_release);
+    if (!_summary.valid) {
+        return;
+    }
+    
+    // VBR without a TOC: scan in small steps, so the bus is released often
+    // and a request for the next track cuts the scan short
+    while (!_index.isComplete()) {
+        if (uxQueueMessagesWaiting(_requests) > 0) {
+            return;
+        }
+        SdLock lock;
+        _index.buildStep(AUDIO_SEEK_SCAN_FRAMES);
+    }
+    _readyGeneration.store(request.generation, std::memory_order_release);
+}
@@ -1,12 +1,34 @@
 #include "storage.h"
 #include "config.h"
+#include "logger.h"
+#include "sd_bus.h"
 #include <SPI.h>
 
 Storage storage;
 
-Storage::Storage() : _mounted(false) {}
+Storage::Storage() : _lock(nullptr), _mounted(false), _positionsDirty(false), _lastPositionFlush(0) {}
+
+// FNV-1a, used to notice when a tag is relinked to something else
+static uint32_t hashPath(const char* path) {
+    uint32_t hash = 2166136261u;
+    for (; *path; path++) {
+        hash ^= (uint8_t)*path;
+        hash *= 16777619u;
+    }
+    return hash;
+}
 
 bool Storage::begin() {
+    // Before anything can fail: tags and the web server use storage either way
+    if (!_lock) {
+        _lock = xSemaphoreCreateRecursiveMutex();
+        if (!_lock) {
+            Serial.println("✗ Storage: out of memory");
+            return false;
+        }
+    }
+    sdBus.begin();
+    
     // Explicitly initialize SPI for SD card with correct pins
     SPI.begin(SD_SCK, SD_MISO, SD_MOSI, SD_CS);
     delay(100);  // Give SPI time to stabilize
@@ -26,12 +48,25 @@ bool Storage::begin() {
     _mounted = true;
     
     ensureMusicDirectory();
+    _catalog.begin();
     loadNFCLinks();
+    loadPositions();
     
     return true;
 }
 
+void Storage::loop() {
+    _catalog.loop();
+    flushPositions();
+}
+
+// Catalog entries are keyed by the bare file name
+static String baseName(const String& filename) {
+    return filename.substring(filename.lastIndexOf('/') + 1);
+}
+
 void Storage::ensureMusicDirectory() {
+    SdLock lock;
     if (!SD.exists(MUSIC_DIR)) {
         if (SD.mkdir(MUSIC_DIR)) {
             Serial.println("Created /music directory");
@@ -44,22 +79,12 @@ void Storage::ensureMusicDirectory() {
 std::vector<String> Storage::listMusicFiles() {
     std::vector<String> files;
     
-    File root = SD.open(MUSIC_DIR);
-    if (!root || !root.isDirectory()) {
-        Serial.println("Failed to open music directory");
-        return files;
-    }
+    size_t count = _catalog.count();
+    files.reserve(count);
     
-    File file = root.openNextFile();
-    while (file) {
-        if (!file.isDirectory()) {
-            String filename = String(file.name());
-            // Only include MP3 files
-            if (filename.endsWith(".mp3") || filename.endsWith(".MP3")) {
-                files.push_back(filename);
-            }
-        }
-        file = root.openNextFile();
+    CatalogEntry entry;
+    for (size_t i = 0; i < count && _catalog.get(i, entry); i++) {
+        files.push_back(String(entry.name));
     }
     
     return files;
@@ -67,16 +92,50 @@ std::vector<String> Storage::listMusicFiles() {
 
 bool Storage::deleteMusicFile(const String& filename) {
     String path = getMusicPath(filename);
+    SdLock lock;
     if (SD.remove(path)) {
         Serial.printf("Deleted file: %s\n", path.c_str());
+        _catalog.remove(baseName(filename).c_str());
+        
+        // Drop the cached seek table with it
+        String indexPath = path + SEEK_INDEX_SUFFIX;
+        if (SD.exists(indexPath)) {
+            SD.remove(indexPath);
+        }
         return true;
     }
     return false;
 }
 
-bool Storage::musicFileExists(const String& filename) {
+bool Storage::refreshMusicFile(const String& filename) {
+    return _catalog.update(baseName(filename).c_str());
+}
+
+bool Storage::installMusicFile(const String& tempPath, const String& filename) {
     String path = getMusicPath(filename);
-    return SD.exists(path);
+    {
+        SdLock lock;
+        // FAT can't rename over an existing file. The old song is gone for
+        // a moment, but nobody ever sees a half-written one.
+        if (SD.exists(path)) {
+            SD.remove(path);
+        }
+        if (!SD.rename(tempPath, path)) {
+            Serial.printf("Failed to rename %s\n", tempPath.c_str());
+            return false;
+        }
+        
+        // A seek table cached for the old contents would be wrong
+        String indexPath = path + SEEK_INDEX_SUFFIX;
+        if (SD.exists(indexPath)) {
+            SD.remove(indexPath);
+        }
+    }
+    return refreshMusicFile(filename);
+}
+
+bool Storage::musicFileExists(const String& filename) {
+    return _catalog.find(baseName(filename).c_str());
 }
 
 String Storage::getMusicPath(const String& filename) {
@@ -86,21 +145,117 @@ String Storage::getMusicPath(const String& filename) {
     return String(MUSIC_DIR) + "/" + filename;
 }
 
+// Adds folder/name in name order. A full playlist only takes names before
+// its last one, so it ends up with the first PLAYLIST_MAX_TRACKS songs.
+// false if the song was left out.
+static bool insertTrack(Playlist& playlist, const char* folder, const char* name) {
+    char path[AUDIO_MAX_PATH_LENGTH];
+    if (snprintf(path, sizeof(path), "%s/%s", folder, name) >= (int)sizeof(path)) {
+        return false;
+    }
+    
+    uint8_t i = playlist.count;
+    if (i == PLAYLIST_MAX_TRACKS) {
+        if (strcmp(path, playlist.tracks[i - 1]) >= 0) {
+            return false;
+        }
+        i--;  // The last one makes room
+    } else {
+        playlist.count++;
+    }
+    for (; i > 0 && strcmp(path, playlist.tracks[i - 1]) < 0; i--) {
+        memcpy(playlist.tracks[i], playlist.tracks[i - 1], AUDIO_MAX_PATH_LENGTH);
+    }
+    memcpy(playlist.tracks[i], path, sizeof(path));
+    return true;
+}
+
+bool Storage::getPlaylist(const char* name, Playlist& playlist) {
+    playlist.count = 0;
+    char path[AUDIO_MAX_PATH_LENGTH];
+    int length = (name[0] == '/') ? (int)strlcpy(path, name, sizeof(path))
+                                  : snprintf(path, sizeof(path), "%s/%s", MUSIC_DIR, name);
+    if (length >= (int)sizeof(path)) {
+        LOG_WARN("⚠ Path too long: %s", name);
+        return false;
+    }
+    
+    // Songs directly in /music are answered from the catalog, which is keyed
+    // by file name; folders and the songs inside them need the card
+    const char* top = path + sizeof(MUSIC_DIR);  // After "/music/"
+    if (strncmp(path, MUSIC_DIR "/", sizeof(MUSIC_DIR)) == 0 && !strchr(top, '/') && _catalog.find(top)) {
+        memcpy(playlist.tracks[0], path, sizeof(path));
+        playlist.count = 1;
+        return true;
+    }
+    
+    SdLock lock;
+    File entry = SD.open(path);
+    if (!entry) {
+        return false;
+    }
+    
+    if (!entry.isDirectory()) {
+        // A single song
+        memcpy(playlist.tracks[0], path, sizeof(path));
+        playlist.count = 1;
+        return true;
+    }
+    
+    // A folder inside /music is played as a playlist in name order
+    uint32_t skipped = 0;
+    File file = entry.openNextFile();
+    while (file) {
+        if (!file.isDirectory()) {
+            const char* filename = file.name();
+            const char* base = strrchr(filename, '/');
+            base = base ? base + 1 : filename;
+            size_t baseLength = strlen(base);
+            if (baseLength > 4 && (strcmp(base + baseLength - 4, ".mp3") == 0 ||
+                                   strcmp(base + baseLength - 4, ".MP3") == 0)) {
+                if (!insertTrack(playlist, path, base)) {
+                    skipped++;
+                }
+            }
+        }
+        file = entry.openNextFile();
+    }
+    
+    if (skipped > 0) {
+        LOG_WARN("⚠ %s: %u songs left out (more than %u, or path too long)",
+                 path, (unsigned)skipped, (unsigned)PLAYLIST_MAX_TRACKS);
+    }
+    return playlist.count > 0;
+}
+
 bool Storage::loadNFCLinks() {
+    Lock guard(*this);
+    SdLock lock;
     _nfcLinks.clear();
     
-    if (!SD.exists(NFC_LINKS_FILE)) {
-        Serial.println("NFC links file doesn't exist, creating new one");
-        return saveNFCLinks();
+    if (_linkJournal.load(_nfcLinks)) {
+        Serial.printf("Loaded %u NFC links\n", (unsigned)_nfcLinks.size());
+        return true;
+    }
+    
+    if (SD.exists(NFC_LINKS_FILE)) {
+        return migrateJsonLinks();
     }
     
+    Serial.println("No NFC links saved yet");
+    return true;
+}
+
+// One-time import of the old nfc_links.json
+bool Storage::migrateJsonLinks() {
     File file = SD.open(NFC_LINKS_FILE, FILE_READ);
     if (!file) {
         Serial.println("Failed to open NFC links file");
         return false;
     }
     
-    DynamicJsonDocument doc(2048);
+    // Sized from the file so large deployments (thousands of tags) still fit
+    DynamicJsonDocument doc(file.size() * 2 + 1024);
     DeserializationError error = deserializeJson(doc, file);
     file.close();
     
@@ -111,76 +266,303 @@ bool Storage::loadNFCLinks() {
     
     JsonArray links = doc["links"].as<JsonArray>();
     for (JsonObject link : links) {
-        NFCLink nfcLink;
-        nfcLink.uid = link["uid"].as<String>();
-        nfcLink.songPath = link["song"].as<String>();
-        _nfcLinks.push_back(nfcLink);
+        TagUid key;
+        const char* uid = link["uid"] | "";
+        const char* song = link["song"] | "";
+        if (!TagUid::fromHex(uid, key) || !_nfcLinks.set(key, song)) {
+            Serial.printf("Skipping invalid NFC link: %s\n", uid);
+        }
     }
     
-    Serial.printf("Loaded %d NFC links\n", _nfcLinks.size());
+    if (!saveNFCLinks()) {
+        return false;
+    }
+    
+    // Keep the old file around, but don't import it again
+    String migratedPath = String(NFC_LINKS_FILE) + ".migrated";
+    SD.remove(migratedPath);
+    SD.rename(NFC_LINKS_FILE, migratedPath);
+    
+    Serial.printf("Migrated %u NFC links from %s\n", (unsigned)_nfcLinks.size(), NFC_LINKS_FILE);
     return true;
 }
 
 bool Storage::saveNFCLinks() {
-    DynamicJsonDocument doc(2048);
-    JsonArray links = doc.createNestedArray("links");
+    Lock guard(*this);
+    SdLock lock;
+    return _linkJournal.compact(_nfcLinks);
+}
+
+bool Storage::linkNFC(const TagUid& key, const String& songPath) {
+    if (key.isEmpty() || songPath.length() >= AUDIO_MAX_PATH_LENGTH) {
+        return false;
+    }
     
-    for (const auto& link : _nfcLinks) {
-        JsonObject obj = links.createNestedObject();
-        obj["uid"] = link.uid;
-        obj["song"] = link.songPath;
+    // Replaces any existing link for this tag
+    clearPosition(key);
+    {
+        Lock guard(*this);
+        if (!_nfcLinks.set(key, songPath.c_str())) {
+            return false;
+        }
     }
     
-    File file = SD.open(NFC_LINKS_FILE, FILE_WRITE);
-    if (!file) {
-        Serial.println("Failed to open NFC links file for writing");
-        return false;
+    // Only this task writes the journal; a tap meanwhile doesn't wait on the card
+    {
+        SdLock lock;
+        if (!_linkJournal.appendLink(key, songPath.c_str())) {
+            return false;
+        }
+    }
+    
+    if (_linkJournal.needsCompaction()) {
+        saveNFCLinks();
+    }
+    return true;
+}
+
+bool Storage::unlinkNFC(const TagUid& key) {
+    clearPosition(key);
+    {
+        Lock guard(*this);
+        if (!_nfcLinks.remove(key)) {
+            return true;
+        }
+    }
+    
+    {
+        SdLock lock;
+        if (!_linkJournal.appendUnlink(key)) {
+            return false;
+        }
     }
     
-    if (serializeJson(doc, file) == 0) {
-        Serial.println("Failed to write NFC links");
-        file.close();
+    if (_linkJournal.needsCompaction()) {
+        saveNFCLinks();
+    }
+    return true;
+}
+
+bool Storage::getSongForNFC(const TagUid& uid, char* songPath, size_t songPathLen) {
+    // The path belongs to the table; copy it before a relink can free it
+    Lock guard(*this);
+    const char* path = _nfcLinks.find(uid);
+    if (!path) {
         return false;
     }
     
-    file.close();
-    Serial.println("NFC links saved successfully");
+    strlcpy(songPath, path, songPathLen);
     return true;
 }
 
-bool Storage::linkNFC(const String& uid, const String& songPath) {
-    // Remove existing link if present
-    unlinkNFC(uid);
+std::vector<NFCLink> Storage::getAllLinks() {
+    std::vector<NFCLink> links;
+    Lock guard(*this);
+    links.reserve(_nfcLinks.size());
     
-    NFCLink link;
-    link.uid = uid;
-    link.songPath = songPath;
-    _nfcLinks.push_back(link);
+    _nfcLinks.forEach([&links](const TagUid& key, const char* path) {
+        char uid[TagUid::HEX_SIZE];
+        key.toHex(uid);
+        
+        NFCLink link;
+        link.uid = uid;
+        link.songPath = path;
+        links.push_back(link);
+    });
     
-    return saveNFCLinks();
+    return links;
 }
 
-bool Storage::unlinkNFC(const String& uid) {
-    auto it = std::remove_if(_nfcLinks.begin(), _nfcLinks.end(),
-        [&uid](const NFCLink& link) { return link.uid == uid; });
+bool Storage::nextLink(size_t& cursor, char* uid, char* songPath, size_t songPathLen) {
+    TagUid key;
+    const char* path;
+    Lock guard(*this);
+    if (!_nfcLinks.next(cursor, key, path)) {
+        return false;
+    }
+    
+    key.toHex(uid);
+    strlcpy(songPath, path, songPathLen);
+    return true;
+}
+
+// ============================================================================
+// Playback positions
+// ============================================================================
+
+bool Storage::loadPositions() {
+    Lock guard(*this);
+    _positions.clear();
+    _positionDirty.clear();
     
-    if (it != _nfcLinks.end()) {
-        _nfcLinks.erase(it, _nfcLinks.end());
-        return saveNFCLinks();
+    SdLock lock;
+    File file = SD.open(POSITIONS_FILE, FILE_READ);
+    if (!file) {
+        return true;  // Nothing saved yet
+    }
+    
+    PositionRecord record;
+    while (file.read((uint8_t*)&record, sizeof(record)) == sizeof(record)) {
+        record.uid[sizeof(record.uid) - 1] = '\0';
+        _positions.push_back(record);
+        _positionDirty.push_back(false);
     }
+    file.close();
     
+    Serial.printf("Loaded %u playback positions\n", (unsigned)_positions.size());
     return true;
 }
 
-String Storage::getSongForNFC(const String& uid) {
-    for (const auto& link : _nfcLinks) {
-        if (link.uid == uid) {
-            return link.songPath;
+int Storage::findPosition(const TagUid& uid) {
+    // Records keep the hex form so the file format doesn't change
+    char hex[TagUid::HEX_SIZE];
+    uid.toHex(hex);
+    for (size_t i = 0; i < _positions.size(); i++) {
+        if (strcmp(hex, _positions[i].uid) == 0) {
+            return i;
         }
     }
-    return "";
+    return -1;
 }
 
-std::vector<NFCLink> Storage::getAllLinks() {
-    return _nfcLinks;
+void Storage::setPosition(const TagUid& uid, const char* link, uint8_t track, uint32_t positionMs) {
+    if (uid.isEmpty()) {
+        return;
+    }
+    
+    uint32_t linkHash = hashPath(link);
+    Lock guard(*this);
+    int index = findPosition(uid);
+    
+    if (index < 0) {
+        // New tag: reuse a cleared slot before growing the file
+        TagUid freeSlot;
+        freeSlot.clear();
+        index = findPosition(freeSlot);
+        if (index < 0) {
+            PositionRecord record = {};
+            _positions.push_back(record);
+            _positionDirty.push_back(false);
+            index = _positions.size() - 1;
+        }
+        uid.toHex(_positions[index].uid);
+    } else if (_positions[index].linkHash == linkHash &&
+               _positions[index].track == track &&
+               _positions[index].positionMs == positionMs) {
+        return;  // Unchanged (e.g. paused)
+    }
+    
+    _positions[index].linkHash = linkHash;
+    _positions[index].track = track;
+    _positions[index].positionMs = positionMs;
+    _positionDirty[index] = true;
+    _positionsDirty = true;
+}
+
+bool Storage::getPosition(const TagUid& uid, const char* link, uint8_t& track, uint32_t& positionMs) {
+    Lock guard(*this);
+    int index = findPosition(uid);
+    if (index < 0 || _positions[index].linkHash != hashPath(link)) {
+        return false;
+    }
+    
+    track = _positions[index].track;
+    positionMs = _positions[index].positionMs;
+    return true;
+}
+
+void Storage::clearPosition(const TagUid& uid) {
+    Lock guard(*this);
+    int index = findPosition(uid);
+    if (index < 0) {
+        return;
+    }
+    
+    // Keep the slot so the records behind it do not move
+    memset(&_positions[index], 0, sizeof(PositionRecord));
+    _positionDirty[index] = true;
+    _positionsDirty = true;
+}
+
+bool Storage::flushPositions(bool force) {
+    if (!_mounted) {
+        return true;
+    }
+    
+    {
+        Lock guard(*this);
+        if (!_positionsDirty) {
+            return true;
+        }
+        
+        unsigned long now = millis();
+        if (!force && now - _lastPositionFlush < POSITION_FLUSH_INTERVAL) {
+            return true;
+        }
+        _lastPositionFlush = now;
+        _positionsDirty = false;
+    }
+    
+    // Copy a few changed records under the lock, then write them with it
+    // released: the card may take seconds, and taps look up links meanwhile
+    struct Pending {
+        size_t index;
+        PositionRecord record;
+    };
+    Pending batch[8];
+    const size_t batchSize = sizeof(batch) / sizeof(batch[0]);
+    size_t cursor = 0;
+    size_t written = 0;
+    
+    for (;;) {
+        size_t count = 0;
+        {
+            Lock guard(*this);
+            for (; cursor < _positions.size() && count < batchSize; cursor++) {
+                if (_positionDirty[cursor]) {
+                    batch[count].index = cursor;
+                    batch[count].record = _positions[cursor];
+                    _positionDirty[cursor] = false;
+                    count++;
+                }
+            }
+        }
+        if (count == 0) {
+            break;
+        }
+        
+        // Rewrite only the changed records in place
+        bool opened;
+        {
+            SdLock lock;
+            File file = SD.open(POSITIONS_FILE, "r+");
+            if (!file) {
+                file = SD.open(POSITIONS_FILE, FILE_WRITE);
+            }
+            opened = (bool)file;
+            for (size_t i = 0; opened && i < count; i++) {
+                file.seek(batch[i].index * sizeof(PositionRecord));
+                file.write((const uint8_t*)&batch[i].record, sizeof(PositionRecord));
+            }
+            if (opened) {
+                file.close();
+            }
+        }
+        
+        if (!opened) {
+            Serial.println("Failed to open positions file for writing");
+            // Try these again on the next flush (the SD lock is released:
+            // the storage lock is never taken while holding it)
+            Lock guard(*this);
+            for (size_t i = 0; i < count; i++) {
+                _positionDirty[batch[i].index] = true;
+            }
+            _positionsDirty = true;
+            return false;
+        }
+        written += count;
+    }
+    
+    Serial.printf("Saved %u playback positions\n", (unsigned)written);
+    return true;
 }
@@ -0,0 +1,65 @@
+#include "tag_uid.h"
+#include <string.h>
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+TagUid TagUid::fromBytes(const uint8_t* bytes, uint8_t length) {
+    TagUid uid;
+    uid.clear();
+    if (length <= NFC_UID_MAX_LENGTH) {
+        uid.length = length;
+        memcpy(uid.bytes, bytes, length);
+    }
+    return uid;
+}
+
+bool TagUid::fromHex(const char* hex, TagUid& uid) {
+    size_t len = strlen(hex);
+    if (len == 0 || (len % 2) != 0 || len / 2 > NFC_UID_MAX_LENGTH) {
+        return false;
+    }
+    
+    uid.clear();
+    uid.length = len / 2;
+    for (uint8_t i = 0; i < uid.length; i++) {
+        int hi = hexValue(hex[i * 2]);
+        int lo = hexValue(hex[i * 2 + 1]);
+        if (hi < 0 || lo < 0) {
+            return false;
+        }
+        uid.bytes[i] = (hi << 4) | lo;
+    }
+    return true;
+}
+
+void TagUid::toHex(char* out) const {
+    static const char digits[] = "0123456789ABCDEF";
+    for (uint8_t i = 0; i < length; i++) {
+        out[i * 2] = digits[bytes[i] >> 4];
+        out[i * 2 + 1] = digits[bytes[i] & 0x0F];
+    }
+    out[length * 2] = '\0';
+}
+
+void TagUid::clear() {
+    memset(this, 0, sizeof(*this));
+}
+
+uint32_t TagUid::hash() const {
+    // FNV-1a; UIDs are close to random already, this just mixes the bytes
+    uint32_t h = 2166136261u;
+    h = (h ^ length) * 16777619u;
+    for (uint8_t i = 0; i < length; i++) {
+        h = (h ^ bytes[i]) * 16777619u;
+    }
+    return h;
+}
+
+bool TagUid::operator==(const TagUid& other) const {
+    return length == other.length && memcmp(bytes, other.bytes, length) == 0;
+}
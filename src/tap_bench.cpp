@@ -0,0 +1,150 @@
+#include "tap_bench.h"
+#include "audio_player.h"
+#include "nfc_reader.h"
+
+#include <algorithm>
+
+#ifndef ARDUINO_ARCH_ESP32
+#include "sim.h"
+#endif
+
+TapBench tapBench;
+
+// p95 budget per stage in microseconds, on the board with a class 10 card.
+// Lower a budget when a stage gets faster so a regression shows up.
+static const uint32_t STAGE_BUDGET_US[TAP_STAGE_COUNT] = {
+    5000,   // pn532: UID read over HSPI
+    15000,  // handoff: up to one main loop pass
+    5000,   // uid hex (includes the "detected" log line)
+    5000,   // link lookup
+    10000,  // playlist
+    5000,   // resume lookup
+    10000,  // command: queue + audio task wake-up
+    30000,  // file open: FAT directory walk
+    20000,  // buffer prime: one AUDIO_PREFETCH_CHUNK read
+    50000,  // id3 skip: embedded cover art is read through
+    20000,  // first frame
+    5000,   // first i2s write
+};
+static const uint32_t TOTAL_BUDGET_US = 150000;
+
+TapBench::TapBench()
+    : _phase(IDLE), _taps(0), _done(0), _samples(nullptr), _phaseStart(0) {}
+
+bool TapBench::begin(uint16_t taps) {
+    // Column per stage plus the total, so each can be sorted in place
+    _samples = (uint32_t*)malloc((size_t)taps * (TAP_STAGE_COUNT + 1) * sizeof(uint32_t));
+    if (!_samples) {
+        Serial.println("✗ Tap benchmark: not enough memory");
+        return false;
+    }
+    
+    _taps = taps;
+    _done = 0;
+    _phase = WARM_UP;
+    _phaseStart = millis();
+    Serial.printf("⏱ Tap benchmark: %u taps. Place a linked tag on the reader and leave it there.\n", taps);
+    return true;
+}
+
+void TapBench::loop() {
+    TapTrace trace;
+    unsigned long now = millis();
+    
+    switch (_phase) {
+        case IDLE:
+            break;
+        
+        case WARM_UP:
+            // The first play fills the catalog and FAT caches; not counted
+            if (tapLatency.takeTrace(trace)) {
+                settle();
+            }
+            break;
+        
+        case SETTLING:
+            // Tag re-reads from before the stop are not taps
+            tapLatency.takeTrace(trace);
+            if (audioPlayer.getState() == STOPPED && now - _phaseStart >= TAP_BENCH_SETTLE_MS) {
+                nfcReader.retrigger();
+                _phase = TAPPING;
+                _phaseStart = now;
+            }
+            break;
+        
+        case TAPPING:
+            if (tapLatency.takeTrace(trace)) {
+                for (uint8_t i = 0; i < TAP_STAGE_COUNT; i++) {
+                    _samples[i * _taps + _done] = trace.stageMicros[i];
+                }
+                _samples[TAP_STAGE_COUNT * _taps + _done] = trace.totalMicros;
+                _done++;
+                
+                if (_done == _taps) {
+                    finish(true);
+                } else {
+                    settle();
+                }
+            } else if (now - _phaseStart >= TAP_BENCH_TIMEOUT_MS) {
+                Serial.printf("✗ Tap %u: no sound after %d ms (tag removed or not linked?)\n",
+                              _done + 1, TAP_BENCH_TIMEOUT_MS);
+                finish(false);
+            }
+            break;
+    }
+}
+
+void TapBench::settle() {
+    audioPlayer.stop();
+    _phase = SETTLING;
+    _phaseStart = millis();
+}
+
+void TapBench::finish(bool completed) {
+    audioPlayer.stop();
+    _phase = IDLE;
+    
+    uint8_t failed = completed ? 0 : 1;
+    if (_done > 0) {
+        Serial.printf("\n⏱ Tap to first sample over %u taps (ms)\n", _done);
+        Serial.printf("  %-16s %8s %8s %8s %8s\n", "stage", "p50", "p95", "p99", "budget");
+        
+        for (uint8_t i = 0; i <= TAP_STAGE_COUNT; i++) {
+            uint32_t* column = _samples + i * _taps;
+            std::sort(column, column + _done);
+            uint32_t p95 = percentile(column, _done, 95);
+            
+            bool isTotal = (i == TAP_STAGE_COUNT);
+            uint32_t budget = isTotal ? TOTAL_BUDGET_US : STAGE_BUDGET_US[i];
+            bool over = p95 > budget;
+            if (over) {
+                failed++;
+            }
+            Serial.printf("  %-16s %8.2f %8.2f %8.2f %8.2f  %s\n",
+                          isTotal ? "total" : TapLatency::stageName((TapStage)i),
+                          percentile(column, _done, 50) / 1000.0f, p95 / 1000.0f,
+                          percentile(column, _done, 99) / 1000.0f, budget / 1000.0f,
+                          over ? "✗" : "✓");
+        }
+    }
+    
+    if (failed == 0) {
+        Serial.println("✓ Tap benchmark passed");
+    } else {
+        Serial.printf("✗ Tap benchmark failed (%u over budget or incomplete)\n", failed);
+    }
+    
+    free(_samples);
+    _samples = nullptr;
+
+#ifndef ARDUINO_ARCH_ESP32
+    // Native build: the exit code is the verdict
+    simExit(failed == 0 ? 0 : 1);
+#endif
+}
+
+// Nearest-rank percentile of sorted values
+uint32_t TapBench::percentile(uint32_t* values, uint16_t count, uint8_t pct) {
+    uint32_t rank = ((uint32_t)count * pct + 99) / 100;
+    return values[rank > 0 ? rank - 1 : 0];
+}
@@ -0,0 +1,72 @@
+#include "tap_latency.h"
+
+TapLatency tapLatency;
+
+static const char* const STAGE_NAMES[TAP_STAGE_COUNT] = {
+    "pn532",
+    "handoff",
+    "uid hex",
+    "link lookup",
+    "playlist",
+    "resume lookup",
+    "command",
+    "file open",
+    "buffer prime",
+    "id3 skip",
+    "first frame",
+    "first i2s write",
+};
+
+TapLatency::TapLatency()
+    : _active(false), _reached(0), _origin(0), _traceReady(false) {
+    memset(_marks, 0, sizeof(_marks));
+    memset(&_trace, 0, sizeof(_trace));
+}
+
+void TapLatency::start(uint32_t originMicros) {
+    // A new tap replaces one still in flight
+    _active = false;
+    _reached = 0;
+    _origin = originMicros;
+    _active = true;
+}
+
+void TapLatency::record(TapStage stage) {
+    _marks[stage] = micros();
+    _reached |= (1UL << stage);
+    
+    if (stage != TAP_FIRST_I2S_WRITE) {
+        return;
+    }
+    _active = false;
+    
+    if (_traceReady) {
+        return;  // The main loop hasn't collected the last one yet
+    }
+    
+    // A stage that was skipped counts towards the next one reached
+    uint32_t previous = _origin;
+    for (uint8_t i = 0; i < TAP_STAGE_COUNT; i++) {
+        if (_reached & (1UL << i)) {
+            _trace.stageMicros[i] = _marks[i] - previous;
+            previous = _marks[i];
+        } else {
+            _trace.stageMicros[i] = 0;
+        }
+    }
+    _trace.totalMicros = _marks[TAP_FIRST_I2S_WRITE] - _origin;
+    _traceReady = true;
+}
+
+bool TapLatency::takeTrace(TapTrace& trace) {
+    if (!_traceReady) {
+        return false;
+    }
+    trace = _trace;
+    _traceReady = false;
+    return true;
+}
+
+const char* TapLatency::stageName(TapStage stage) {
+    return stage < TAP_STAGE_COUNT ? STAGE_NAMES[stage] : "?";
+}
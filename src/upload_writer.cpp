@@ -0,0 +1,285 @@
+#include "upload_writer.h"
+#include "audio_player.h"
+#include "storage.h"
+#include "sd_bus.h"
+#include "metrics.h"
+#include "logger.h"
+#include <esp_heap_caps.h>
+#include <algorithm>
+
+QueueHandle_t UploadWriter::_fullBlocks = nullptr;
+portMUX_TYPE UploadWriter::_lastLock = portMUX_INITIALIZER_UNLOCKED;
+UploadStats UploadWriter::_lastStats = UploadStats();
+
+UploadWriter::UploadWriter()
+    : _blockCount(0), _filling(-1), _freeBlocks(nullptr), _keep(true),
+      _active(false), _stalled(false), _failed(false), _busy(false),
+      _startMs(0), _startUnderruns(0), _stats() {
+    memset(_blocks, 0, sizeof(_blocks));
+    _path[0] = '\0';
+    _installAs[0] = '\0';
+}
+
+bool UploadWriter::begin() {
+    if (_fullBlocks) {
+        return true;
+    }
+
+    // Room for every block of every upload plus their CLOSE_FILE messages
+    _fullBlocks = xQueueCreate(UPLOAD_MAX_CONCURRENT * (UPLOAD_BLOCK_COUNT + 1), sizeof(Message));
+    if (!_fullBlocks) {
+        Serial.println("✗ Upload writer: out of memory");
+        return false;
+    }
+
+    // Below the AsyncTCP task, so receiving always wins over writing; the
+    // blocks absorb the difference
+    TaskHandle_t task;
+    if (xTaskCreatePinnedToCore(writerTask, "UploadWriter", 4096, nullptr, 1, &task, 0) != pdPASS) {
+        Serial.println("✗ Upload writer: failed to start task");
+        return false;
+    }
+    metrics.trackTask(task);
+    return true;
+}
+
+// ============================================================================
+// Producer side
+// ============================================================================
+
+bool UploadWriter::open(const char* path, uint32_t offset, bool keep) {
+    if (isBusy()) {
+        // The writer task still has the last file
+        return false;
+    }
+
+    if (!_freeBlocks) {
+        _freeBlocks = xQueueCreate(UPLOAD_BLOCK_COUNT, sizeof(uint8_t));
+    }
+
+    _stats = UploadStats();
+    _failed = false;
+    _stalled = false;
+    _keep = keep;
+    strlcpy(_path, path, sizeof(_path));
+
+    if (!_freeBlocks || !allocateBlocks()) {
+        LOG_ERROR("✗ Upload: no memory for write blocks");
+        return false;
+    }
+
+    {
+        SdLock lock;
+        if (offset == 0) {
+            _file = SD.open(_path, FILE_WRITE);
+        } else {
+            // Resume: keep what is there and overwrite from offset on
+            _file = SD.open(_path, "r+");
+            if (_file && (_file.size() < offset || !_file.seek(offset))) {
+                _file.close();
+            }
+        }
+    }
+    if (!_file) {
+        LOG_ERROR("Failed to open %s for writing", _path);
+        releaseBlocks();
+        return false;
+    }
+
+    _active = true;
+    _busy.store(true, std::memory_order_relaxed);
+    _startMs = millis();
+    _startUnderruns = audioPlayer.getUnderruns();
+    return true;
+}
+
+bool UploadWriter::write(const uint8_t* data, size_t len) {
+    if (!_active || _failed || _stalled) {
+        return false;
+    }
+
+    while (len > 0) {
+        if (_filling < 0 && !takeBlock()) {
+            return false;
+        }
+
+        Block& block = _blocks[_filling];
+        size_t n = std::min(len, (size_t)UPLOAD_BLOCK_SIZE - block.length);
+        memcpy(block.data + block.length, data, n);
+        block.length += n;
+        data += n;
+        len -= n;
+        _stats.bytes += n;
+
+        if (block.length == UPLOAD_BLOCK_SIZE) {
+            submitBlock();
+        }
+    }
+    return !_failed;
+}
+
+void UploadWriter::finish(const char* installAs) {
+    if (!_active) {
+        return;
+    }
+
+    // The tail is the only write shorter than a block
+    if (_filling >= 0 && !_failed) {
+        submitBlock();
+    }
+
+    strlcpy(_installAs, installAs ? installAs : "", sizeof(_installAs));
+    close();
+}
+
+void UploadWriter::abort() {
+    if (!_active) {
+        return;
+    }
+    // The writer drops whatever is still queued
+    _failed = true;
+    _installAs[0] = '\0';
+    close();
+}
+
+bool UploadWriter::takeBlock() {
+    uint8_t index;
+    if (xQueueReceive(_freeBlocks, &index, 0) != pdTRUE) {
+        // Every block is waiting for the card. Everything before this
+        // segment is queued in order, so the file stays whole up to there.
+        _stats.stalls++;
+        _stalled = true;
+        LOG_WARN("⚠ Upload: SD writer behind, refusing data at %u bytes", (unsigned)_stats.bytes);
+        return false;
+    }
+
+    _filling = index;
+    _blocks[index].length = 0;
+    return true;
+}
+
+void UploadWriter::submitBlock() {
+    Message message = { this, (uint8_t)_filling };
+    _filling = -1;
+    // Never full: there is room for every block plus CLOSE_FILE of every
+    // upload, and an upload can't reopen before its CLOSE_FILE is handled
+    xQueueSend(_fullBlocks, &message, 0);
+}
+
+void UploadWriter::close() {
+    // Sent after the last block, so once the writer gets to it every block
+    // has been written (or dropped). From here on the writer task owns the
+    // file, the blocks and _stats until it clears _busy.
+    _filling = -1;
+    _active = false;
+    Message message = { this, CLOSE_FILE };
+    xQueueSend(_fullBlocks, &message, 0);
+}
+
+UploadStats UploadWriter::getLastStats() {
+    portENTER_CRITICAL(&_lastLock);
+    UploadStats stats = _lastStats;
+    portEXIT_CRITICAL(&_lastLock);
+    return stats;
+}
+
+bool UploadWriter::allocateBlocks() {
+    // 4-byte aligned and DMA-capable, so the SD driver writes straight
+    // from the block. Fewer blocks only means less slack against slow cards,
+    // so stop early rather than leave the rest of the system short.
+    _blockCount = 0;
+    for (uint8_t i = 0; i < UPLOAD_BLOCK_COUNT; i++) {
+        if (heap_caps_get_free_size(MALLOC_CAP_INTERNAL) < UPLOAD_BLOCK_SIZE + UPLOAD_HEAP_RESERVE) {
+            break;
+        }
+        uint8_t* data = (uint8_t*)heap_caps_malloc(UPLOAD_BLOCK_SIZE, MALLOC_CAP_DMA);
+        if (!data) {
+            break;
+        }
+        _blocks[i].data = data;
+        _blocks[i].length = 0;
+        xQueueSend(_freeBlocks, &i, 0);
+        _blockCount++;
+    }
+
+    if (_blockCount == 0) {
+        return false;
+    }
+    if (_blockCount < UPLOAD_BLOCK_COUNT) {
+        LOG_WARN("⚠ Upload: only %u write blocks", _blockCount);
+    }
+    return true;
+}
+
+void UploadWriter::releaseBlocks() {
+    xQueueReset(_freeBlocks);
+    for (uint8_t i = 0; i < _blockCount; i++) {
+        heap_caps_free(_blocks[i].data);
+        _blocks[i].data = nullptr;
+    }
+    _blockCount = 0;
+}
+
+// ============================================================================
+// Writer task (Core 0, low priority)
+// ============================================================================
+
+void UploadWriter::writerTask(void*) {
+    for (;;) {
+        Message message;
+        if (xQueueReceive(_fullBlocks, &message, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        if (message.index == CLOSE_FILE) {
+            message.writer->closeFile();
+        } else {
+            message.writer->writeBlock(message.index);
+        }
+    }
+}
+
+void UploadWriter::writeBlock(uint8_t index) {
+    // One block per turn on the bus, taken only while playback has enough
+    // buffered to cover it
+    Block& block = _blocks[index];
+    if (!_failed) {
+        SdLock lock;
+        if (_file.write(block.data, block.length) != block.length) {
+            LOG_ERROR("✗ Upload: SD write failed (card full?)");
+            _failed = true;
+        }
+    }
+    xQueueSend(_freeBlocks, &index, portMAX_DELAY);
+}
+
+void UploadWriter::closeFile() {
+    {
+        SdLock lock;
+        _file.close();
+        if (_failed && !_keep) {
+            SD.remove(_path);
+        }
+    }
+    if (!_failed && _installAs[0] && !storage.installMusicFile(_path, _installAs)) {
+        _failed = true;
+    }
+    releaseBlocks();
+
+    _stats.elapsedMs = millis() - _startMs;
+    _stats.underruns = audioPlayer.getUnderruns() - _startUnderruns;
+    _stats.ok = !_failed;
+    if (_stats.ok) {
+        LOG_INFO("✓ Upload: %s, %u KB in %u ms (%u KB/s), %u stalls, %u playback underruns",
+                      _path, (unsigned)(_stats.bytes / 1024), (unsigned)_stats.elapsedMs,
+                      (unsigned)(_stats.bytes / std::max(_stats.elapsedMs, (uint32_t)1)),
+                      (unsigned)_stats.stalls, (unsigned)_stats.underruns);
+    } else {
+        LOG_ERROR("✗ Upload failed: %s", _path);
+    }
+
+    portENTER_CRITICAL(&_lastLock);
+    _lastStats = _stats;
+    portEXIT_CRITICAL(&_lastLock);
+    _busy.store(false, std::memory_order_release);
+}
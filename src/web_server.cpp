@@ -3,17 +3,36 @@
 #include "audio_player.h"
 #include "nfc_reader.h"
 #include "config.h"
+#include "json_list_stream.h"
+#include "file_range_stream.h"
+#include "sd_bus.h"
+#include "logger.h"
+#include "metrics.h"
+#include "web_ui.h"
 #include <ArduinoJson.h>
+#include <algorithm>
+#include <memory>
 
 WebServerManager webServer;
 
-// File upload handling
-File uploadFile;
-
-WebServerManager::WebServerManager() : _server(nullptr) {}
+WebServerManager::WebServerManager()
+    : _server(nullptr), _events(nullptr), _lastStatusVersion(0) {
+    for (UploadSlot& slot : _uploads) {
+        slot.request = nullptr;
+    }
+}
 
 bool WebServerManager::begin() {
     _server = new AsyncWebServer(WEB_SERVER_PORT);
+    UploadWriter::begin();
+    
+    // Server-sent events: clients get the current status on connect and
+    // then only what changes
+    _events = new AsyncEventSource("/api/events");
+    _events->onConnect([this](AsyncEventSourceClient* client) {
+        client->send(buildStatusJson().c_str(), "status", millis(), EVENTS_RETRY_MS);
+    });
+    _server->addHandler(_events);
     
     setupRoutes();
     
@@ -25,545 +44,653 @@ bool WebServerManager::begin() {
 
 void WebServerManager::loop() {
     // AsyncWebServer handles requests automatically
+    publishEvents();
+}
+
+// Core 0: turn player/NFC changes into events. Both sides only bump a
+// counter or flag, so nothing here runs on the audio core.
+void WebServerManager::publishEvents() {
+    if (!_events) {
+        return;
+    }
+    
+    uint32_t version = audioPlayer.getStatusVersion();
+    if (version != _lastStatusVersion) {
+        _lastStatusVersion = version;
+        if (_events->count() > 0) {
+            _events->send(buildStatusJson().c_str(), "status", millis());
+        }
+    }
+    
+    if (nfcReader.hasNewTag()) {
+        nfcReader.clearNewTag();
+        if (_events->count() > 0) {
+            char uid[TagUid::HEX_SIZE];
+            char data[sizeof("{\"uid\":\"\"}") + TagUid::HEX_SIZE];
+            nfcReader.getLastUID().toHex(uid);
+            snprintf(data, sizeof(data), "{\"uid\":\"%s\"}", uid);
+            _events->send(data, "tag", millis());
+        }
+    }
 }
 
 void WebServerManager::setupRoutes() {
     // Serve static HTML page
     _server->on("/", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        HttpTimer timer(ROUTE_ROOT);
         handleRoot(request);
     });
     
     // API Routes - Songs
+    // Song preview: /api/songs/<name>/stream, with Range support. Must come
+    // before /api/songs: a plain route also matches everything below it.
+    _server->on("/api/songs/*", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        HttpTimer timer(ROUTE_SONG_STREAM);
+        handleStreamSong(request);
+    });
+    
     _server->on("/api/songs", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        HttpTimer timer(ROUTE_SONGS_LIST);
         handleListSongs(request);
     });
     
     _server->on("/api/songs/upload", HTTP_POST, 
-        [](AsyncWebServerRequest* request) {
-            request->send(200, "application/json", "{\"success\":true}");
+        [this](AsyncWebServerRequest* request) {
+            HttpTimer timer(ROUTE_SONGS_UPLOAD);
+            handleUploadDone(request);
         },
         [this](AsyncWebServerRequest* request, String filename, size_t index, 
                uint8_t* data, size_t len, bool final) {
+            HttpTimer timer(ROUTE_SONGS_UPLOAD, false);
             handleUploadSong(request, filename, index, data, len, final);
         }
     );
     
+    // Resumable upload: the whole file, or one Content-Range piece of it
+    _server->on("/api/songs/*", HTTP_PUT,
+        [this](AsyncWebServerRequest* request) {
+            HttpTimer timer(ROUTE_SONG_PUT);
+            handlePutSong(request);
+        },
+        NULL,
+        [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+            HttpTimer timer(ROUTE_SONG_PUT, false);
+            handlePutSongBody(request, data, len, index, total);
+        }
+    );
+    
     _server->on("/api/songs/*", HTTP_DELETE, [this](AsyncWebServerRequest* request) {
+        HttpTimer timer(ROUTE_SONG_DELETE);
         handleDeleteSong(request);
     });
     
     // API Routes - NFC Tags
     // IMPORTANT: Register specific routes BEFORE wildcard routes!
     _server->on("/api/tags/scan", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        HttpTimer timer(ROUTE_TAGS_SCAN);
         handleScanTag(request);
     });
     
     // Clear last scanned UID (for fresh modal opening)
     _server->on("/api/tags/scan/clear", HTTP_POST, [this](AsyncWebServerRequest* request) {
+        HttpTimer timer(ROUTE_TAGS_SCAN_CLEAR);
         nfcReader.clearLastUID();
-        Serial.println("[WEB] Cleared last scanned UID");
+        LOG_INFO("[WEB] Cleared last scanned UID");
         request->send(200, "application/json", "{\"success\":true}");
     });
     
     _server->on("/api/tags/link", HTTP_POST, 
         [this](AsyncWebServerRequest* request) {
             // Handler called after body is received
+            HttpTimer timer(ROUTE_TAGS_LINK);
         },
         NULL,
         [this](AsyncWebServerRequest* request, uint8_t *data, size_t len, size_t index, size_t total) {
             // Body handler
+            HttpTimer timer(ROUTE_TAGS_LINK, false);
             handleLinkTagBody(request, data, len, index, total);
         }
     );
     
     _server->on("/api/tags", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        HttpTimer timer(ROUTE_TAGS_LIST);
         handleListTags(request);
     });
     
     _server->on("/api/tags/*", HTTP_DELETE, [this](AsyncWebServerRequest* request) {
+        HttpTimer timer(ROUTE_TAG_DELETE);
         handleUnlinkTag(request);
     });
     
     // API Routes - Status
     _server->on("/api/status", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        HttpTimer timer(ROUTE_STATUS);
         handleStatus(request);
     });
     
+    // Counters for monitoring: Prometheus text, or JSON with ?format=json
+    _server->on("/api/metrics", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        HttpTimer timer(ROUTE_METRICS);
+        handleMetrics(request);
+    });
+    
+    // API Routes - Playback
+    _server->on("/api/seek", HTTP_POST, [this](AsyncWebServerRequest* request) {
+        HttpTimer timer(ROUTE_SEEK);
+        handleSeek(request);
+    });
+    
     // 404 handler
     _server->onNotFound([this](AsyncWebServerRequest* request) {
+        HttpTimer timer(ROUTE_NOT_FOUND);
         handleNotFound(request);
     });
 }
 
 void WebServerManager::handleRoot(AsyncWebServerRequest* request) {
-    String html = R"rawliteral(
-<!DOCTYPE html>
-<html lang="es">
-<head>
-    <meta charset="UTF-8">
-    <meta name="viewport" content="width=device-width, initial-scale=1.0">
-    <title>MusicBox - Configuración</title>
-    <style>
-        * { margin: 0; padding: 0; box-sizing: border-box; }
-        body { 
-            font-family: 'Segoe UI', Tahoma, Geneva, Verdana, sans-serif;
-            background: linear-gradient(135deg, #667eea 0%, #764ba2 100%);
-            color: #333;
-            min-height: 100vh;
-            padding: 20px;
-        }
-        .container {
-            max-width: 1200px;
-            margin: 0 auto;
-            background: white;
-            border-radius: 15px;
-            box-shadow: 0 10px 40px rgba(0,0,0,0.2);
-            overflow: hidden;
-        }
-        .header {
-            background: linear-gradient(135deg, #667eea 0%, #764ba2 100%);
-            color: white;
-            padding: 30px;
-            text-align: center;
-        }
-        .header h1 { font-size: 2.5em; margin-bottom: 10px; }
-        .header p { opacity: 0.9; }
-        .content { padding: 30px; }
-        .section {
-            margin-bottom: 40px;
-            padding: 20px;
-            background: #f8f9fa;
-            border-radius: 10px;
-        }
-        .section h2 {
-            color: #667eea;
-            margin-bottom: 20px;
-            padding-bottom: 10px;
-            border-bottom: 2px solid #667eea;
-        }
-        .btn {
-            background: #667eea;
-            color: white;
-            border: none;
-            padding: 12px 24px;
-            border-radius: 6px;
-            cursor: pointer;
-            font-size: 16px;
-            transition: all 0.3s;
-        }
-        .btn:hover { background: #5568d3; transform: translateY(-2px); }
-        .btn-danger { background: #e74c3c; }
-        .btn-danger:hover { background: #c0392b; }
-        .file-input {
-            border: 2px dashed #667eea;
-            padding: 20px;
-            border-radius: 8px;
-            text-align: center;
-            cursor: pointer;
-            transition: all 0.3s;
-        }
-        .file-input:hover { background: #f0f0f0; }
-        .list-item {
-            background: white;
-            padding: 15px;
-            margin: 10px 0;
-            border-radius: 8px;
-            display: flex;
-            justify-content: space-between;
-            align-items: center;
-            box-shadow: 0 2px 5px rgba(0,0,0,0.1);
-        }
-        .list-item:hover { box-shadow: 0 4px 10px rgba(0,0,0,0.15); }
-        .status {
-            position: fixed;
-            top: 20px;
-            right: 20px;
-            background: white;
-            padding: 15px 20px;
-            border-radius: 8px;
-            box-shadow: 0 4px 10px rgba(0,0,0,0.2);
-            max-width: 300px;
-        }
-        .status-playing { color: #27ae60; font-weight: bold; }
-        .status-paused { color: #f39c12; font-weight: bold; }
-        .modal {
-            display: none;
-            position: fixed;
-            z-index: 1000;
-            left: 0;
-            top: 0;
-            width: 100%;
-            height: 100%;
-            background: rgba(0,0,0,0.5);
-        }
-        .modal-content {
-            background: white;
-            margin: 10% auto;
-            padding: 30px;
-            border-radius: 10px;
-            max-width: 500px;
-            box-shadow: 0 10px 40px rgba(0,0,0,0.3);
-        }
-        .close {
-            float: right;
-            font-size: 28px;
-            font-weight: bold;
-            cursor: pointer;
-        }
-        .close:hover { color: #e74c3c; }
-        input[type="text"], select {
-            width: 100%;
-            padding: 12px;
-            margin: 10px 0;
-            border: 2px solid #ddd;
-            border-radius: 6px;
-            font-size: 16px;
-        }
-        input[type="text"]:focus, select:focus {
-            outline: none;
-            border-color: #667eea;
-        }
-        .progress {
-            width: 100%;
-            height: 30px;
-            background: #f0f0f0;
-            border-radius: 15px;
-            overflow: hidden;
-            margin: 10px 0;
-        }
-        .progress-bar {
-            height: 100%;
-            background: linear-gradient(90deg, #667eea, #764ba2);
-            transition: width 0.3s;
-            display: flex;
-            align-items: center;
-            justify-content: center;
-            color: white;
-            font-weight: bold;
+    // The page only changes with the firmware: revalidate by ETag
+    if (request->hasHeader("If-None-Match") &&
+        request->getHeader("If-None-Match")->value() == WEB_UI_ETAG) {
+        AsyncWebServerResponse* response = request->beginResponse(304);
+        response->addHeader("ETag", WEB_UI_ETAG);
+        request->send(response);
+        return;
+    }
+    
+    // Served straight from flash, already gzip'd at build time
+    AsyncWebServerResponse* response = request->beginResponse_P(200, "text/html", WEB_UI_GZ, WEB_UI_GZ_LENGTH);
+    response->addHeader("Content-Encoding", "gzip");
+    response->addHeader("ETag", WEB_UI_ETAG);
+    response->addHeader("Cache-Control", "no-cache");
+    request->send(response);
+}
+
+// Optional ?prefix=&offset=&limit= for the streamed lists
+static void readListParams(AsyncWebServerRequest* request, String& prefix, size_t& offset, size_t& limit) {
+    prefix = request->hasParam("prefix") ? request->getParam("prefix")->value() : String("");
+    offset = request->hasParam("offset") ? request->getParam("offset")->value().toInt() : 0;
+    limit = request->hasParam("limit") ? request->getParam("limit")->value().toInt() : 0;
+}
+
+// Rows are written straight into the TCP buffers as they free up
+static void sendListStream(AsyncWebServerRequest* request, std::shared_ptr<JsonListStream> stream) {
+    AsyncWebServerResponse* response = request->beginChunkedResponse("application/json",
+        [stream](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+            return stream->fill(buffer, maxLen);
+        });
+    request->send(response);
+}
+
+void WebServerManager::handleListSongs(AsyncWebServerRequest* request) {
+    String prefix;
+    size_t offset, limit;
+    readListParams(request, prefix, offset, limit);
+    
+    sendListStream(request, std::make_shared<SongListStream>(prefix, offset, limit));
+}
+
+void WebServerManager::handleDeleteSong(AsyncWebServerRequest* request) {
+    String path = request->url();
+    String filename = path.substring(path.lastIndexOf('/') + 1);
+    
+    bool success = storage.deleteMusicFile(filename);
+    
+    DynamicJsonDocument doc(128);
+    doc["success"] = success;
+    
+    String response;
+    serializeJson(doc, response);
+    request->send(success ? 200 : 404, "application/json", response);
+}
+
+// Bare file name for /music: no directories, room for the .part suffix
+static bool isValidSongName(const String& name) {
+    return name.length() > 0 && name.length() < MAX_FILENAME_LENGTH &&
+           name.indexOf('/') < 0 && name.indexOf('\\') < 0 && name != "." && name != "..";
+}
+
+static String partPath(const char* name) {
+    return storage.getMusicPath(name) + UPLOAD_PART_SUFFIX;
+}
+
+// Size of a file on the card, 0 if it doesn't exist
+static uint32_t fileSize(const String& path) {
+    SdLock lock;
+    File file = SD.open(path, FILE_READ);
+    if (!file) {
+        return 0;
+    }
+    uint32_t size = file.size();
+    file.close();
+    return size;
+}
+
+// "bytes 0-1023/5000", or "bytes */5000" to ask how much has arrived
+// (start and end are then left alone)
+static bool parseContentRange(const String& value, uint32_t& start, uint32_t& end, uint32_t& total, bool& query) {
+    unsigned s, e, t;
+    if (sscanf(value.c_str(), "bytes %u-%u/%u", &s, &e, &t) == 3 && s <= e && e < t) {
+        start = s;
+        end = e;
+        total = t;
+        query = false;
+        return true;
+    }
+    if (sscanf(value.c_str(), "bytes */%u", &t) == 1) {
+        total = t;
+        query = true;
+        return true;
+    }
+    return false;
+}
+
+WebServerManager::UploadSlot* WebServerManager::claimUpload(AsyncWebServerRequest* request, const String& name) {
+    for (UploadSlot& slot : _uploads) {
+        // A writer still closing the last file keeps its slot until done
+        if (slot.request || slot.writer.isBusy()) {
+            continue;
         }
-    </style>
-</head>
-<body>
-    <div class="container">
-        <div class="header">
-            <h1>🎵 MusicBox</h1>
-            <p>Configuración del Reproductor NFC</p>
-        </div>
         
-        <div class="status" id="status">
-            <div>Estado: <span id="playerState">Detenido</span></div>
-            <div id="currentSong"></div>
-        </div>
+        slot.request = request;
+        strlcpy(slot.name, name.c_str(), sizeof(slot.name));
+        slot.resumable = false;
+        slot.total = 0;
+        slot.end = 0;
+        slot.received = 0;
+        slot.error = 0;
         
-        <div class="content">
-            <!-- Songs Section -->
-            <div class="section">
-                <h2>📀 Gestión de Canciones</h2>
-                <div class="file-input" onclick="document.getElementById('fileInput').click()">
-                    <p>Haz clic para subir una canción MP3</p>
-                    <input type="file" id="fileInput" accept=".mp3" style="display:none">
-                </div>
-                <div id="uploadProgress" style="display:none;">
-                    <div class="progress">
-                        <div class="progress-bar" id="progressBar">0%</div>
-                    </div>
-                </div>
-                <div id="songsList"></div>
-            </div>
-            
-            <!-- NFC Tags Section -->
-            <div class="section">
-                <h2>🏷️ Gestión de Tags NFC</h2>
-                <button class="btn" onclick="openLinkModal()">Vincular Nuevo Tag</button>
-                <div id="tagsList"></div>
-            </div>
-        </div>
-    </div>
-    
-    <!-- Link Tag Modal -->
-    <div id="linkModal" class="modal">
-        <div class="modal-content">
-            <span class="close" onclick="closeLinkModal()">&times;</span>
-            <h2>Vincular Tag NFC</h2>
-            <p id="scanStatus" style="color: #667eea; font-weight: bold;">🔍 Escaneando... Acerca el tag NFC al lector</p>
-            <input type="text" id="tagUid" placeholder="UID del Tag" readonly style="font-family: monospace; font-size: 14px;">
-            <select id="songSelect">
-                <option value="">Selecciona una canción</option>
-            </select>
-            <button class="btn" onclick="linkTag()" style="margin-top: 15px;">Vincular</button>
-        </div>
-    </div>
-    
-    <script>
-        let scanInterval = null;
-        
-        // Load initial data
-        document.addEventListener('DOMContentLoaded', function() {
-            loadSongs();
-            loadTags();
-            updateStatus();
-            setInterval(updateStatus, 2000);
-        });
-        
-        // File upload
-        document.getElementById('fileInput').addEventListener('change', function(e) {
-            const file = e.target.files[0];
-            if (!file) return;
-            
-            const formData = new FormData();
-            formData.append('file', file);
-            
-            const xhr = new XMLHttpRequest();
-            
-            xhr.upload.addEventListener('progress', function(e) {
-                if (e.lengthComputable) {
-                    const percent = (e.loaded / e.total) * 100;
-                    document.getElementById('uploadProgress').style.display = 'block';
-                    document.getElementById('progressBar').style.width = percent + '%';
-                    document.getElementById('progressBar').textContent = Math.round(percent) + '%';
-                }
-            });
-            
-            xhr.addEventListener('load', function() {
-                if (xhr.status === 200) {
-                    alert('Canción subida correctamente');
-                    loadSongs();
-                } else {
-                    alert('Error al subir la canción');
-                }
-                document.getElementById('uploadProgress').style.display = 'none';
-                document.getElementById('fileInput').value = '';
-            });
-            
-            xhr.open('POST', '/api/songs/upload');
-            xhr.send(formData);
+        // Fires on every way out: response sent, client gone, timeout
+        request->onDisconnect([this, request]() {
+            UploadSlot* slot = findUpload(request);
+            if (slot) {
+                releaseUpload(slot);
+            }
         });
-        
-        function loadSongs() {
-            fetch('/api/songs')
-                .then(r => r.json())
-                .then(data => {
-                    const list = document.getElementById('songsList');
-                    list.innerHTML = '';
-                    data.songs.forEach(song => {
-                        const item = document.createElement('div');
-                        item.className = 'list-item';
-                        item.innerHTML = `
-                            <span>🎵 ${song}</span>
-                            <button class="btn btn-danger" onclick="deleteSong('${song}')">Eliminar</button>
-                        `;
-                        list.appendChild(item);
-                    });
-                    
-                    // Update song select in modal
-                    const select = document.getElementById('songSelect');
-                    select.innerHTML = '<option value="">Selecciona una canción</option>';
-                    data.songs.forEach(song => {
-                        const option = document.createElement('option');
-                        option.value = song;
-                        option.textContent = song;
-                        select.appendChild(option);
-                    });
-                });
-        }
-        
-        function deleteSong(filename) {
-            if (!confirm('¿Eliminar ' + filename + '?')) return;
-            fetch('/api/songs/' + encodeURIComponent(filename), { method: 'DELETE' })
-                .then(r => r.json())
-                .then(() => loadSongs());
+        return &slot;
+    }
+    return nullptr;
+}
+
+WebServerManager::UploadSlot* WebServerManager::findUpload(AsyncWebServerRequest* request) {
+    for (UploadSlot& slot : _uploads) {
+        if (slot.request == request) {
+            return &slot;
         }
-        
-        function loadTags() {
-            fetch('/api/tags')
-                .then(r => r.json())
-                .then(data => {
-                    const list = document.getElementById('tagsList');
-                    list.innerHTML = '';
-                    data.tags.forEach(tag => {
-                        const item = document.createElement('div');
-                        item.className = 'list-item';
-                        item.innerHTML = `
-                            <span>🏷️ ${tag.uid} → ${tag.song}</span>
-                            <button class="btn btn-danger" onclick="unlinkTag('${tag.uid}')">Desvincular</button>
-                        `;
-                        list.appendChild(item);
-                    });
-                });
+    }
+    return nullptr;
+}
+
+WebServerManager::UploadSlot* WebServerManager::findUpload(const String& name) {
+    for (UploadSlot& slot : _uploads) {
+        if ((slot.request || slot.writer.isBusy()) && name == slot.name) {
+            return &slot;
         }
-        
-        function openLinkModal() {
-            document.getElementById('linkModal').style.display = 'block';
-            document.getElementById('tagUid').value = '';
-            document.getElementById('scanStatus').textContent = '🔍 Escaneando... Acerca el tag NFC al lector';
-            document.getElementById('scanStatus').style.color = '#667eea';
-            
-            // Clear last scanned UID on server
-            fetch('/api/tags/scan/clear', { method: 'POST' })
-                .then(() => console.log('Cleared last scanned UID'))
-                .catch(err => console.error('Error clearing UID:', err));
-            
-            startScanning();
+    }
+    return nullptr;
+}
+
+void WebServerManager::releaseUpload(UploadSlot* slot) {
+    if (slot->writer.isActive()) {
+        // The client went away mid-body
+        if (slot->resumable) {
+            // Keep everything that arrived; the client resumes from there
+            slot->writer.finish();
+            LOG_INFO("Upload paused: %s", slot->name);
+        } else {
+            // Not resumable: the writer deletes the file
+            slot->writer.abort();
         }
-        
-        function closeLinkModal() {
-            document.getElementById('linkModal').style.display = 'none';
-            stopScanning();
+    }
+    slot->request = nullptr;
+}
+
+// Last byte of this request's data: the writer task closes the file, and
+// moves it into place once every byte of it is there
+void WebServerManager::finishUpload(UploadSlot* slot) {
+    slot->received = std::max(slot->received, slot->end);
+    slot->writer.finish(slot->received == slot->total ? slot->name : nullptr);
+}
+
+// Hands data to the writer. Never waits: if the card has fallen behind, the
+// data is refused and the client is told to come back (503).
+bool WebServerManager::writeUpload(UploadSlot* slot, uint8_t* data, size_t len) {
+    if (slot->writer.write(data, len)) {
+        return true;
+    }
+    
+    if (slot->writer.hasStalled()) {
+        // Everything before this segment goes to the card; a PUT resumes
+        // from there, a form upload has to start over
+        if (slot->resumable) {
+            slot->writer.finish();
+        } else {
+            slot->writer.abort();
         }
-        
-        function startScanning() {
-            console.log('Started NFC scanning...');
-            scanInterval = setInterval(() => {
-                fetch('/api/tags/scan')
-                    .then(r => r.json())
-                    .then(data => {
-                        console.log('Scan response:', data);
-                        if (data.uid && data.uid !== null) {
-                            document.getElementById('tagUid').value = data.uid;
-                            document.getElementById('scanStatus').textContent = '✅ Tag detectado: ' + data.uid;
-                            document.getElementById('scanStatus').style.color = '#27ae60';
-                            console.log('Tag detected:', data.uid);
-                        }
-                    })
-                    .catch(err => {
-                        console.error('Scan error:', err);
-                        document.getElementById('scanStatus').textContent = '⚠️ Error al escanear';
-                        document.getElementById('scanStatus').style.color = '#e74c3c';
-                    });
-            }, 500);
+        slot->error = 503;
+    } else {
+        slot->writer.abort();
+        slot->error = 500;
+    }
+    return false;
+}
+
+// 503 from a stalled writer: the client may resume after a moment
+static void sendUploadStatus(AsyncWebServerRequest* request, int status, const String& json) {
+    AsyncWebServerResponse* response = request->beginResponse(status, "application/json", json);
+    if (status == 503) {
+        response->addHeader("Retry-After", String(UPLOAD_RETRY_AFTER_S));
+    }
+    request->send(response);
+}
+
+// ============================================================================
+// POST /api/songs/upload (multipart form, one shot)
+// ============================================================================
+
+void WebServerManager::handleUploadSong(AsyncWebServerRequest* request, String filename, 
+                                       size_t index, uint8_t* data, size_t len, bool final) {
+    UploadSlot* slot = findUpload(request);
+    if (!index) {
+        bool busy = false;
+        if (!slot) {
+            busy = findUpload(filename) != nullptr;
+            slot = claimUpload(request, filename);
         }
-        
-        function stopScanning() {
-            if (scanInterval) {
-                clearInterval(scanInterval);
-                scanInterval = null;
-            }
+        if (!slot) {
+            LOG_ERROR("✗ Upload rejected, %d already running: %s", UPLOAD_MAX_CONCURRENT, filename.c_str());
+            return;
         }
-        
-        function linkTag() {
-            const uid = document.getElementById('tagUid').value;
-            const song = document.getElementById('songSelect').value;
-            
-            if (!uid || !song) {
-                alert('Debes escanear un tag y seleccionar una canción');
-                return;
-            }
-            
-            fetch('/api/tags/link', {
-                method: 'POST',
-                headers: { 'Content-Type': 'application/json' },
-                body: JSON.stringify({ uid, song })
-            })
-            .then(r => r.json())
-            .then(() => {
-                alert('Tag vinculado correctamente');
-                closeLinkModal();
-                loadTags();
-            });
+        if (!isValidSongName(filename)) {
+            slot->error = 400;
+            return;
         }
-        
-        function unlinkTag(uid) {
-            if (!confirm('¿Desvincular tag?')) return;
-            fetch('/api/tags/' + encodeURIComponent(uid), { method: 'DELETE' })
-                .then(r => r.json())
-                .then(() => loadTags());
+        if (busy) {
+            // Both would write the same .part file
+            LOG_WARN("⚠ Upload rejected, already running: %s", filename.c_str());
+            slot->error = 409;
+            return;
         }
         
-        function updateStatus() {
-            fetch('/api/status')
-                .then(r => r.json())
-                .then(data => {
-                    const stateEl = document.getElementById('playerState');
-                    const songEl = document.getElementById('currentSong');
-                    
-                    stateEl.textContent = data.state;
-                    stateEl.className = data.state === 'playing' ? 'status-playing' : 
-                                       data.state === 'paused' ? 'status-paused' : '';
-                    
-                    if (data.currentSong) {
-                        songEl.textContent = '♪ ' + data.currentSong;
-                        songEl.style.display = 'block';
-                    } else {
-                        songEl.style.display = 'none';
-                    }
-                });
+        LOG_INFO("Upload Start: %s", filename.c_str());
+        strlcpy(slot->name, filename.c_str(), sizeof(slot->name));
+        // Not resumable: a failed upload leaves nothing on the card
+        if (!slot->writer.open(partPath(slot->name).c_str(), 0, false)) {
+            slot->error = 503;
+            return;
         }
-    </script>
-</body>
-</html>
-)rawliteral";
+    }
     
-    request->send(200, "text/html", html);
+    if (!slot || slot->error || !slot->writer.isActive()) {
+        return;
+    }
+    
+    if (!writeUpload(slot, data, len)) {
+        return;
+    }
+    
+    if (final) {
+        slot->end = index + len;
+        slot->total = slot->end;
+        finishUpload(slot);
+    }
 }
 
-void WebServerManager::handleListSongs(AsyncWebServerRequest* request) {
-    std::vector<String> songs = storage.listMusicFiles();
+void WebServerManager::handleUploadDone(AsyncWebServerRequest* request) {
+    // Runs after the last part has been handled. The file is usually still
+    // being written then: 202, and the song shows up in the list once it
+    // is in place.
+    UploadSlot* slot = findUpload(request);
+    int status = !slot ? 503 : slot->error ? slot->error : slot->writer.isBusy() ? 202 :
+                 slot->writer.getStats().ok ? 200 : 500;
+    
+    if (status < 300) {
+        request->send(status, "application/json", "{\"success\":true}");
+    } else {
+        String error = !slot ? "Too many uploads" : status == 503 ? "Busy, try again" :
+                       status == 409 ? "Already uploading" : status == 400 ? "Bad upload" : "Upload failed";
+        sendUploadStatus(request, status, "{\"success\":false,\"error\":\"" + error + "\"}");
+    }
+}
+
+// ============================================================================
+// PUT /api/songs/<name> (raw body, resumable with Content-Range)
+// ============================================================================
+
+WebServerManager::UploadSlot* WebServerManager::beginPut(AsyncWebServerRequest* request, size_t length) {
+    String name = request->url().substring(strlen("/api/songs/"));
+    // A retry while the old connection is still open, or a second tab
+    bool busy = findUpload(name) != nullptr;
+    UploadSlot* slot = claimUpload(request, name);
+    if (!slot) {
+        return nullptr;
+    }
+    slot->resumable = true;
+    if (busy) {
+        LOG_WARN("⚠ Upload rejected, already running: %s", slot->name);
+        slot->error = 409;
+        return slot;
+    }
     
-    DynamicJsonDocument doc(2048);
-    JsonArray songsArray = doc.createNestedArray("songs");
+    uint32_t start = 0;
+    uint32_t end = length - 1;
+    uint32_t total = length;
+    bool query = false;
+    if (!isValidSongName(name) ||
+        (request->hasHeader("Content-Range") &&
+         (!parseContentRange(request->header("Content-Range"), start, end, total, query) ||
+          query || end - start + 1 != length))) {
+        slot->error = 400;
+        return slot;
+    }
+    if (total > MAX_UPLOAD_SIZE) {
+        slot->error = 413;
+        return slot;
+    }
     
-    for (const auto& song : songs) {
-        songsArray.add(song);
+    // Pieces may repeat what we have, but not leave a gap
+    slot->received = (start > 0) ? fileSize(partPath(slot->name)) : 0;
+    if (start > slot->received) {
+        slot->error = 416;
+        return slot;
     }
     
-    String response;
-    serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    slot->total = total;
+    slot->end = end + 1;
+    if (start == 0) {
+        LOG_INFO("Upload Start: %s (%u bytes)", slot->name, (unsigned)total);
+    } else {
+        LOG_INFO("Upload resumed: %s at %u of %u", slot->name, (unsigned)start, (unsigned)total);
+    }
+    if (!slot->writer.open(partPath(slot->name).c_str(), start)) {
+        slot->error = 503;
+    }
+    return slot;
 }
 
-void WebServerManager::handleDeleteSong(AsyncWebServerRequest* request) {
-    String path = request->url();
-    String filename = path.substring(path.lastIndexOf('/') + 1);
-    
-    bool success = storage.deleteMusicFile(filename);
+void WebServerManager::handlePutSongBody(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+    UploadSlot* slot = findUpload(request);
+    if (index == 0 && !slot) {
+        slot = beginPut(request, total);
+    }
+    if (!slot || slot->error || !slot->writer.isActive()) {
+        return;
+    }
     
-    DynamicJsonDocument doc(128);
-    doc["success"] = success;
+    if (!writeUpload(slot, data, len)) {
+        return;
+    }
     
-    String response;
-    serializeJson(doc, response);
-    request->send(success ? 200 : 404, "application/json", response);
+    if (index + len == total) {
+        finishUpload(slot);
+    }
 }
 
-void WebServerManager::handleUploadSong(AsyncWebServerRequest* request, String filename, 
-                                       size_t index, uint8_t* data, size_t len, bool final) {
-    if (!index) {
-        Serial.printf("Upload Start: %s\n", filename.c_str());
-        String filepath = storage.getMusicPath(filename);
-        uploadFile = SD.open(filepath, FILE_WRITE);
-        if (!uploadFile) {
-            Serial.println("Failed to open file for writing");
+void WebServerManager::handlePutSong(AsyncWebServerRequest* request) {
+    UploadSlot* slot = findUpload(request);
+    if (!slot && request->contentLength() > 0) {
+        sendUploadStatus(request, 503, "{\"success\":false,\"error\":\"Too many uploads\"}");
+        return;
+    }
+    
+    DynamicJsonDocument doc(256);
+    int status;
+    String name = request->url().substring(strlen("/api/songs/"));
+    UploadSlot* other = slot ? nullptr : findUpload(name);
+    
+    if (slot) {
+        // The data is usually still on its way to the card: 202, and the
+        // client asks again once the writer is done
+        bool busy = slot->writer.isBusy();
+        bool written = !busy && slot->writer.getStats().ok;
+        bool complete = written && slot->received == slot->total;
+        status = slot->error ? slot->error : busy ? 202 : !written ? 500 : complete ? 201 : 200;
+        doc["received"] = slot->received;
+        doc["total"] = slot->total;
+        doc["complete"] = complete;
+    } else if (other) {
+        // Asked while that upload is still arriving or being written
+        status = 202;
+        doc["received"] = other->received;
+        doc["total"] = other->total;
+        doc["complete"] = false;
+    } else {
+        // No body: "Content-Range: bytes */<total>" asks where to resume
+        uint32_t start, end, total = 0;
+        bool query = true;
+        if (!isValidSongName(name) ||
+            (request->hasHeader("Content-Range") &&
+             (!parseContentRange(request->header("Content-Range"), start, end, total, query) || !query))) {
+            request->send(400, "application/json", "{\"success\":false,\"error\":\"Bad Content-Range\"}");
             return;
         }
+        
+        String part = partPath(name.c_str());
+        uint32_t received = fileSize(part);
+        bool complete = false;
+        if (total > 0 && received == total) {
+            // Every byte arrived but the connection dropped before the end
+            complete = storage.installMusicFile(part, name);
+        } else if (received == 0 && storage.musicFileExists(name)) {
+            CatalogEntry entry;
+            storage.getCatalog().find(name.c_str(), &entry);
+            received = entry.size;
+            complete = (total == 0 || received == total);
+        }
+        
+        status = complete ? 201 : 200;
+        doc["received"] = received;
+        doc["total"] = total;
+        doc["complete"] = complete;
     }
     
-    if (uploadFile) {
-        uploadFile.write(data, len);
+    doc["success"] = status < 300;
+    if (status == 416) {
+        doc["error"] = "Resume from received";
+    } else if (status >= 400) {
+        doc["error"] = status == 413 ? "File too large" : status == 400 ? "Bad request" :
+                       status == 409 ? "Already uploading" : status == 503 ? "Busy, try again" :
+                       "Upload failed";
     }
     
-    if (final) {
-        if (uploadFile) {
-            uploadFile.close();
+    String response;
+    serializeJson(doc, response);
+    sendUploadStatus(request, status, response);
+}
+
+// ============================================================================
+// GET /api/songs/<name>/stream
+// ============================================================================
+
+// "bytes=0-499", "bytes=500-" or "bytes=-500". Returns 1 for a range to
+// serve, 0 to ignore the header and send everything (malformed, or several
+// ranges), -1 if it starts past the end.
+static int parseRange(const String& value, uint32_t size, uint32_t& start, uint32_t& end) {
+    if (!value.startsWith("bytes=") || value.indexOf(',') >= 0) {
+        return 0;
+    }
+    
+    String spec = value.substring(strlen("bytes="));
+    int dash = spec.indexOf('-');
+    if (dash < 0) {
+        return 0;
+    }
+    String first = spec.substring(0, dash);
+    String last = spec.substring(dash + 1);
+    first.trim();
+    last.trim();
+    
+    if (first.length() == 0) {
+        // The last N bytes
+        uint32_t n = strtoul(last.c_str(), nullptr, 10);
+        if (last.length() == 0 || n == 0 || size == 0) {
+            return -1;
         }
-        Serial.printf("Upload Complete: %s (%d bytes)\n", filename.c_str(), index + len);
+        start = (n >= size) ? 0 : size - n;
+        end = size - 1;
+        return 1;
+    }
+    
+    start = strtoul(first.c_str(), nullptr, 10);
+    if (start >= size) {
+        return -1;
     }
+    end = last.length() ? std::min((uint32_t)strtoul(last.c_str(), nullptr, 10), size - 1) : size - 1;
+    return (end >= start) ? 1 : 0;
 }
 
-void WebServerManager::handleListTags(AsyncWebServerRequest* request) {
-    std::vector<NFCLink> links = storage.getAllLinks();
+void WebServerManager::handleStreamSong(AsyncWebServerRequest* request) {
+    String url = request->url();
+    if (!url.endsWith("/stream")) {
+        handleNotFound(request);
+        return;
+    }
+    String name = url.substring(strlen("/api/songs/"), url.length() - strlen("/stream"));
     
-    DynamicJsonDocument doc(2048);
-    JsonArray tagsArray = doc.createNestedArray("tags");
+    CatalogEntry entry;
+    if (!isValidSongName(name) || !storage.getCatalog().find(name.c_str(), &entry)) {
+        request->send(404, "application/json", "{\"error\":\"Song not found\"}");
+        return;
+    }
     
-    for (const auto& link : links) {
-        JsonObject obj = tagsArray.createNestedObject();
-        obj["uid"] = link.uid;
-        obj["song"] = link.songPath;
+    uint32_t size = entry.size;
+    uint32_t start = 0;
+    uint32_t end = size ? size - 1 : 0;
+    int range = request->hasHeader("Range") ? parseRange(request->header("Range"), size, start, end) : 0;
+    if (range < 0) {
+        AsyncWebServerResponse* response = request->beginResponse(416);
+        response->addHeader("Content-Range", "bytes */" + String(size));
+        request->send(response);
+        return;
     }
     
-    String response;
-    serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    uint32_t length = size ? end - start + 1 : 0;
+    auto stream = std::make_shared<FileRangeStream>(storage.getMusicPath(name), start, length);
+    if (!stream->isOpen()) {
+        request->send(500, "application/json", "{\"error\":\"Failed to open song\"}");
+        return;
+    }
+    
+    AsyncWebServerResponse* response = request->beginResponse("audio/mpeg", length,
+        [stream](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+            return stream->fill(buffer, maxLen, index);
+        });
+    response->addHeader("Accept-Ranges", "bytes");
+    if (range > 0) {
+        char contentRange[48];
+        snprintf(contentRange, sizeof(contentRange), "bytes %u-%u/%u",
+                 (unsigned)start, (unsigned)end, (unsigned)size);
+        response->setCode(206);
+        response->addHeader("Content-Range", contentRange);
+    }
+    request->send(response);
+}
+
+void WebServerManager::handleListTags(AsyncWebServerRequest* request) {
+    String prefix;
+    size_t offset, limit;
+    readListParams(request, prefix, offset, limit);
+    
+    sendListStream(request, std::make_shared<TagListStream>(prefix, offset, limit));
 }
 
 void WebServerManager::handleLinkTagBody(AsyncWebServerRequest* request, uint8_t *data, size_t len, size_t index, size_t total) {
@@ -578,25 +705,31 @@ void WebServerManager::handleLinkTagBody(AsyncWebServerRequest* request, uint8_t
     
     // When all data received, process the request
     if (index + len == total) {
-        Serial.printf("[WEB] Link request body: %s\n", _linkRequestBody.c_str());
+        LOG_INFO("[WEB] Link request body: %s", _linkRequestBody.c_str());
         
         DynamicJsonDocument doc(256);
         DeserializationError error = deserializeJson(doc, _linkRequestBody);
         
         if (error) {
-            Serial.printf("[WEB] Failed to parse JSON: %s\n", error.c_str());
+            LOG_INFO("[WEB] Failed to parse JSON: %s", error.c_str());
             request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid JSON\"}");
             return;
         }
         
-        String uid = doc["uid"].as<String>();
+        const char* uidHex = doc["uid"] | "";
         String song = doc["song"].as<String>();
         
-        Serial.printf("[WEB] Linking UID '%s' to song '%s'\n", uid.c_str(), song.c_str());
+        TagUid uid;
+        if (!TagUid::fromHex(uidHex, uid)) {
+            request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid UID\"}");
+            return;
+        }
+        
+        LOG_INFO("[WEB] Linking UID '%s' to song '%s'", uidHex, song.c_str());
         
         bool success = storage.linkNFC(uid, song);
         
-        Serial.printf("[WEB] Link result: %s\n", success ? "SUCCESS" : "FAILED");
+        LOG_INFO("[WEB] Link result: %s", success ? "SUCCESS" : "FAILED");
         
         DynamicJsonDocument responseDoc(128);
         responseDoc["success"] = success;
@@ -615,9 +748,9 @@ void WebServerManager::handleLinkTag(AsyncWebServerRequest* request) {
 
 void WebServerManager::handleUnlinkTag(AsyncWebServerRequest* request) {
     String path = request->url();
-    String uid = path.substring(path.lastIndexOf('/') + 1);
-    
-    bool success = storage.unlinkNFC(uid);
+    TagUid uid;
+    bool success = TagUid::fromHex(path.c_str() + path.lastIndexOf('/') + 1, uid) &&
+                   storage.unlinkNFC(uid);
     
     DynamicJsonDocument doc(128);
     doc["success"] = success;
@@ -628,44 +761,117 @@ void WebServerManager::handleUnlinkTag(AsyncWebServerRequest* request) {
 }
 
 void WebServerManager::handleScanTag(AsyncWebServerRequest* request) {
-    DynamicJsonDocument doc(256);
-    
-    // Return the last detected UID (if any)
-    String lastUID = nfcReader.getLastUID();
-    
-    Serial.printf("[WEB] /api/tags/scan called - Last UID: '%s' (length: %d)\n", 
-                  lastUID.c_str(), lastUID.length());
+    // Kept for API clients; the UI listens for "tag" events instead
+    DynamicJsonDocument doc(128);
     
-    if (lastUID != "" && lastUID.length() > 0) {
-        doc["uid"] = lastUID;
+    TagUid lastUID = nfcReader.getLastUID();
+    if (!lastUID.isEmpty()) {
+        char uid[TagUid::HEX_SIZE];
+        lastUID.toHex(uid);
+        doc["uid"] = uid;  // Copied into the document
         doc["detected"] = true;
-        Serial.printf("[WEB] → Returning scanned UID: %s\n", lastUID.c_str());
     } else {
         doc["uid"] = nullptr;
         doc["detected"] = false;
-        Serial.println("[WEB] → No UID available");
     }
     
     String response;
     serializeJson(doc, response);
-    Serial.printf("[WEB] → Response: %s\n", response.c_str());
     request->send(200, "application/json", response);
 }
 
 void WebServerManager::handleStatus(AsyncWebServerRequest* request) {
-    DynamicJsonDocument doc(256);
+    request->send(200, "application/json", buildStatusJson());
+}
+
+void WebServerManager::handleMetrics(AsyncWebServerRequest* request) {
+    // Without the FreeRTOS trace facility only registered tasks are listed
+    metrics.trackTask(xTaskGetCurrentTaskHandle());
+    
+    bool json = (request->hasParam("format") && request->getParam("format")->value() == "json") ||
+                (request->hasHeader("Accept") && request->header("Accept").indexOf("application/json") >= 0);
+    
+    // Written straight into the response as it is built, no intermediate document
+    AsyncResponseStream* response = request->beginResponseStream(
+        json ? "application/json" : "text/plain; version=0.0.4");
+    if (json) {
+        metrics.writeJson(*response);
+    } else {
+        metrics.writePrometheus(*response);
+    }
+    request->send(response);
+}
+
+String WebServerManager::buildStatusJson() {
+    DynamicJsonDocument doc(512);
     
     String state = "stopped";
     if (audioPlayer.isPlaying()) state = "playing";
     else if (audioPlayer.isPaused()) state = "paused";
     
     doc["state"] = state;
-    doc["currentSong"] = audioPlayer.getCurrentSong();
+    char song[AUDIO_MAX_PATH_LENGTH];
+    audioPlayer.getCurrentSong(song, sizeof(song));
+    doc["currentSong"] = song;
     doc["volume"] = audioPlayer.getVolume();
+    doc["positionMs"] = audioPlayer.getPositionMs();
+    doc["positionBytes"] = audioPlayer.getPositionBytes();
+    doc["positionSamples"] = audioPlayer.getPositionSamples();
+    doc["durationMs"] = audioPlayer.getDurationMs();
+    doc["audioCpuLoad"] = audioPlayer.getCpuLoad();
+    doc["audioUnderruns"] = audioPlayer.getUnderruns();
+    doc["sdBackgroundTimeouts"] = sdBus.getBackgroundTimeouts();
+    
+    // Also runs on the loop task, while async_tcp works on the slots: only
+    // the writers' atomic busy flags and the stats the writer task
+    // publishes under its lock are read here
+    size_t active = 0;
+    for (UploadSlot& slot : _uploads) {
+        if (slot.writer.isBusy()) {
+            active++;
+        }
+    }
+    UploadStats upload = UploadWriter::getLastStats();
+    if (active > 0) {
+        doc["upload"]["active"] = active;
+    } else if (upload.bytes > 0) {
+        JsonObject last = doc.createNestedObject("upload");
+        last["bytes"] = upload.bytes;
+        last["ms"] = upload.elapsedMs;
+        last["kbps"] = upload.bytes * 8 / std::max(upload.elapsedMs, (uint32_t)1);
+        last["stalls"] = upload.stalls;
+        last["underruns"] = upload.underruns;
+        last["ok"] = upload.ok;
+    }
     
     String response;
     serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    return response;
+}
+
+void WebServerManager::handleSeek(AsyncWebServerRequest* request) {
+    // Position in milliseconds, as a query or form parameter: ?ms=90000
+    AsyncWebParameter* param = nullptr;
+    if (request->hasParam("ms", true)) {
+        param = request->getParam("ms", true);
+    } else if (request->hasParam("ms")) {
+        param = request->getParam("ms");
+    }
+    
+    if (!param || audioPlayer.getState() == STOPPED) {
+        request->send(400, "application/json", "{\"success\":false,\"error\":\"Nothing to seek\"}");
+        return;
+    }
+    
+    long positionMs = param->value().toInt();
+    bool success = positionMs >= 0 && audioPlayer.seek((uint32_t)positionMs);
+    
+    DynamicJsonDocument doc(128);
+    doc["success"] = success;
+    
+    String response;
+    serializeJson(doc, response);
+    request->send(success ? 200 : 400, "application/json", response);
 }
 
 void WebServerManager::handleNotFound(AsyncWebServerRequest* request) {
@@ -0,0 +1,308 @@
+// Host tests for the crash safety of the NFC link journal: whatever a power
+// cut leaves on the card has to load back to the links of the last complete
+// write, and later writes have to survive the next boot.
+//   pio test -e native -f test_link_journal
+#include <unity.h>
+#include <Arduino.h>
+#include <SD.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "sim.h"
+#include "link_journal.h"
+
+#define TMP_SNAPSHOT NFC_LINKS_SNAPSHOT ".tmp"
+
+typedef std::map<std::string, std::string> Links;  // Hex UID -> path
+
+// Links after a journal record, and where that record ends in the file
+struct Step {
+    size_t end;
+    Links links;
+};
+
+static TagUid makeUid(uint32_t n) {
+    uint8_t bytes[4] = { 0x04, (uint8_t)(n >> 16), (uint8_t)(n >> 8), (uint8_t)n };
+    return TagUid::fromBytes(bytes, sizeof(bytes));
+}
+
+static std::string hex(const TagUid& uid) {
+    char text[TagUid::HEX_SIZE];
+    uid.toHex(text);
+    return text;
+}
+
+static Links contents(const NfcLinkTable& table) {
+    Links links;
+    table.forEach([&links](const TagUid& uid, const char* path) {
+        links[hex(uid)] = path;
+    });
+    return links;
+}
+
+static std::vector<uint8_t> readFile(const char* path) {
+    std::vector<uint8_t> data;
+    File file = SD.open(path, FILE_READ);
+    TEST_ASSERT_TRUE(file);
+    data.resize(file.size());
+    TEST_ASSERT_EQUAL(data.size(), file.read(data.data(), data.size()));
+    file.close();
+    return data;
+}
+
+static void writeFile(const char* path, const std::vector<uint8_t>& data, size_t length) {
+    SD.remove(path);
+    File file = SD.open(path, FILE_WRITE);
+    TEST_ASSERT_TRUE(file);
+    TEST_ASSERT_EQUAL(length, file.write(data.data(), length));
+    file.close();
+}
+
+static void wipeCard() {
+    SD.remove(NFC_LINKS_SNAPSHOT);
+    SD.remove(TMP_SNAPSHOT);
+    SD.remove(NFC_LINKS_JOURNAL);
+}
+
+static void assertLinks(const Links& expected, const NfcLinkTable& table, const char* message) {
+    Links actual = contents(table);
+    TEST_ASSERT_EQUAL_MESSAGE(expected.size(), actual.size(), message);
+    for (const auto& link : expected) {
+        auto found = actual.find(link.first);
+        TEST_ASSERT_TRUE_MESSAGE(found != actual.end(), message);
+        TEST_ASSERT_EQUAL_STRING_MESSAGE(link.second.c_str(), found->second.c_str(), message);
+    }
+}
+
+// Links, relinks (to a new and to a shared path) and unlinks, one journal
+// record each, starting from `links`
+static std::vector<Step> writeScript(LinkJournal& journal, Links links) {
+    struct Op {
+        uint32_t tag;
+        const char* path;  // nullptr: unlink
+    };
+    static const Op script[] = {
+        { 1, "/music/one.mp3" },
+        { 2, "/music/two.mp3" },
+        { 3, "/music/album" },
+        { 2, "/music/two (live).mp3" },
+        { 4, "/music/album" },
+        { 1, nullptr },
+        { 5, "/music/a rather long folder name/with a rather long song name.mp3" },
+        { 3, nullptr },
+        { 1, "/music/one again.mp3" },
+    };
+    
+    std::vector<Step> steps;
+    for (const Op& op : script) {
+        TagUid uid = makeUid(op.tag);
+        if (op.path) {
+            TEST_ASSERT_TRUE(journal.appendLink(uid, op.path));
+            links[hex(uid)] = op.path;
+        } else {
+            TEST_ASSERT_TRUE(journal.appendUnlink(uid));
+            links.erase(hex(uid));
+        }
+        File file = SD.open(NFC_LINKS_JOURNAL, FILE_READ);
+        steps.push_back({ (size_t)file.size(), links });
+        file.close();
+    }
+    return steps;
+}
+
+// Links in the snapshot under the journal
+static Links writeSnapshot(bool withSnapshot) {
+    NfcLinkTable table;
+    if (withSnapshot) {
+        table.set(makeUid(1), "/music/before.mp3");
+        table.set(makeUid(7), "/music/seven.mp3");
+        table.set(makeUid(8), "/music/eight.mp3");
+        LinkJournal journal;
+        TEST_ASSERT_TRUE(journal.compact(table));
+    }
+    return contents(table);
+}
+
+// Every prefix of the journal, as a power cut in the middle of an append
+// leaves it
+static void checkTornJournal(bool withSnapshot) {
+    wipeCard();
+    Links base = writeSnapshot(withSnapshot);
+    std::vector<uint8_t> snapshot;
+    if (withSnapshot) {
+        snapshot = readFile(NFC_LINKS_SNAPSHOT);
+    }
+    LinkJournal writer;
+    std::vector<Step> steps = writeScript(writer, base);
+    std::vector<uint8_t> journal = readFile(NFC_LINKS_JOURNAL);
+    TEST_ASSERT_EQUAL(steps.back().end, journal.size());
+    
+    for (size_t cut = 0; cut <= journal.size(); cut++) {
+        wipeCard();
+        if (withSnapshot) {
+            writeFile(NFC_LINKS_SNAPSHOT, snapshot, snapshot.size());
+        }
+        writeFile(NFC_LINKS_JOURNAL, journal, cut);
+        
+        // Every record that ended before the cut, and nothing else
+        const Links* expected = &base;
+        bool torn = cut > 0;
+        for (const Step& step : steps) {
+            if (step.end <= cut) {
+                expected = &step.links;
+                torn = step.end != cut;
+            }
+        }
+        
+        char message[48];
+        snprintf(message, sizeof(message), "journal cut at byte %u", (unsigned)cut);
+        NfcLinkTable table;
+        LinkJournal journalAfterBoot;
+        TEST_ASSERT_TRUE_MESSAGE(journalAfterBoot.load(table), message);
+        assertLinks(*expected, table, message);
+        
+        if (torn) {
+            // The good part was folded into a fresh snapshot
+            TEST_ASSERT_TRUE_MESSAGE(SD.exists(NFC_LINKS_SNAPSHOT), message);
+            TEST_ASSERT_FALSE_MESSAGE(SD.exists(TMP_SNAPSHOT), message);
+            TEST_ASSERT_FALSE_MESSAGE(SD.exists(NFC_LINKS_JOURNAL), message);
+        }
+        
+        // A link made after the boot must not land behind a torn record
+        Links next = *expected;
+        TagUid uid = makeUid(99);
+        TEST_ASSERT_TRUE(table.set(uid, "/music/after.mp3"));
+        TEST_ASSERT_TRUE_MESSAGE(journalAfterBoot.appendLink(uid, "/music/after.mp3"), message);
+        next[hex(uid)] = "/music/after.mp3";
+        
+        NfcLinkTable reloaded;
+        LinkJournal journalAfterSecondBoot;
+        TEST_ASSERT_TRUE_MESSAGE(journalAfterSecondBoot.load(reloaded), message);
+        assertLinks(next, reloaded, message);
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_torn_journal() {
+    checkTornJournal(false);
+}
+
+static void test_torn_journal_over_snapshot() {
+    checkTornJournal(true);
+}
+
+// compact() writes the tmp file, removes the snapshot, renames the tmp file
+// and removes the journal. Power cuts between and during those steps.
+static void test_interrupted_compaction() {
+    wipeCard();
+    Links base = writeSnapshot(true);
+    std::vector<uint8_t> oldSnapshot = readFile(NFC_LINKS_SNAPSHOT);
+    LinkJournal writer;
+    Links expected = writeScript(writer, base).back().links;
+    std::vector<uint8_t> journal = readFile(NFC_LINKS_JOURNAL);
+    
+    NfcLinkTable table;
+    TEST_ASSERT_TRUE(writer.load(table));
+    TEST_ASSERT_TRUE(writer.compact(table));
+    std::vector<uint8_t> newSnapshot = readFile(NFC_LINKS_SNAPSHOT);
+    
+    struct Case {
+        const char* name;
+        bool oldSnapshot;  // NFC_LINKS_SNAPSHOT still holds the old one
+        bool newSnapshot;  // ...or the new one, renamed into place
+        size_t tmpLength;  // Bytes of the new snapshot in the tmp file (until renamed)
+        bool journal;      // Not removed yet
+    };
+    std::vector<Case> cases;
+    for (size_t length = 0; length < newSnapshot.size(); length++) {
+        cases.push_back({ "tmp file torn", true, false, length, true });
+    }
+    cases.push_back({ "before removing the old snapshot", true, false, newSnapshot.size(), true });
+    cases.push_back({ "before the rename", false, false, newSnapshot.size(), true });
+    cases.push_back({ "before removing the journal", false, true, 0, true });
+    cases.push_back({ "done", false, true, 0, false });
+    
+    for (const Case& c : cases) {
+        char message[64];
+        snprintf(message, sizeof(message), "%s (%u bytes)", c.name, (unsigned)c.tmpLength);
+        wipeCard();
+        if (c.oldSnapshot) {
+            writeFile(NFC_LINKS_SNAPSHOT, oldSnapshot, oldSnapshot.size());
+        }
+        if (c.newSnapshot) {
+            writeFile(NFC_LINKS_SNAPSHOT, newSnapshot, newSnapshot.size());
+        } else {
+            writeFile(TMP_SNAPSHOT, newSnapshot, c.tmpLength);
+        }
+        if (c.journal) {
+            writeFile(NFC_LINKS_JOURNAL, journal, journal.size());
+        }
+        
+        NfcLinkTable loaded;
+        LinkJournal journalAfterBoot;
+        TEST_ASSERT_TRUE_MESSAGE(journalAfterBoot.load(loaded), message);
+        assertLinks(expected, loaded, message);
+        if (!c.oldSnapshot && !c.newSnapshot) {
+            // The finished tmp file was moved into place
+            TEST_ASSERT_TRUE_MESSAGE(SD.exists(NFC_LINKS_SNAPSHOT), message);
+            TEST_ASSERT_FALSE_MESSAGE(SD.exists(TMP_SNAPSHOT), message);
+        }
+        
+        // Once recovered, the next compaction starts from a clean slate
+        TEST_ASSERT_TRUE_MESSAGE(journalAfterBoot.compact(loaded), message);
+        TEST_ASSERT_FALSE_MESSAGE(SD.exists(TMP_SNAPSHOT), message);
+        NfcLinkTable reloaded;
+        TEST_ASSERT_TRUE_MESSAGE(journalAfterBoot.load(reloaded), message);
+        assertLinks(expected, reloaded, message);
+    }
+}
+
+static void test_compaction_threshold() {
+    wipeCard();
+    LinkJournal journal;
+    NfcLinkTable table;
+    char path[64];
+    uint32_t n = 0;
+    while (!journal.needsCompaction()) {
+        snprintf(path, sizeof(path), "/music/song %u.mp3", (unsigned)(n % 50));
+        TagUid uid = makeUid(n % 200);
+        TEST_ASSERT_TRUE(table.set(uid, path));
+        TEST_ASSERT_TRUE(journal.appendLink(uid, path));
+        n++;
+    }
+    TEST_ASSERT_TRUE(journal.compact(table));
+    TEST_ASSERT_FALSE(journal.needsCompaction());
+    TEST_ASSERT_FALSE(SD.exists(NFC_LINKS_JOURNAL));
+    
+    NfcLinkTable reloaded;
+    LinkJournal journalAfterBoot;
+    TEST_ASSERT_TRUE(journalAfterBoot.load(reloaded));
+    assertLinks(contents(table), reloaded, "after compaction");
+}
+
+int main() {
+    // A scratch directory stands in for the card
+    char root[] = "/tmp/test_link_journal_XXXXXX";
+    if (!mkdtemp(root)) {
+        return 1;
+    }
+    simOptions().sdRoot = root;
+    if (!SD.begin()) {
+        return 1;
+    }
+    
+    UNITY_BEGIN();
+    RUN_TEST(test_torn_journal);
+    RUN_TEST(test_torn_journal_over_snapshot);
+    RUN_TEST(test_interrupted_compaction);
+    RUN_TEST(test_compaction_threshold);
+    int failures = UNITY_END();
+    
+    wipeCard();
+    rmdir(root);
+    return failures;
+}
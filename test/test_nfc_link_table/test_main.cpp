@@ -0,0 +1,249 @@
+// Host tests for the UID -> path table behind tag lookups.
+//   pio test -e native -f test_nfc_link_table
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "nfc_link_table.h"
+
+static TagUid makeUid(uint32_t n) {
+    uint8_t bytes[4] = { 0x04, (uint8_t)(n >> 16), (uint8_t)(n >> 8), (uint8_t)n };
+    return TagUid::fromBytes(bytes, sizeof(bytes));
+}
+
+// Keys that start probing at the same slot of a table with `capacity` slots
+static void collidingUids(size_t capacity, TagUid* uids, size_t count) {
+    size_t found = 0;
+    uint32_t bucket = makeUid(0).hash() & (capacity - 1);
+    for (uint32_t n = 0; found < count; n++) {
+        TagUid uid = makeUid(n);
+        if ((uid.hash() & (capacity - 1)) == bucket) {
+            uids[found++] = uid;
+        }
+    }
+}
+
+// Average slots a lookup compares: for every link, from its home slot to the
+// slot it sits in; for a miss, from each slot to the next empty one. Only
+// valid without tombstones, where every slot next() skips is empty.
+static void probeStats(const NfcLinkTable& table, double& hit, double& miss) {
+    size_t capacity = table.capacity();
+    std::vector<bool> used(capacity, false);
+    size_t hitProbes = 0;
+    size_t cursor = 0;
+    TagUid uid;
+    const char* path;
+    while (table.next(cursor, uid, path)) {
+        size_t slot = cursor - 1;
+        used[slot] = true;
+        size_t home = uid.hash() & (capacity - 1);
+        hitProbes += ((slot - home) & (capacity - 1)) + 1;
+    }
+    
+    size_t missProbes = 0;
+    for (size_t home = 0; home < capacity; home++) {
+        size_t probes = 1;
+        for (size_t i = home; used[i]; i = (i + 1) & (capacity - 1)) {
+            probes++;
+        }
+        missProbes += probes;
+    }
+    hit = (double)hitProbes / table.size();
+    miss = (double)missProbes / capacity;
+}
+
+// Fill to just below the grow threshold, where probe chains are longest.
+// 7-byte UIDs from a fixed xorshift sequence, like real tags.
+static void fillUntilFull(NfcLinkTable& table, size_t minLinks) {
+    uint32_t state = 2463534242u;
+    while (table.size() < minLinks || (table.size() + 1) * 4 <= table.capacity() * 3) {
+        uint8_t bytes[7] = { 0x04 };
+        for (size_t i = 1; i < sizeof(bytes); i++) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            bytes[i] = (uint8_t)state;
+        }
+        TEST_ASSERT_TRUE(table.set(TagUid::fromBytes(bytes, sizeof(bytes)), "/music/a.mp3"));
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_insert_and_find() {
+    NfcLinkTable table;
+    TEST_ASSERT_NULL(table.find(makeUid(1)));
+    
+    TEST_ASSERT_TRUE(table.set(makeUid(1), "/music/a.mp3"));
+    TEST_ASSERT_TRUE(table.set(makeUid(2), "/music/b.mp3"));
+    TEST_ASSERT_EQUAL(2, table.size());
+    TEST_ASSERT_EQUAL_STRING("/music/a.mp3", table.find(makeUid(1)));
+    TEST_ASSERT_EQUAL_STRING("/music/b.mp3", table.find(makeUid(2)));
+    TEST_ASSERT_NULL(table.find(makeUid(3)));
+}
+
+static void test_relink_replaces_path() {
+    NfcLinkTable table;
+    TEST_ASSERT_TRUE(table.set(makeUid(1), "/music/a.mp3"));
+    TEST_ASSERT_TRUE(table.set(makeUid(1), "/music/b.mp3"));
+    TEST_ASSERT_EQUAL(1, table.size());
+    TEST_ASSERT_EQUAL_STRING("/music/b.mp3", table.find(makeUid(1)));
+}
+
+static void test_rejects_invalid_uid() {
+    NfcLinkTable table;
+    TagUid empty;
+    empty.clear();
+    TEST_ASSERT_FALSE(table.set(empty, "/music/a.mp3"));
+    TEST_ASSERT_EQUAL(0, table.size());
+}
+
+static void test_paths_are_shared() {
+    NfcLinkTable table;
+    TEST_ASSERT_TRUE(table.set(makeUid(1), "/music/album"));
+    TEST_ASSERT_TRUE(table.set(makeUid(2), "/music/album"));
+    TEST_ASSERT_EQUAL_PTR(table.find(makeUid(1)), table.find(makeUid(2)));
+    
+    // Still there for the other tag after one is unlinked
+    TEST_ASSERT_TRUE(table.remove(makeUid(1)));
+    TEST_ASSERT_EQUAL_STRING("/music/album", table.find(makeUid(2)));
+}
+
+static void test_erase() {
+    NfcLinkTable table;
+    TEST_ASSERT_TRUE(table.set(makeUid(1), "/music/a.mp3"));
+    TEST_ASSERT_TRUE(table.remove(makeUid(1)));
+    TEST_ASSERT_FALSE(table.remove(makeUid(1)));
+    TEST_ASSERT_EQUAL(0, table.size());
+    TEST_ASSERT_NULL(table.find(makeUid(1)));
+}
+
+static void test_tombstone_keeps_probe_chain() {
+    NfcLinkTable table;
+    TEST_ASSERT_TRUE(table.set(makeUid(1000), "/music/x.mp3"));  // Allocates the first slots
+    
+    TagUid uids[3];
+    collidingUids(16, uids, 3);
+    TEST_ASSERT_TRUE(table.set(uids[0], "/music/0.mp3"));
+    TEST_ASSERT_TRUE(table.set(uids[1], "/music/1.mp3"));
+    TEST_ASSERT_TRUE(table.set(uids[2], "/music/2.mp3"));
+    
+    // The last key is only reachable by probing past the middle one
+    TEST_ASSERT_TRUE(table.remove(uids[1]));
+    TEST_ASSERT_NULL(table.find(uids[1]));
+    TEST_ASSERT_EQUAL_STRING("/music/0.mp3", table.find(uids[0]));
+    TEST_ASSERT_EQUAL_STRING("/music/2.mp3", table.find(uids[2]));
+    
+    // Linking again reuses the tombstone without duplicating the others
+    TEST_ASSERT_TRUE(table.set(uids[1], "/music/1b.mp3"));
+    TEST_ASSERT_TRUE(table.set(uids[2], "/music/2b.mp3"));
+    TEST_ASSERT_EQUAL(4, table.size());
+    TEST_ASSERT_EQUAL_STRING("/music/1b.mp3", table.find(uids[1]));
+    TEST_ASSERT_EQUAL_STRING("/music/2b.mp3", table.find(uids[2]));
+}
+
+static void test_rehash_keeps_links() {
+    NfcLinkTable table;
+    char path[32];
+    const uint32_t count = 1000;  // Grows from 16 slots several times
+    for (uint32_t n = 0; n < count; n++) {
+        snprintf(path, sizeof(path), "/music/%u.mp3", (unsigned)n);
+        TEST_ASSERT_TRUE(table.set(makeUid(n), path));
+    }
+    TEST_ASSERT_EQUAL(count, table.size());
+    
+    for (uint32_t n = 0; n < count; n++) {
+        snprintf(path, sizeof(path), "/music/%u.mp3", (unsigned)n);
+        TEST_ASSERT_EQUAL_STRING(path, table.find(makeUid(n)));
+    }
+}
+
+static void test_churn_clears_tombstones() {
+    // Constant size, so only tombstones can fill the table: inserts have to
+    // rehash them away, and lookups still have to end at an empty slot
+    NfcLinkTable table;
+    for (uint32_t n = 0; n < 8; n++) {
+        TEST_ASSERT_TRUE(table.set(makeUid(n), "/music/keep.mp3"));
+    }
+    for (uint32_t n = 100; n < 2100; n++) {
+        TEST_ASSERT_TRUE(table.set(makeUid(n), "/music/churn.mp3"));
+        TEST_ASSERT_TRUE(table.remove(makeUid(n)));
+        TEST_ASSERT_NULL(table.find(makeUid(n + 1)));
+    }
+    
+    TEST_ASSERT_EQUAL(8, table.size());
+    for (uint32_t n = 0; n < 8; n++) {
+        TEST_ASSERT_EQUAL_STRING("/music/keep.mp3", table.find(makeUid(n)));
+    }
+}
+
+static void test_next_visits_every_link() {
+    NfcLinkTable table;
+    const uint32_t count = 50;
+    for (uint32_t n = 0; n < count; n++) {
+        TEST_ASSERT_TRUE(table.set(makeUid(n), "/music/a.mp3"));
+    }
+    TEST_ASSERT_TRUE(table.remove(makeUid(7)));
+    
+    bool seen[count] = {};
+    size_t visited = 0;
+    size_t cursor = 0;
+    TagUid uid;
+    const char* path;
+    while (table.next(cursor, uid, path)) {
+        uint32_t n = uid.bytes[3];
+        TEST_ASSERT_TRUE(n < count);
+        TEST_ASSERT_FALSE(seen[n]);
+        seen[n] = true;
+        visited++;
+    }
+    TEST_ASSERT_EQUAL(count - 1, visited);
+    TEST_ASSERT_FALSE(seen[7]);
+}
+
+static void test_clear() {
+    NfcLinkTable table;
+    TEST_ASSERT_TRUE(table.set(makeUid(1), "/music/a.mp3"));
+    table.clear();
+    TEST_ASSERT_EQUAL(0, table.size());
+    TEST_ASSERT_NULL(table.find(makeUid(1)));
+    TEST_ASSERT_TRUE(table.set(makeUid(1), "/music/b.mp3"));
+    TEST_ASSERT_EQUAL_STRING("/music/b.mp3", table.find(makeUid(1)));
+}
+
+// Lookups cost the same at 10 links and at thousands: a bounded average
+// number of slot compares, even with the table as full as it gets. Linear
+// probing at 3/4 load averages 2.5 compares for a hit and 8.5 for a miss.
+static void test_lookup_cost_does_not_grow() {
+    const size_t sizes[] = { 10, 100, 1000, 5000 };
+    for (size_t minLinks : sizes) {
+        NfcLinkTable table;
+        fillUntilFull(table, minLinks);
+        double hit, miss;
+        probeStats(table, hit, miss);
+        
+        char message[64];
+        snprintf(message, sizeof(message), "%u links, %u slots: %.2f / %.2f probes",
+                 (unsigned)table.size(), (unsigned)table.capacity(), hit, miss);
+        TEST_MESSAGE(message);
+        TEST_ASSERT_TRUE_MESSAGE(hit <= 4.0, message);
+        TEST_ASSERT_TRUE_MESSAGE(miss <= 16.0, message);
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_insert_and_find);
+    RUN_TEST(test_relink_replaces_path);
+    RUN_TEST(test_rejects_invalid_uid);
+    RUN_TEST(test_paths_are_shared);
+    RUN_TEST(test_erase);
+    RUN_TEST(test_tombstone_keeps_probe_chain);
+    RUN_TEST(test_rehash_keeps_links);
+    RUN_TEST(test_churn_clears_tombstones);
+    RUN_TEST(test_next_visits_every_link);
+    RUN_TEST(test_clear);
+    RUN_TEST(test_lookup_cost_does_not_grow);
+    return UNITY_END();
+}
@@ -0,0 +1,124 @@
+// Host test for the web server's route table: requests go over a socket to
+// the firmware's own routes on the simulated async_tcp server.
+//   pio test -e native -f test_web_routes
+#include <unity.h>
+#include <Arduino.h>
+#include <SD.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <filesystem>
+#include <string>
+#include "sim.h"
+#include "storage.h"
+#include "web_server.h"
+
+static const char* SONG = "/music/song.mp3";
+static std::string songData;
+
+struct Response {
+    int code;
+    std::string head;
+    std::string body;
+};
+
+// One request on its own connection; the server closes it when done
+static Response httpGet(const char* path, const char* extraHeaders = "") {
+    Response response = { 0, "", "" };
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(simOptions().httpPort);
+    TEST_ASSERT_EQUAL(0, connect(fd, (sockaddr*)&addr, sizeof(addr)));
+    
+    std::string request = std::string("GET ") + path + " HTTP/1.1\r\nHost: localhost\r\n" +
+                          extraHeaders + "Connection: close\r\n\r\n";
+    TEST_ASSERT_EQUAL(request.size(), send(fd, request.data(), request.size(), 0));
+    
+    std::string raw;
+    char buffer[1024];
+    ssize_t n;
+    while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        raw.append(buffer, n);
+    }
+    close(fd);
+    
+    size_t end = raw.find("\r\n\r\n");
+    TEST_ASSERT_TRUE(end != std::string::npos);
+    response.head = raw.substr(0, end);
+    response.body = raw.substr(end + 4);
+    response.code = atoi(response.head.c_str() + strlen("HTTP/1.1 "));
+    return response;
+}
+
+static bool hasHeader(const Response& response, const char* header) {
+    return response.head.find(header) != std::string::npos;
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_song_list() {
+    Response response = httpGet("/api/songs");
+    TEST_ASSERT_EQUAL(200, response.code);
+    TEST_ASSERT_TRUE(hasHeader(response, "Content-Type: application/json"));
+    TEST_ASSERT_TRUE(response.body.find("song.mp3") != std::string::npos);
+}
+
+// /api/songs also matches its sub-paths, so the stream route has to win
+static void test_stream_reaches_stream_handler() {
+    Response response = httpGet("/api/songs/song.mp3/stream");
+    TEST_ASSERT_EQUAL(200, response.code);
+    TEST_ASSERT_TRUE(hasHeader(response, "Content-Type: audio/mpeg"));
+    TEST_ASSERT_TRUE(response.body == songData);
+}
+
+static void test_stream_range() {
+    Response response = httpGet("/api/songs/song.mp3/stream", "Range: bytes=100-199\r\n");
+    TEST_ASSERT_EQUAL(206, response.code);
+    TEST_ASSERT_TRUE(hasHeader(response, "Content-Range: bytes 100-199/"));
+    TEST_ASSERT_TRUE(response.body == songData.substr(100, 100));
+}
+
+static void test_stream_unknown_song() {
+    Response response = httpGet("/api/songs/missing.mp3/stream");
+    TEST_ASSERT_EQUAL(404, response.code);
+    TEST_ASSERT_TRUE(response.body.find("Song not found") != std::string::npos);
+}
+
+int main() {
+    // A scratch directory stands in for the card, with one song on it
+    char root[] = "/tmp/test_web_routes_XXXXXX";
+    if (!mkdtemp(root)) {
+        return 1;
+    }
+    simOptions().sdRoot = root;
+    simOptions().httpPort = 20000 + getpid() % 10000;
+    
+    for (int i = 0; i < 5000; i++) {
+        songData += (char)(i * 7);
+    }
+    SD.begin();
+    SD.mkdir(MUSIC_DIR);
+    File file = SD.open(SONG, FILE_WRITE);
+    file.write((const uint8_t*)songData.data(), songData.size());
+    file.close();
+    
+    if (!storage.begin() || !webServer.begin()) {
+        return 1;
+    }
+    
+    UNITY_BEGIN();
+    RUN_TEST(test_song_list);
+    RUN_TEST(test_stream_reaches_stream_handler);
+    RUN_TEST(test_stream_range);
+    RUN_TEST(test_stream_unknown_song);
+    int failures = UNITY_END();
+    
+    std::filesystem::remove_all(root);
+    // Task threads are still running: leave without static destructors
+    simExit(failures);
+}
@@ -0,0 +1,70 @@
+"""Embed web/index.html into the firmware as a gzip'd PROGMEM array.
+
+Runs as a PlatformIO pre-build script (see extra_scripts in platformio.ini)
+and can also be run by hand:
+
+    python3 tools/embed_web_ui.py
+
+Writes include/web_ui.h with the compressed page, its length and a strong
+ETag derived from the content. The header is only rewritten when the page
+changes, so it doesn't trigger needless rebuilds.
+"""
+
+import gzip
+import os
+import zlib
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO
+    PROJECT_DIR = env.subst("$PROJECT_DIR")  # noqa: F821
+except NameError:
+    PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+SOURCE = os.path.join(PROJECT_DIR, "web", "index.html")
+HEADER = os.path.join(PROJECT_DIR, "include", "web_ui.h")
+
+
+def build_header(html):
+    # mtime=0 keeps the output (and the ETag) identical across builds
+    compressed = gzip.compress(html, compresslevel=9, mtime=0)
+    etag = "%08x" % (zlib.crc32(html) & 0xFFFFFFFF)
+
+    lines = [
+        "// Generated by tools/embed_web_ui.py from web/index.html - do not edit",
+        "#ifndef WEB_UI_H",
+        "#define WEB_UI_H",
+        "",
+        "#include <Arduino.h>",
+        "",
+        '#define WEB_UI_ETAG "\\"%s\\""' % etag,
+        "#define WEB_UI_GZ_LENGTH %d  // %d bytes uncompressed" % (len(compressed), len(html)),
+        "",
+        "const uint8_t WEB_UI_GZ[] PROGMEM = {",
+    ]
+    for i in range(0, len(compressed), 16):
+        chunk = compressed[i:i + 16]
+        lines.append("    " + ", ".join("0x%02x" % b for b in chunk) + ",")
+    lines += [
+        "};",
+        "",
+        "#endif // WEB_UI_H",
+        "",
+    ]
+    return "\n".join(lines)
+
+
+def main():
+    with open(SOURCE, "rb") as f:
+        header = build_header(f.read())
+
+    if os.path.exists(HEADER):
+        with open(HEADER, "r") as f:
+            if f.read() == header:
+                return
+
+    with open(HEADER, "w") as f:
+        f.write(header)
+    print("Embedded web/index.html into include/web_ui.h")
+
+
+main()
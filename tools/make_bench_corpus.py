@@ -0,0 +1,65 @@
+"""Build the MP3 corpus for the decoder benchmark (decode_bench env).
+
+Needs ffmpeg with libmp3lame on the PATH:
+
+    python3 tools/make_bench_corpus.py sdcard/bench
+
+Copy the files to /bench on the SD card (the native build reads them from
+<sd dir>/bench directly). The audio is pink noise, which no encoder can make
+cheap, so the decoder sees close to its worst case at each bitrate. The art_
+file carries a ~1 MB incompressible cover in its ID3 tag.
+"""
+
+import os
+import subprocess
+import sys
+import tempfile
+
+SECONDS = 40
+
+# name, channels, encoder options
+FILES = [
+    ("cbr64_mono.mp3", 1, ["-b:a", "64k"]),
+    ("cbr128_mono.mp3", 1, ["-b:a", "128k"]),
+    ("cbr128_stereo.mp3", 2, ["-b:a", "128k"]),
+    ("cbr192_stereo.mp3", 2, ["-b:a", "192k"]),
+    ("cbr320_stereo.mp3", 2, ["-b:a", "320k"]),
+    ("vbr_v5_stereo.mp3", 2, ["-q:a", "5"]),  # ~130 kbps
+    ("vbr_v0_stereo.mp3", 2, ["-q:a", "0"]),  # ~245 kbps
+]
+ART_FILE = ("art_cbr192_stereo.mp3", 2, ["-b:a", "192k"])
+
+
+def ffmpeg(*args):
+    subprocess.run(["ffmpeg", "-hide_banner", "-loglevel", "error", "-y", *args], check=True)
+
+
+def noise(channels):
+    return ["-f", "lavfi", "-i", "anoisesrc=color=pink:amplitude=0.3:duration=%d" % SECONDS,
+            "-ar", "44100", "-ac", str(channels)]
+
+
+def main():
+    out = sys.argv[1] if len(sys.argv) > 1 else "bench"
+    os.makedirs(out, exist_ok=True)
+
+    for name, channels, options in FILES:
+        ffmpeg(*noise(channels), "-c:a", "libmp3lame", *options, os.path.join(out, name))
+        print(name)
+
+    # Random pixels don't compress: 600x600 RGB is about 1 MB of PNG
+    with tempfile.TemporaryDirectory() as tmp:
+        cover = os.path.join(tmp, "cover.png")
+        ffmpeg("-f", "lavfi", "-i", "nullsrc=s=600x600,geq=r='random(1)*255':g='random(2)*255':b='random(3)*255'",
+               "-frames:v", "1", cover)
+
+        name, channels, options = ART_FILE
+        ffmpeg(*noise(channels), "-i", cover, "-map", "0:a", "-map", "1:v",
+               "-c:a", "libmp3lame", *options, "-c:v", "copy", "-id3v2_version", "3",
+               "-metadata:s:v", "title=Album cover", "-metadata:s:v", "comment=Cover (front)",
+               os.path.join(out, name))
+        print(name)
+
+
+if __name__ == "__main__":
+    main()